@@ -0,0 +1,46 @@
+#ifndef PROJETLP_ACTION_QUEUE_H
+#define PROJETLP_ACTION_QUEUE_H
+
+#include <pthread.h>
+#include "network.h"
+
+// File d'actions asynchrones sur les processus (kill, pause, reprise,
+// redémarrage). L'interface dépose une action et continue ; des threads
+// regroupent toutes les actions en attente d'un même hôte en une seule
+// commande distante, puis publient un résultat par action.
+
+#define ACTION_QUEUE_WORKERS 4
+
+typedef struct {
+    int host;                    // Index de l'hôte dans le network_manager_t
+    int pid;
+    process_action_t action;
+    int result;                  // 0 succès, -1 échec (renseigné à la fin)
+} action_request_t;
+
+typedef struct {
+    network_manager_t *network;
+    action_request_t *pending;   // Actions en attente, dans l'ordre de dépôt
+    int pending_count;
+    int pending_capacity;
+    action_request_t *done;      // Actions terminées, pas encore lues par l'interface
+    int done_count;
+    int done_capacity;
+    int *host_busy;              // Un lot en cours par hôte au plus
+    pthread_t workers[ACTION_QUEUE_WORKERS];
+    int worker_count;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int running;
+} action_queue_t;
+
+int action_queue_start(action_queue_t *queue, network_manager_t *network);
+void action_queue_stop(action_queue_t *queue);
+
+// Dépose une action (ne bloque jamais sur le réseau)
+int action_queue_submit(action_queue_t *queue, int host, int pid, process_action_t action);
+
+// Retire le plus ancien résultat disponible (1 si un résultat a été copié, 0 sinon)
+int action_queue_poll_result(action_queue_t *queue, action_request_t *result);
+
+#endif // PROJETLP_ACTION_QUEUE_H
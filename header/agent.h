@@ -0,0 +1,65 @@
+#ifndef PROJETLP_AGENT_H
+#define PROJETLP_AGENT_H
+
+#include <stddef.h>
+#include "process.h"
+
+// Agent de collecte distant : tourne sur l'hôte surveillé (sans ncurses),
+// réutilise get_process_list() et envoie des instantanés binaires sur stdout.
+// Après une trame complète (keyframe), seules les différences avec le
+// dernier instantané acquitté par le visualiseur sont envoyées (delta).
+
+#define AGENT_REMOTE_COMMAND "GestionRessources-agent"
+#define AGENT_DEFAULT_INTERVAL_MS 1000
+#define AGENT_KEYFRAME_INTERVAL 60  // Une trame complète toutes les N trames, pour resynchroniser
+#define AGENT_HISTORY_SIZE 8        // Instantanés gardés de chaque côté pour résoudre les deltas
+
+// En-tête de trame (petit-boutiste) :
+//   magic (4) | version (1) | type (1) | options (1) | réservé (1) | séquence (4) | taille charge utile (4)
+#define AGENT_MAGIC "GRAS"
+#define AGENT_PROTOCOL_VERSION 2
+#define AGENT_HEADER_SIZE 16
+#define AGENT_MAX_PAYLOAD (64 * 1024 * 1024)
+
+typedef enum {
+    AGENT_FRAME_KEYFRAME = 1,  // Instantané complet
+    AGENT_FRAME_DELTA = 2      // Lignes supprimées, ajoutées et modifiées depuis un instantané de base
+} agent_frame_type_t;
+
+#define AGENT_FLAG_ZLIB 0x01   // Charge utile compressée avec zlib
+
+// Messages du visualiseur vers l'agent (stdin), 5 octets : type | séquence (4)
+#define AGENT_MESSAGE_SIZE 5
+#define AGENT_MESSAGE_ACK 'A'       // Instantané appliqué : base possible des prochains deltas
+#define AGENT_MESSAGE_KEYFRAME 'K'  // Base inconnue : envoyer une trame complète
+
+// Instantané numéroté, processus triés par PID croissant
+typedef struct {
+    unsigned int sequence;
+    unsigned int uptime_ds;    // Uptime de l'hôte (dixièmes de s) : le temps écoulé est transmis en date de démarrage
+    process_info_t *list;
+    int count;
+} agent_snapshot_t;
+
+// Trie un instantané par PID (prérequis de l'encodage)
+void agent_snapshot_sort(agent_snapshot_t *snapshot);
+void agent_snapshot_free(agent_snapshot_t *snapshot);
+
+// Encodage d'un instantané : keyframe si base == NULL, delta sinon (buffer alloué, à libérer)
+int agent_encode_frame(const agent_snapshot_t *current, const agent_snapshot_t *base, int compress,
+                       unsigned char **frame, size_t *frame_len);
+
+// Taille totale de la trame en tête du buffer : 0 si incomplète, -1 si invalide
+long agent_frame_length(const unsigned char *buffer, size_t len);
+
+// Numéro de l'instantané de base d'une trame delta (0 pour une keyframe, -1 si invalide)
+long agent_frame_base(const unsigned char *frame, size_t frame_len);
+
+// Décodage d'une trame complète ; base doit être l'instantané désigné par agent_frame_base()
+int agent_decode_frame(const unsigned char *frame, size_t frame_len, const agent_snapshot_t *base,
+                       agent_snapshot_t *snapshot);
+
+// Boucle principale de l'agent (jusqu'à la fermeture de stdin ou de stdout)
+int agent_run(int interval_ms, int compress);
+
+#endif // PROJETLP_AGENT_H
@@ -0,0 +1,15 @@
+#ifndef PROJETLP_AGENT_CLIENT_H
+#define PROJETLP_AGENT_CLIENT_H
+
+#include "network.h"
+
+// Côté visualiseur : lecture des instantanés envoyés par l'agent distant
+// sur un flux SSH gardé ouvert (un flux par hôte).
+
+#define AGENT_FIRST_FRAME_TIMEOUT_MS 5000
+
+int agent_client_fetch(const host_config_t *host, process_info_t **list, int *count);
+void agent_client_close(const host_config_t *host);
+void agent_client_cleanup(void);
+
+#endif // PROJETLP_AGENT_CLIENT_H
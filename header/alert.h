@@ -0,0 +1,116 @@
+#ifndef PROJETLP_ALERT_H
+#define PROJETLP_ALERT_H
+
+#include <pthread.h>
+#include "network.h"
+
+// Règles d'alerte évaluées à chaque nouvel instantané d'un hôte, sans que
+// personne ne regarde l'écran. Fichier de règles (.alerts par défaut), une
+// règle par ligne, '#' pour les commentaires :
+//
+//   cpu > 90 for 30s clear 80       CPU% d'un processus, hystérésis de 10 points
+//   mem > 8G name java host web1    Mémoire résidente (K, M ou G, Ko sans suffixe)
+//   missing nginx host web1 for 10s Aucun processus de ce nom sur l'hôte
+//   log alerts.log                  Journal des alertes (alerts.log par défaut)
+//   hook /usr/local/bin/notify      Commande lancée à chaque alerte et fin d'alerte
+//
+// Une condition doit tenir pendant "for" avant de déclencher l'alerte, qui
+// ne prend fin qu'une fois la valeur repassée sous "clear" (le seuil par
+// défaut) : une valeur qui oscille autour du seuil ne produit pas de
+// rafale d'alertes. La commande du hook reçoit ALERT_STATE (FIRING ou
+// RESOLVED), ALERT_HOST, ALERT_RULE, ALERT_PID, ALERT_PROCESS et
+// ALERT_VALUE dans son environnement.
+//
+// Évaluation incrémentale : les règles sont compilées par hôte et triées
+// par seuil de fin, si bien qu'un processus sous tous les seuils ne coûte
+// que deux comparaisons (plus un hachage de son nom tant qu'un processus
+// attendu par une règle missing n'a pas été vu) ; l'état par règle et par
+// PID vit dans une table de hachage qui ne contient que les conditions en
+// cours, dont les emplacements occupés sont listés à part pour que le
+// balayage de fin d'évaluation ne parcoure pas toute la table.
+
+#define ALERTS_DEFAULT_FILE ".alerts"
+#define ALERTS_DEFAULT_LOG "alerts.log"
+
+typedef enum {
+    ALERT_METRIC_CPU,       // cpu_percent d'un processus
+    ALERT_METRIC_MEM,       // memory_kb d'un processus
+    ALERT_METRIC_MISSING    // Aucun processus du nom donné sur l'hôte
+} alert_metric_t;
+
+typedef struct {
+    alert_metric_t metric;
+    double threshold;       // Condition vraie au-dessus
+    double clear;           // Fin de l'alerte à cette valeur ou en dessous
+    int duration_ms;        // Durée minimale de la condition avant l'alerte
+    char name[64];          // Nom du processus visé ("" : tous)
+    char host[64];          // Nom de l'hôte visé ("" : tous)
+    char text[128];         // Règle telle qu'écrite, pour les messages
+} alert_rule_t;
+
+// État d'une condition en cours (règle, PID)
+typedef struct {
+    int rule;               // -1 : emplacement libre, -2 : supprimé
+    int pid;
+    long long since_ms;     // Début de la condition
+    int firing;
+    unsigned int seen;      // Dernière évaluation où la condition tenait encore
+    float value;
+    char process[32];
+} alert_slot_t;
+
+// Règles d'un hôte et état de ses conditions
+typedef struct {
+    int *cpu_rules;          // Règles cpu sans nom, triées par seuil de fin croissant
+    int cpu_count;
+    int *mem_rules;          // Règles mem sans nom, idem
+    int mem_count;
+    int *named_rules;        // Règles avec un nom de processus, triées par nom
+    int named_count;
+    int *name_table;         // Noms distincts -> première règle du nom dans named_rules (-1 : vide)
+    int name_capacity;       // Puissance de 2
+    int *missing_rules;      // Règles missing de l'hôte
+    int missing_count;
+    double cpu_floor;        // Plus petit seuil de fin des règles cpu (nommées ou non)
+    double mem_floor;        // Idem pour les règles mem
+    alert_slot_t *missing_state;  // Indexé par règle
+    alert_slot_t *slots;     // Table de hachage (règle, PID), adressage ouvert
+    int slot_capacity;       // Puissance de 2
+    int slot_used;           // Emplacements occupés ou supprimés
+    int *live_slots;         // Indices des emplacements occupés (capacité slot_capacity)
+    int live_count;
+    unsigned int evaluation; // Numéro de l'évaluation courante
+    pthread_mutex_t lock;    // Deux collectes d'un même hôte peuvent se chevaucher
+} alert_host_t;
+
+typedef struct {
+    alert_rule_t *rules;
+    int rule_count;
+    int rule_capacity;
+    const host_config_t *host_configs;
+    alert_host_t *hosts;
+    int host_count;
+    char log_file[256];
+    char hook[256];
+    pthread_mutex_t lock;    // Sorties (journal, hook, message) et compteurs
+    int active;              // Alertes en cours, tous hôtes confondus
+    char message[256];       // Dernier événement, pour la ligne d'état
+    unsigned long message_id;
+} alert_engine_t;
+
+int alert_engine_init(alert_engine_t *engine, const host_config_t *hosts, int host_count);
+int alert_engine_add_rule(alert_engine_t *engine, const char *line);
+int alert_engine_compile(alert_engine_t *engine);
+void alert_engine_free(alert_engine_t *engine);
+
+// Charge un fichier de règles (nombre de règles, -1 si le fichier est illisible ou invalide)
+int alert_engine_load(alert_engine_t *engine, const char *filename, const network_manager_t *network);
+
+// Évalue les règles d'un hôte sur un nouvel instantané
+void alert_evaluate(alert_engine_t *engine, int host, const process_info_t *list, int count, long long now_ms);
+
+// Dernier événement s'il est plus récent que *seen (1 si un message a été copié)
+int alert_poll_message(alert_engine_t *engine, unsigned long *seen, char *buffer, size_t size);
+int alert_active_count(alert_engine_t *engine);
+
+#endif // PROJETLP_ALERT_H
@@ -0,0 +1,48 @@
+#ifndef PROJETLP_ARENA_H
+#define PROJETLP_ARENA_H
+
+#include <stddef.h>
+
+// Région d'allocation par instantané : toutes les listes d'une collecte
+// (processus, index triés) sont prises par simple incrément dans un bloc,
+// puis libérées d'un coup par arena_reset() quand plus personne ne lit
+// l'instantané. Le bloc est gardé d'une collecte à l'autre et dimensionné
+// sur la précédente : en régime établi, une collecte ne fait plus aucun
+// malloc ni realloc.
+
+#define ARENA_MIN_BLOCK (64 * 1024)  // Taille minimale d'un bloc
+
+typedef struct arena_block {
+    struct arena_block *next;  // Bloc rempli précédemment
+    size_t size;               // Octets utilisables après l'en-tête
+    size_t used;
+} arena_block_t;
+
+typedef struct {
+    arena_block_t *head;       // Bloc courant (NULL avant la première allocation)
+    size_t used;               // Octets alloués depuis le dernier reset, tous blocs confondus
+    size_t reserve;            // Taille du bloc unique à prévoir (collecte précédente)
+    void *last;                // Dernière allocation, extensible sur place
+    size_t last_size;
+    int count_hint;            // Nombre de processus de l'instantané précédent (0 si inconnu)
+} arena_t;
+
+void arena_init(arena_t *arena);
+void *arena_alloc(arena_t *arena, size_t size);
+void *arena_realloc(arena_t *arena, void *ptr, size_t old_size, size_t new_size);
+void arena_reset(arena_t *arena);
+void arena_destroy(arena_t *arena);
+
+// Arène courante du thread : les listes d'instantané allouées par les
+// collecteurs viennent de cette arène, ou de malloc si aucune n'est liée.
+// Une liste doit être libérée sous la même liaison que son allocation.
+void arena_bind(arena_t *arena);
+void *snapshot_alloc(size_t size);
+void *snapshot_realloc(void *ptr, size_t old_size, size_t new_size);
+void snapshot_free(void *ptr);
+
+// Capacité initiale d'une liste de processus : taille de l'instantané
+// précédent (avec une marge) si l'arène courante la connaît, fallback sinon
+int snapshot_capacity_hint(int fallback);
+
+#endif // PROJETLP_ARENA_H
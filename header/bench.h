@@ -0,0 +1,30 @@
+#ifndef PROJETLP_BENCH_H
+#define PROJETLP_BENCH_H
+
+// Mesure hors ligne du chemin de collecte distant : 1, 10 puis 100 hôtes
+// simulés (mock_transport.h) sont collectés par le poller, par tours où
+// tous les hôtes sont rafraîchis en même temps. Affiche la latence de
+// rafraîchissement de bout en bout (demande -> instantané disponible) et
+// le débit en instantanés par seconde. Mesure ensuite le coût d'une
+// évaluation des règles d'alerte sur un gros instantané.
+//
+// --bench-parsers vérifie les analyseurs de proc_parse.h sur un corpus
+// intégré (noms avec espaces et parenthèses, champs négatifs, entrées
+// tronquées...), mesure leur débit, puis les soumet à une boucle de
+// fuzzing par mutations du corpus. Avec un répertoire, le corpus y est
+// aussi écrit comme graines de la cible libFuzzer (make fuzz).
+
+#define BENCH_ROUNDS 20
+#define BENCH_DEFAULT_SPEC "latency=20,jitter=5,procs=200"
+#define BENCH_ALERT_RULES 200
+#define BENCH_ALERT_PROCESSES 20000
+#define BENCH_PARSER_ITERATIONS 200000   // Appels mesurés par analyseur
+#define BENCH_FUZZ_ITERATIONS 500000     // Entrées mutées
+#define BENCH_FUZZ_SEED 0x9e3779b9u
+
+// spec : paramètres des hôtes simulés (NULL = BENCH_DEFAULT_SPEC)
+int bench_run(const char *spec);
+// corpus_dir : répertoire où écrire les graines de fuzzing (NULL : aucun)
+int bench_parsers(const char *corpus_dir);
+
+#endif // PROJETLP_BENCH_H
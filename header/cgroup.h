@@ -0,0 +1,45 @@
+#ifndef PROJETLP_CGROUP_H
+#define PROJETLP_CGROUP_H
+
+#include "process.h"
+
+// Vue par cgroup v2 (services systemd, conteneurs, pods) : les totaux sont
+// lus directement dans /sys/fs/cgroup (cpu.stat, memory.current,
+// memory.stat, io.stat), donc comptés par le noyau, y compris la mémoire
+// qu'aucun processus ne porte (cache de pages, noyau, sockets). Les débits
+// sont calculés entre deux lectures. Chaque processus est rattaché à son
+// cgroup une seule fois via /proc/[pid]/cgroup, puis depuis un cache.
+
+#ifndef CGROUP_ROOT
+#define CGROUP_ROOT "/sys/fs/cgroup"  // Hiérarchie unifiée, ou CGROUP_ROOT/unified en mode hybride
+#endif
+#define CGROUP_MAX_DEPTH 8  // Profondeur maximale parcourue sous la racine
+
+typedef struct {
+    char path[256];             // Chemin sous la racine ("/" pour la racine, "/system.slice/ssh.service"...)
+    int depth;                  // 0 pour la racine
+    float cpu_percent;          // usage_usec sur l'intervalle, en % d'un cœur
+    float throttled_percent;    // Part de l'intervalle passée bridée par cpu.max
+    unsigned long nr_throttled; // Périodes bridées sur l'intervalle
+    long memory_kb;             // memory.current (0 pour la racine)
+    long anon_kb;               // memory.stat : mémoire anonyme
+    long file_kb;               // memory.stat : cache de pages
+    float io_read_kbps;         // io.stat, tous périphériques confondus
+    float io_write_kbps;
+    int process_count;          // Processus du cgroup et de ses sous-groupes
+} cgroup_info_t;
+
+// Lecture de tous les cgroups (ordre du parcours : un parent avant ses enfants)
+int get_cgroup_list(cgroup_info_t **list, int *count);
+
+// Rattache les processus à leur cgroup (cache mis à jour) et compte les
+// processus de chaque cgroup
+void cgroup_count_processes(cgroup_info_t *list, int count, const process_info_t *procs, int proc_count);
+
+// Processus d'un cgroup et de ses sous-groupes (liste allouée, à libérer)
+int cgroup_filter_processes(const char *path, const process_info_t *procs, int proc_count,
+                            process_info_t **list, int *count);
+
+void cgroup_cleanup(void);
+
+#endif // PROJETLP_CGROUP_H
@@ -0,0 +1,52 @@
+#ifndef PROJETLP_COLLECTOR_H
+#define PROJETLP_COLLECTOR_H
+
+#include "process.h"
+#include "network.h"
+
+// Sources de listes de processus derrière une même interface : le poller
+// (et tout autre consommateur) ouvre un collecteur par hôte et l'échantillonne
+// sans savoir s'il lit /proc en local, un hôte distant ou un enregistrement.
+//
+// Backends fournis :
+//   procfs       /proc local (localhost)
+//   remote       ps sur un hôte distant (ssh, telnet ou simulé)
+//   remote-proc  script /proc sur un hôte distant, CPU% instantané (mode "proc")
+//   agent        instantanés de l'agent distant sur un flux SSH (mode "agent")
+//   replay       rejeu en boucle d'un enregistrement de l'agent (type "replay"),
+//                produit par exemple par : sleep 60 | GestionRessources-agent > capture.gra
+//   shm          instantanés publiés en mémoire partagée par GestionRessources --publish
+//                (localhost en mode --attach, nom du segment dans le champ adresse)
+
+// Capacités d'un backend
+#define COLLECTOR_CAP_INSTANT_CPU 0x01  // CPU% instantané (sinon moyenne sur la vie du processus)
+#define COLLECTOR_CAP_REMOTE      0x02  // Passe par le réseau : l'échéance de l'hôte s'applique
+#define COLLECTOR_CAP_ACTIONS     0x04  // kill, pause, reprise et redémarrage possibles
+#define COLLECTOR_CAP_PUSH        0x08  // Données poussées par la source, sample ne fait que lire la dernière
+#define COLLECTOR_CAP_FILTERED    0x10  // La source applique déjà le filtre de process_set_filter() en collectant
+
+typedef struct collector_backend {
+    const char *name;
+    unsigned int capabilities;
+    // Prépare l'état propre au backend dans *context (NULL si le backend
+    // n'a pas d'état : le contexte est alors l'hôte lui-même)
+    int (*init)(const host_config_t *host, void **context);
+    process_fetcher_t sample;
+    void (*shutdown)(void *context);
+} collector_backend_t;
+
+typedef struct {
+    const collector_backend_t *backend;  // NULL si la source n'a pas pu être ouverte
+    void *context;
+} collector_t;
+
+// Backend correspondant à un hôte (type de connexion et mode de collecte)
+const collector_backend_t *collector_backend_for(const host_config_t *host);
+
+int collector_open(collector_t *collector, const host_config_t *host);
+// Liste de la source, filtrée par process_set_filter() (sans le
+// propriétaire, que les sources distantes ne transmettent pas)
+int collector_sample(collector_t *collector, process_info_t **list, int *count);
+void collector_close(collector_t *collector);
+
+#endif // PROJETLP_COLLECTOR_H
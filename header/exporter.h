@@ -0,0 +1,46 @@
+#ifndef PROJETLP_EXPORTER_H
+#define PROJETLP_EXPORTER_H
+
+#include <pthread.h>
+#include "network.h"
+#include "poller.h"
+#include "alert.h"
+
+// Export des métriques au format texte Prometheus (--exporter ADRESSE),
+// servies depuis les derniers instantanés du poller : une collecte par
+// Prometheus ne relit jamais /proc et ne contacte aucun hôte. L'instantané
+// d'un hôte est tenu (référence) le temps d'écrire ses séries, sans verrou :
+// un client lent ne retarde pas les collectes.
+//
+// Adresse : "unix:/chemin/socket", "PORT" (127.0.0.1) ou "ADRESSE:PORT".
+// Requête : GET /metrics, avec en option
+//   top=N        Processus par hôte (EXPORTER_DEFAULT_TOP, EXPORTER_MAX_TOP au plus)
+//   sort=cpu|mem Ordre des processus retenus (cpu par défaut)
+//   host=NOM     Un seul hôte
+//   name=TEXTE   Processus dont le nom contient TEXTE
+// Le nombre total de séries par processus est borné par EXPORTER_MAX_SERIES
+// (gestion_exporter_truncated vaut 1 quand la borne est atteinte).
+
+#define EXPORTER_DEFAULT_TOP 20
+#define EXPORTER_MAX_TOP 500
+#define EXPORTER_MAX_SERIES 5000   // Processus exportés par collecte, tous hôtes confondus
+#define EXPORTER_NAME_MAX 32       // Longueur maximale du label name
+#define EXPORTER_TIMEOUT_MS 2000   // Lecture de la requête et écriture de la réponse
+
+typedef struct {
+    poller_t *poller;
+    network_manager_t *network;
+    alert_engine_t *alerts;        // NULL si aucune règle d'alerte
+    int listen_fd;
+    int wake_pipe[2];              // Réveil du thread à l'arrêt
+    char unix_path[108];           // Socket Unix à supprimer à l'arrêt ("" en TCP)
+    pthread_t thread;
+    unsigned long scrapes;         // Collectes servies (lu et écrit par le thread seul)
+} exporter_t;
+
+// Ouvre l'adresse et lance le thread de service (0 en cas de succès, -1 sinon)
+int exporter_start(exporter_t *exporter, const char *address, poller_t *poller,
+                   network_manager_t *network, alert_engine_t *alerts);
+void exporter_stop(exporter_t *exporter);
+
+#endif // PROJETLP_EXPORTER_H
@@ -0,0 +1,92 @@
+#ifndef PROJETLP_FILTER_H
+#define PROJETLP_FILTER_H
+
+#include "process.h"
+
+// Expressions de filtre sur les champs des processus (--filter), compilées
+// une fois en un petit programme postfixé, évalué pour chaque processus :
+//
+//   user=www and cpu>1
+//   not kernel and (name~nginx or mem>=512M)
+//   pid>=1000 and pid<2000, state=RD
+//
+// Champs : pid, ppid, uid, user (nom résolu en uid à la compilation), name,
+// state (une lettre, ou plusieurs pour « l'une d'elles »), kernel (0 ou 1,
+// « kernel » seul vaut kernel=1), cpu (%), mem (Ko, suffixes K, M, G) et
+// time (secondes, suffixes s, m, h, d). Opérateurs : = != < <= > >= et ~
+// (le nom contient). Combinaisons : and (ou une virgule), or, not et
+// parenthèses ; guillemets pour un nom contenant des espaces.
+//
+// L'évaluation est à trois valeurs : une clause sur un champ pas encore lu
+// (ou que la source ne fournit pas) est inconnue, et un processus n'est
+// écarté que si l'expression est fausse quelles que soient ces valeurs.
+// get_process_list() évalue ainsi le filtre dès le PID lu dans /proc, puis
+// après la seule lecture de /proc/[pid]/stat : un processus écarté ne coûte
+// aucune lecture ou une seule, jamais celles de status ni de schedstat.
+
+#define FILTER_MAX_LENGTH 256         // Longueur maximale d'une expression
+#define FILTER_MAX_INSTRUCTIONS 64
+
+// Champs lus par une expression, et champs connus lors d'une évaluation
+#define FILTER_FIELD_PID    0x001
+#define FILTER_FIELD_PPID   0x002
+#define FILTER_FIELD_UID    0x004
+#define FILTER_FIELD_NAME   0x008
+#define FILTER_FIELD_STATE  0x010
+#define FILTER_FIELD_KERNEL 0x020
+#define FILTER_FIELD_CPU    0x040
+#define FILTER_FIELD_MEM    0x080
+#define FILTER_FIELD_TIME   0x100
+#define FILTER_FIELDS_ALL   0x1ff
+// Sources distantes et instantanés publiés : pas de propriétaire transmis
+#define FILTER_FIELDS_REMOTE (FILTER_FIELDS_ALL & ~FILTER_FIELD_UID)
+
+// Résultat d'une évaluation
+#define FILTER_REJECT 0
+#define FILTER_ACCEPT 1
+#define FILTER_UNKNOWN 2   // Dépend d'un champ inconnu
+
+typedef enum {
+    FILTER_OP_CLAUSE,
+    FILTER_OP_AND,
+    FILTER_OP_OR,
+    FILTER_OP_NOT
+} filter_opcode_t;
+
+typedef enum {
+    FILTER_CMP_EQ,
+    FILTER_CMP_NE,
+    FILTER_CMP_LT,
+    FILTER_CMP_LE,
+    FILTER_CMP_GT,
+    FILTER_CMP_GE,
+    FILTER_CMP_CONTAINS   // ~ : le nom contient le texte
+} filter_compare_t;
+
+typedef struct {
+    unsigned char opcode;     // filter_opcode_t
+    unsigned char compare;    // filter_compare_t (clause)
+    unsigned short field;     // FILTER_FIELD_* (clause)
+    double number;            // Valeur des champs numériques
+    char text[64];            // Nom ou lettres d'état
+} filter_instruction_t;
+
+typedef struct filter {
+    filter_instruction_t program[FILTER_MAX_INSTRUCTIONS];  // Ordre postfixé
+    int length;
+    unsigned int fields;      // Champs lus par l'expression
+    char source[FILTER_MAX_LENGTH];   // Expression telle qu'écrite (transmise à l'agent)
+    char error[160];          // Cause de l'échec de filter_compile()
+} filter_t;
+
+// Compile une expression (0 en cas de succès, -1 avec filter->error sinon)
+int filter_compile(filter_t *filter, const char *expression);
+
+// Évalue le filtre sur un processus dont seuls les champs known sont
+// remplis : FILTER_REJECT, FILTER_ACCEPT ou FILTER_UNKNOWN
+int filter_match(const filter_t *filter, const process_info_t *proc, unsigned int known);
+
+// Retire d'une liste les processus rejetés, dans l'ordre (nouveau nombre)
+int filter_apply(const filter_t *filter, process_info_t *list, int count, unsigned int known);
+
+#endif // PROJETLP_FILTER_H
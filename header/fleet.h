@@ -0,0 +1,25 @@
+#ifndef PROJETLP_FLEET_H
+#define PROJETLP_FLEET_H
+
+#include "poller.h"
+
+// Vue fusionnée de tous les hôtes (option -a/--all) : top K global par CPU
+// ou par mémoire, obtenu par fusion k-voies des listes de chaque hôte,
+// déjà triées par le poller à la réception de chaque instantané.
+
+#define FLEET_TOP_K 500
+
+typedef enum {
+    FLEET_SORT_CPU,
+    FLEET_SORT_MEM
+} fleet_sort_t;
+
+typedef struct {
+    int host;              // Index de l'hôte dans le network_manager_t
+    process_info_t proc;
+} fleet_row_t;
+
+// Construit les K premières lignes de la flotte (rows doit contenir k lignes)
+int fleet_build(poller_t *poller, fleet_sort_t sort, fleet_row_t *rows, int k);
+
+#endif // PROJETLP_FLEET_H
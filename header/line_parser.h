@@ -0,0 +1,35 @@
+#ifndef PROJETLP_LINE_PARSER_H
+#define PROJETLP_LINE_PARSER_H
+
+#include <stddef.h>
+
+// Réception incrémentale de la sortie d'une commande : le transport appelle
+// le puits à chaque bloc reçu (bloc modifiable, valable le temps de l'appel).
+// Une valeur de retour non nulle interrompt la lecture.
+typedef int (*output_sink_t)(char *data, size_t len, void *context);
+
+// Appelé pour chaque ligne complète, sans le '\n' et terminée par '\0'
+typedef int (*line_handler_t)(char *line, size_t len, void *context);
+
+// Découpeur de lignes incrémental : les lignes entières d'un bloc sont
+// traitées sur place, seules les lignes à cheval entre deux blocs sont
+// recopiées dans un buffer qui grandit à la demande (aucune limite fixe).
+typedef struct {
+    char *partial;       // Début de ligne reçu sans son '\n'
+    size_t partial_len;
+    size_t partial_capacity;
+    line_handler_t handler;
+    void *context;
+    size_t line_count;   // Nombre de lignes transmises au handler
+} line_parser_t;
+
+void line_parser_init(line_parser_t *parser, line_handler_t handler, void *context);
+int line_parser_feed(line_parser_t *parser, char *data, size_t len);
+int line_parser_finish(line_parser_t *parser);  // Transmet une dernière ligne sans '\n'
+void line_parser_reset(line_parser_t *parser);
+void line_parser_free(line_parser_t *parser);
+
+// Puits (output_sink_t) qui alimente le line_parser_t passé en contexte
+int line_parser_sink(char *data, size_t len, void *context);
+
+#endif // PROJETLP_LINE_PARSER_H
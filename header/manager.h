@@ -1,8 +1,18 @@
 #ifndef PROJETLP_MANAGER_H
 #define PROJETLP_MANAGER_H
 
+typedef struct {
+    int show_help;            // Afficher l'aide au démarrage
+    int all;                  // Vue fusionnée localhost + tous les hôtes distants
+    const char *config_file;  // Fichier de configuration des hôtes (.config par défaut)
+    const char *alerts_file;  // Fichier de règles d'alerte (.alerts par défaut, ignoré s'il est absent)
+    const char *exporter_address;  // Adresse de l'export Prometheus (NULL : pas d'export)
+    const char *attach_name;  // Segment publié à lire au lieu de /proc pour localhost (NULL : /proc)
+    int watch_interval_ms;    // Échantillonnage des processus épinglés (touche w)
+} manager_options_t;
+
 void manager_run();
-void manager(int options);
+void manager(const manager_options_t *options);
 
 #endif //PROJETLP_MANAGER_H
 
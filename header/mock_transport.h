@@ -0,0 +1,34 @@
+#ifndef PROJETLP_MOCK_TRANSPORT_H
+#define PROJETLP_MOCK_TRANSPORT_H
+
+#include "network.h"
+
+// Hôte simulé en mémoire, sans serveur SSH ni telnet : il répond aux
+// commandes ps, au script /proc et aux lots d'actions avec une liste de
+// processus synthétique (ou le contenu d'un fichier ps), après une latence
+// configurable. Sert à tester et mesurer le chemin distant hors ligne.
+//
+// Paramètres dans le champ adresse du .config, séparés par des virgules :
+//   latency=MS   latence de chaque commande (défaut 20)
+//   jitter=MS    variation aléatoire de la latence, +/- (défaut 0)
+//   fail=P       probabilité d'échec d'une commande, entre 0 et 1 (défaut 0)
+//   procs=N      nombre de processus synthétiques (défaut 200)
+//   file=CHEMIN  sortie de "ps -eo pid,ppid,stat,pcpu,rss,etimes,comm" à servir telle quelle
+// Exemple : mock1:latency=30,jitter=10,fail=0.05,procs=500:0:::mock
+
+#define MOCK_DEFAULT_LATENCY_MS 20
+#define MOCK_DEFAULT_PROCESSES 200
+
+typedef struct {
+    int latency_ms;
+    int jitter_ms;
+    double failure_rate;
+    int process_count;
+    char file[128];     // Sortie ps enregistrée (vide = liste synthétique)
+} mock_spec_t;
+
+void mock_spec_parse(const char *text, mock_spec_t *spec);
+
+extern const transport_ops_t mock_transport;
+
+#endif // PROJETLP_MOCK_TRANSPORT_H
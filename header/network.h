@@ -2,16 +2,28 @@
 #define PROJETLP_NETWORK_H
 
 #include "process.h"
+#include "line_parser.h"
 
-#define MAX_HOSTS 10
 #define BUFFER_SIZE 4096
 
+#define DEFAULT_POLL_INTERVAL_MS 1000  // Intervalle de collecte par défaut d'un hôte
+#define DEFAULT_DEADLINE_MS 3000       // Durée maximale d'une collecte par défaut
+
 typedef enum {
     CONNECTION_SSH,
     CONNECTION_TELNET,
+    CONNECTION_MOCK,   // Hôte simulé en mémoire (tests, benchmark), voir mock_transport.h
+    CONNECTION_REPLAY, // Rejeu d'un enregistrement de l'agent, sans transport (voir collector.h)
+    CONNECTION_SHM,    // Instantanés publiés en mémoire partagée par un autre processus (voir shm.h)
     CONNECTION_LOCAL
 } connection_type_t;
 
+typedef enum {
+    COLLECT_PS,     // Sortie de ps analysée par le visualiseur
+    COLLECT_AGENT,  // Instantanés binaires de l'agent distant (SSH uniquement)
+    COLLECT_PROC    // Script awk lisant /proc, CPU% calculé par le visualiseur
+} collect_mode_t;
+
 typedef struct {
     char name[64];
     char address[128];
@@ -19,9 +31,23 @@ typedef struct {
     char username[64];
     char password[64];
     connection_type_t type;
+    collect_mode_t mode;
+    int interval_ms;  // Intervalle entre deux collectes
+    int deadline_ms;  // Au-delà, la collecte est abandonnée
     int is_local;  // 1 pour localhost, 0 pour distant
 } host_config_t;
 
+// Transport distant : un jeu d'opérations par type de connexion.
+// Tout le reste du code réseau (ps, /proc, actions) passe par execute_stream.
+typedef struct {
+    const char *name;          // Type dans le fichier de configuration
+    connection_type_t type;
+    int (*connect)(const host_config_t *host);
+    void (*disconnect)(const host_config_t *host);
+    int (*execute_stream)(const host_config_t *host, const char *command,
+                          output_sink_t sink, void *context);
+} transport_ops_t;
+
 typedef struct {
     host_config_t *hosts;
     int count;
@@ -32,31 +58,67 @@ typedef struct {
 int network_init(network_manager_t *manager, const char *config_file);
 void network_cleanup(network_manager_t *manager);
 
+// Échéance des opérations réseau du thread courant (horloge monotone en ms)
+long long network_now_ms(void);
+void network_set_deadline(long long deadline_ms);
+long long network_get_deadline(void);
+int network_remaining_ms(void);
+
+// Diagnostic de la dernière opération réseau du thread courant
+void network_clear_error(void);  // Efface aussi le dernier RTT
+void network_set_error(const char *format, ...) __attribute__((format(printf, 1, 2)));
+const char *network_get_error(void);  // Chaîne vide si aucune erreur
+int network_last_rtt_ms(void);        // Délai avant le premier octet de la dernière réponse, -1 si inconnu
+
+// Chaîne entre apostrophes pour le shell (allouée, à libérer ; NULL en cas d'erreur)
+char *network_shell_quote(const char *text);
+
+// Transports disponibles (NULL si le type est inconnu ou local)
+const transport_ops_t *transport_find(const char *name);
+const transport_ops_t *transport_for(const host_config_t *host);
+
 // Gestion des connexions
 int connect_to_host(const host_config_t *host);
 int disconnect_from_host(const host_config_t *host);
 
 // Récupération des processus distants
 int get_remote_process_list(const host_config_t *host, process_info_t **list, int *count);
+int remote_ps_fetch(const host_config_t *host, process_info_t **list, int *count);
 
 // Exécution de commandes distantes
 int execute_remote_command(const host_config_t *host, const char *command, char *output, int output_size);
+int execute_remote_command_stream(const host_config_t *host, const char *command,
+                                  output_sink_t sink, void *context);
 
 // Gestion des actions sur processus distants
+typedef enum {
+    PROCESS_ACTION_KILL,
+    PROCESS_ACTION_PAUSE,
+    PROCESS_ACTION_RESUME,
+    PROCESS_ACTION_RESTART
+} process_action_t;
+
+// Lot d'actions sur un hôte en une seule commande distante (un résultat par action)
+int remote_process_actions(const host_config_t *host, const int *pids, const process_action_t *actions,
+                           int *results, int count);
 int remote_kill_process(const host_config_t *host, int pid);
 int remote_pause_process(const host_config_t *host, int pid);
 int remote_resume_process(const host_config_t *host, int pid);
 int remote_restart_process(const host_config_t *host, int pid);
 
 // Parsing de configuration
-int parse_config_file(const char *filename, host_config_t *hosts, int max_hosts);
+int parse_config_file(const char *filename, host_config_t **hosts);
 
 // SSH spécifique
 int ssh_execute(const char *host, int port, const char *username, const char *password,
                 const char *command, char *output, int output_size);
+int ssh_execute_stream(const char *host, int port, const char *username, const char *password,
+                       const char *command, output_sink_t sink, void *context);
 
 // Telnet spécifique
 int telnet_execute(const char *host, int port, const char *username, const char *password,
                    const char *command, char *output, int output_size);
+int telnet_execute_stream(const char *host, int port, const char *username, const char *password,
+                          const char *command, output_sink_t sink, void *context);
 
 #endif // PROJETLP_NETWORK_H
\ No newline at end of file
@@ -0,0 +1,118 @@
+#ifndef PROJETLP_POLLER_H
+#define PROJETLP_POLLER_H
+
+#include <pthread.h>
+#include "network.h"
+#include "collector.h"
+#include "arena.h"
+#include "alert.h"
+
+// Collecte concurrente de tous les hôtes du network_manager_t par un pool
+// borné de threads. Chaque hôte a son propre intervalle et sa propre
+// échéance : un hôte lent ou injoignable n'occupe qu'un thread et ne retarde
+// ni les autres hôtes ni l'interface, qui lit seulement le dernier instantané.
+// Les hôtes en attente sont rangés dans un tas binaire trié par prochaine
+// collecte ; les premières collectes sont réparties sur l'intervalle et
+// l'hôte affiché passe avant les autres dès qu'il est dû. Un hôte en échec
+// est retenté après une attente qui double à chaque échec (avec gigue).
+
+#define POLLER_MAX_WORKERS 16  // Nombre maximal de collectes (connexions) simultanées
+#define POLLER_BACKOFF_MAX_MS 60000  // Attente maximale entre deux tentatives vers un hôte en échec
+#define POLLER_DOWN_AFTER 3          // Échecs consécutifs avant de déclarer un hôte hors service
+
+typedef enum {
+    HOST_STATUS_UNKNOWN,   // Aucune collecte terminée
+    HOST_STATUS_UP,
+    HOST_STATUS_DEGRADED,  // Échecs récents ou collecte lente (plus de la moitié de l'échéance)
+    HOST_STATUS_DOWN       // POLLER_DOWN_AFTER échecs consécutifs, ou aucun succès
+} host_status_t;
+
+// Santé d'un hôte, mise à jour à chaque collecte
+typedef struct {
+    host_status_t status;
+    int rtt_ms;                  // Délai avant le premier octet, lissé (-1 si inconnu)
+    int fetch_ms;                // Durée de la dernière collecte
+    unsigned long success_count;
+    unsigned long failure_count;
+    int consecutive_failures;
+    long long retry_ms;          // Prochaine tentative (network_now_ms()) si l'hôte est en échec, 0 sinon
+    char last_error[128];        // Cause du dernier échec (vide si aucun)
+} host_health_t;
+
+// Instantané d'un hôte, alloué dans sa propre arène. La publication en
+// tient une référence et chaque lecteur une autre : l'arène est remise à
+// zéro et l'instantané recyclé pour une prochaine collecte quand la
+// dernière référence est rendue.
+typedef struct poller_snapshot {
+    arena_t arena;
+    process_info_t *list;
+    int count;
+    int *by_cpu;                 // Index de list triés par CPU décroissant
+    int *by_mem;                 // Index de list triés par mémoire décroissante
+    unsigned long generation;
+    int host;                    // Hôte d'origine
+    int references;
+    struct poller_snapshot *next;  // Chaînage des instantanés recyclables de l'hôte
+} poller_snapshot_t;
+
+typedef struct {
+    poller_snapshot_t *snapshot; // Dernier instantané reçu (NULL si aucun)
+    poller_snapshot_t *spare;    // Instantanés libres, arène prête à resservir
+    unsigned long generation;    // Incrémenté à chaque nouvel instantané
+    int last_result;             // Résultat de la dernière collecte (0 = succès)
+    long long last_success_ms;   // Date du dernier instantané (network_now_ms())
+    long long next_due_ms;       // Prochaine collecte prévue
+    int in_flight;               // Collecte en cours par un thread
+    int heap_index;              // Position dans le tas des hôtes en attente (-1 si en cours)
+    host_health_t health;
+    collector_t collector;       // Source des instantanés (backend selon le type et le mode de l'hôte)
+} poller_slot_t;
+
+typedef struct {
+    network_manager_t *network;
+    poller_slot_t *slots;        // Un emplacement par hôte
+    int slot_count;
+    int *heap;                   // Index des hôtes en attente, tas binaire sur next_due_ms
+    int heap_count;
+    int focus;                   // Hôte affiché, prioritaire quand il est dû
+    unsigned long generation;    // Incrémenté à chaque nouvel instantané, tous hôtes confondus
+    pthread_t workers[POLLER_MAX_WORKERS];
+    int worker_count;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int running;
+    alert_engine_t *alerts;      // Règles évaluées à chaque nouvel instantané (NULL si aucune)
+} poller_t;
+
+int poller_start(poller_t *poller, network_manager_t *network);
+void poller_stop(poller_t *poller);
+
+// Copie du dernier instantané d'un hôte s'il est plus récent que *generation
+// (1 si une nouvelle liste a été copiée, 0 sinon, -1 en cas d'erreur)
+int poller_get_snapshot(poller_t *poller, int host, unsigned long *generation,
+                        process_info_t **list, int *count);
+
+// Dernier instantané d'un hôte s'il est plus récent que *generation, sans
+// copie : en lecture seule, tenu jusqu'à poller_release_snapshot()
+// (NULL si rien de nouveau)
+poller_snapshot_t *poller_acquire_snapshot(poller_t *poller, int host, unsigned long *generation);
+void poller_release_snapshot(poller_t *poller, poller_snapshot_t *snapshot);
+
+// Génération globale, incrémentée à chaque instantané reçu de n'importe quel hôte
+unsigned long poller_generation(poller_t *poller);
+
+// Copie de la santé d'un hôte (0 en cas de succès, -1 si l'index est invalide)
+int poller_get_health(poller_t *poller, int host, host_health_t *health);
+const char *host_status_name(host_status_t status);
+
+// Demande une collecte immédiate d'un hôte (même en attente après un échec)
+void poller_refresh_now(poller_t *poller, int host);
+
+// Règles d'alerte à évaluer sur chaque nouvel instantané (NULL pour arrêter) ;
+// le moteur doit rester valide jusqu'à poller_stop()
+void poller_set_alerts(poller_t *poller, alert_engine_t *alerts);
+
+// Change l'hôte affiché (prioritaire) et le rend dû immédiatement
+void poller_set_focus(poller_t *poller, int host);
+
+#endif // PROJETLP_POLLER_H
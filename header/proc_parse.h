@@ -0,0 +1,74 @@
+#ifndef PROJETLP_PROC_PARSE_H
+#define PROJETLP_PROC_PARSE_H
+
+#include <stddef.h>
+#include "process.h"
+
+// Analyseurs des fichiers de /proc et des sorties de ps, sur tampon : ils
+// ne font aucune entrée/sortie, ne lisent jamais au-delà de len (le tampon
+// n'a pas besoin d'être terminé par '\0') et renvoient -1 sur une entrée
+// incomplète ou mal formée. Mesurés et fuzzés par --bench-parsers (voir
+// bench.h) et par la cible libFuzzer de src/proc_parse_fuzz.c.
+
+// Champs utiles de /proc/[pid]/stat
+typedef struct {
+    int pid;
+    char name[256];                // comm, entre la première '(' et la dernière ')'
+    char state;
+    int ppid;
+    unsigned long long minflt;     // Champ 10 : défauts de page mineurs
+    unsigned long long majflt;     // Champ 12 : défauts de page majeurs (lecture disque)
+    unsigned long long utime;      // Champ 14 (ticks)
+    unsigned long long stime;      // Champ 15
+    int num_threads;               // Champ 20
+    unsigned long long starttime;  // Champ 22 (ticks depuis le démarrage)
+    unsigned long long rss_pages;  // Champ 24
+} proc_stat_t;
+
+// /proc/[pid]/schedstat (et /proc/[pid]/task/[tid]/schedstat)
+typedef struct {
+    unsigned long long run_ns;     // Temps passé sur un CPU
+    unsigned long long wait_ns;    // Temps passé prêt, en file d'attente d'exécution
+    unsigned long long slices;     // Nombre de passages sur un CPU
+} proc_schedstat_t;
+
+// Ligne de /proc/net/tcp, tcp6, udp ou udp6
+typedef struct {
+    unsigned int state;            // Champ st (TCP_ESTABLISHED = 0x01, TCP_LISTEN = 0x0A...)
+    unsigned long long inode;      // 0 pour une socket sans propriétaire (TIME_WAIT)
+} proc_net_socket_t;
+
+// Champs utiles de /proc/[pid]/status (-1 pour un champ absent)
+typedef struct {
+    char name[256];
+    char state;                    // '?' si absent
+    int pid;
+    int ppid;
+    int vmrss_kb;                  // Absent pour un thread noyau
+    int kthread;                   // Ligne Kthread: des noyaux récents
+    long long voluntary_switches;     // voluntary_ctxt_switches (attente d'une ressource)
+    long long nonvoluntary_switches;  // nonvoluntary_ctxt_switches (préemption)
+} proc_status_t;
+
+// Format de sortie de la commande ps distante
+typedef enum {
+    PS_FORMAT_COLUMNS,  // ps -eo pid,ppid,stat,pcpu,rss,etimes,comm
+    PS_FORMAT_AUX       // ps aux (procps ancien, busybox...)
+} ps_format_t;
+
+int proc_parse_stat(const char *buffer, size_t len, proc_stat_t *stat);
+int proc_parse_status(const char *buffer, size_t len, proc_status_t *status);
+int proc_parse_statm(const char *buffer, size_t len, unsigned long long *size_pages,
+                     unsigned long long *resident_pages);
+int proc_parse_schedstat(const char *buffer, size_t len, proc_schedstat_t *schedstat);
+// Ligne "cpu" de /proc/stat : user + nice + system + idle + iowait + irq + softirq
+int proc_parse_cpu_total(const char *buffer, size_t len, unsigned long long *total);
+int proc_parse_net_socket(const char *line, size_t len, proc_net_socket_t *entry);
+// Une ligne de ps ; proc est entièrement rempli (cpu_percent moyen de ps)
+int proc_parse_ps_line(const char *line, size_t len, ps_format_t format, process_info_t *proc);
+
+// Passe une entrée de fuzzing à l'analyseur choisi par son premier octet et
+// vérifie les invariants du résultat : 0 si tout est cohérent, -1 sinon
+int proc_parse_fuzz_one(const char *data, size_t len);
+
+#endif // PROJETLP_PROC_PARSE_H
@@ -10,8 +10,25 @@ typedef struct {
     char state;
     int ppid;
     int is_kernel;
+    float wait_percent;      // Attente en file d'exécution sur l'intervalle (mode schedstat)
+    float slices_per_s;      // Passages sur un CPU par seconde (mode schedstat)
+    float minflt_per_s;      // Défauts de page mineurs par seconde (collecte locale)
+    float majflt_per_s;      // Défauts de page majeurs par seconde
+    float voluntary_switches_per_s;     // Changements de contexte volontaires par seconde
+    float nonvoluntary_switches_per_s;  // Changements de contexte forcés par seconde
+    int uid;                 // Propriétaire (collecte locale, lu seulement si le filtre porte dessus)
+    int tcp_sockets;         // Sockets TCP du processus (--sockets, -1 si ses fd sont illisibles)
+    int tcp_established;     // Dont connexions établies
+    int tcp_listen;          // Dont sockets en écoute
+    int tcp_close_wait;      // Dont connexions fermées par le pair, pas encore par le processus
+    int udp_sockets;         // Sockets UDP du processus
 } process_info_t;
 
+typedef enum {
+    PROCESS_RANK_CPU,   // CPU sur l'intervalle
+    PROCESS_RANK_MEM    // Mémoire résidente
+} process_rank_t;
+
 // Fonctions existantes
 int get_process_list(process_info_t **list, int *count);
 int kill_process(int pid);
@@ -20,7 +37,36 @@ int resume_process(int pid);
 int restart_process(int pid);
 int get_process(int pid, process_info_t *proc);
 
-// Nouvelle fonction abstraite
+// Mode top K : get_process_list() ne renvoie que les K processus les plus
+// consommateurs (k = 0 pour la liste complète)
+void process_set_top_k(int k, process_rank_t rank);
+int process_get_top_k(void);
+
+// Source du CPU% local : ticks de /proc/[pid]/stat (10 ms en général) ou
+// nanosecondes de /proc/[pid]/schedstat, qui donne aussi l'attente en file
+// d'exécution et le nombre de passages sur un CPU
+typedef enum {
+    PROCESS_SAMPLING_TICKS,
+    PROCESS_SAMPLING_SCHEDSTAT
+} process_sampling_t;
+
+void process_set_sampling(process_sampling_t sampling);
+process_sampling_t process_get_sampling(void);
+
+// Comptage des sockets TCP et UDP de chaque processus local (voir
+// sockets.h), désactivé par défaut
+void process_set_sockets(int enabled);
+int process_get_sockets(void);
+
+// Filtre appliqué pendant la collecte locale (voir filter.h) et aux
+// collectes distantes ; NULL pour tout garder. Le filtre doit rester
+// valide tant qu'il est installé.
+struct filter;
+void process_set_filter(const struct filter *filter);
+const struct filter *process_get_filter(void);
+
+// Collecte d'une liste de processus depuis une source quelconque (context
+// propre à la source) : opération sample des backends de collector.h
 typedef int (*process_fetcher_t)(void *context, process_info_t **list, int *count);
 
 #endif // PROJETLP_PROCESS_H
\ No newline at end of file
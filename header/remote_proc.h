@@ -0,0 +1,16 @@
+#ifndef PROJETLP_REMOTE_PROC_H
+#define PROJETLP_REMOTE_PROC_H
+
+#include "network.h"
+
+// Mode de collecte "proc" : un script awk compact lit /proc/stat, /proc/uptime,
+// /proc/[pid]/stat et /proc/[pid]/statm en un seul passage sur l'hôte distant
+// et renvoie les valeurs brutes (ticks, pages). Le visualiseur garde, par hôte,
+// les ticks de l'échantillon précédent : le CPU% distant est instantané et
+// calculé exactement comme en local.
+
+int remote_proc_fetch(const host_config_t *host, process_info_t **list, int *count);
+void remote_proc_forget(const host_config_t *host);
+void remote_proc_cleanup(void);
+
+#endif // PROJETLP_REMOTE_PROC_H
@@ -0,0 +1,88 @@
+#ifndef PROJETLP_SHM_H
+#define PROJETLP_SHM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "process.h"
+
+// Publication des instantanés locaux en mémoire partagée POSIX : un seul
+// collecteur lit /proc (--publish), tous les autres lecteurs (visualiseurs
+// lancés avec --attach, outils tiers) s'attachent en lecture seule et
+// copient le dernier instantané sans rien collecter eux-mêmes.
+//
+// Segment (shm_open, /dev/shm) : un shm_header_t puis, à partir de
+// header_size, capacity enregistrements shm_process_t dont les count
+// premiers sont valides. Entiers dans l'ordre natif de l'hôte.
+//
+// Cohérence par seqlock : le publieur rend sequence impaire, écrit
+// l'instantané, puis la rend paire. Un lecteur relit sequence après sa
+// copie et recommence si elle a changé ou si elle était impaire. Le
+// segment peut grandir (segment_size) : un lecteur dont la projection est
+// plus petite la refait avant de copier.
+
+#define SHM_DEFAULT_NAME "/gestionressources"
+#define SHM_MAGIC 0x48535247u     // "GRSH"
+#define SHM_VERSION 1
+#define SHM_HEADER_SIZE 256       // Début des enregistrements
+#define SHM_NAME_SIZE 64
+#define SHM_READ_RETRIES 1000     // Copies recommencées avant d'abandonner (publieur bloqué en écriture)
+
+typedef struct {
+    int32_t pid;
+    int32_t ppid;
+    float cpu_percent;
+    int32_t memory_kb;
+    float time;
+    char state;
+    char is_kernel;
+    char reserved[2];
+    char name[SHM_NAME_SIZE];
+} shm_process_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;     // Position du premier enregistrement
+    uint32_t record_size;     // sizeof(shm_process_t)
+    uint64_t sequence;        // Impaire pendant une publication
+    uint64_t generation;      // Instantanés publiés
+    int64_t timestamp_ms;     // Date de l'instantané (CLOCK_REALTIME)
+    uint64_t segment_size;    // Taille actuelle du segment
+    uint32_t capacity;        // Enregistrements que le segment peut contenir
+    uint32_t count;           // Processus de l'instantané
+    int32_t publisher_pid;
+    uint32_t interval_ms;     // Intervalle de publication
+    char host[SHM_NAME_SIZE];
+} shm_header_t;
+
+typedef struct {
+    char name[SHM_NAME_SIZE];
+    int fd;
+    shm_header_t *header;     // Projection en écriture
+    size_t size;
+} shm_publisher_t;
+
+typedef struct {
+    char name[SHM_NAME_SIZE];
+    int fd;                   // -1 tant que le segment n'est pas ouvert
+    const shm_header_t *header;  // Projection en lecture seule
+    size_t size;
+    shm_process_t *copy;      // Copie privée de la dernière lecture cohérente
+    int copy_capacity;
+    uint64_t generation;      // Génération de la dernière lecture
+} shm_reader_t;
+
+// Publieur (crée ou reprend le segment)
+int shm_publisher_open(shm_publisher_t *publisher, const char *name, int interval_ms);
+int shm_publish(shm_publisher_t *publisher, const process_info_t *list, int count);
+void shm_publisher_close(shm_publisher_t *publisher);  // Supprime le segment
+
+// Collecte locale publiée en boucle jusqu'à SIGINT ou SIGTERM (mode --publish)
+int shm_publish_run(const char *name, int interval_ms);
+
+// Lecteur : l'attachement est refait si le publieur a changé
+void shm_reader_init(shm_reader_t *reader, const char *name);
+int shm_read(shm_reader_t *reader, process_info_t **list, int *count);
+void shm_reader_close(shm_reader_t *reader);
+
+#endif // PROJETLP_SHM_H
@@ -0,0 +1,38 @@
+#ifndef PROJETLP_SOCKETS_H
+#define PROJETLP_SOCKETS_H
+
+#include "process.h"
+
+// Nombre de sockets TCP et UDP de chaque processus local (--sockets), avec
+// la répartition des sockets TCP par état. À chaque collecte,
+// /proc/net/tcp, tcp6, udp et udp6 sont lus une seule fois dans une table
+// de hachage inode -> (protocole, état), puis croisés avec les inodes des
+// liens "socket:[N]" de /proc/[pid]/fd.
+//
+// Lire les descripteurs coûte un readlink par fd ouvert : ces listes sont
+// gardées en cache et relues au plus toutes les SOCKETS_FD_REFRESH_MS par
+// processus, SOCKETS_FD_BUDGET liens au plus par collecte. L'état, lui,
+// vient toujours de la table du moment : une socket fermée disparaît du
+// compte dès la collecte suivante, une socket ouverte depuis la dernière
+// relecture n'y apparaît qu'à la prochaine.
+//
+// Comme les échantillons CPU de process.c, l'état du module n'est utilisé
+// que par le thread qui appelle get_process_list().
+
+#define SOCKETS_FD_REFRESH_MS 5000   // Âge maximal de la liste des sockets d'un processus
+#define SOCKETS_FD_BUDGET 20000      // Liens de /proc/[pid]/fd lus au plus par collecte
+
+// États TCP de /proc/net/tcp (include/net/tcp_states.h)
+#define SOCKETS_TCP_ESTABLISHED 0x01
+#define SOCKETS_TCP_CLOSE_WAIT  0x08
+#define SOCKETS_TCP_LISTEN      0x0A
+
+// Remplit tcp_sockets, tcp_established, tcp_listen, tcp_close_wait et
+// udp_sockets de chaque processus (-1 si ses descripteurs sont illisibles
+// ou pas encore lus) : 0 en cas de succès, -1 en cas d'erreur d'allocation
+int sockets_annotate(process_info_t *list, int count);
+
+// Libère la table et le cache des descripteurs
+void sockets_cleanup(void);
+
+#endif // PROJETLP_SOCKETS_H
@@ -0,0 +1,37 @@
+#ifndef PROJETLP_SSH_POOL_H
+#define PROJETLP_SSH_POOL_H
+
+#include "line_parser.h"
+
+// Pool de sessions SSH persistantes (libssh).
+// Une session authentifiée est conservée par couple adresse/port/utilisateur,
+// chaque commande ouvre simplement un nouveau canal sur cette session.
+// Sans libssh (HAVE_LIBSSH non défini), ssh_pool_available() renvoie 0 et
+// ssh_execute() se rabat sur le client ssh en ligne de commande.
+
+int ssh_pool_available(void);
+
+// Exécution d'une commande sur la session de l'hôte (connexion paresseuse) ;
+// la sortie est transmise au puits au fil de sa réception
+int ssh_pool_execute(const char *host, int port, const char *username, const char *password,
+                     const char *command, output_sink_t sink, void *context);
+
+// Ouvre la session si nécessaire (0 si la session est prête)
+int ssh_pool_connect(const char *host, int port, const char *username, const char *password);
+
+// Ferme la session d'un hôte / toutes les sessions
+void ssh_pool_disconnect(const char *host, int port, const char *username);
+void ssh_pool_cleanup(void);
+
+// Flux bidirectionnel longue durée vers une commande distante (stdin/stdout).
+// Avec libssh : un canal de la session du pool ; sinon un client ssh lancé en fils.
+typedef struct ssh_stream ssh_stream_t;
+
+ssh_stream_t *ssh_stream_open(const char *host, int port, const char *username, const char *password,
+                              const char *command);
+// Renvoie le nombre d'octets lus, 0 si rien n'est arrivé avant timeout_ms, -1 en fin de flux ou erreur
+int ssh_stream_read(ssh_stream_t *stream, void *buffer, int size, int timeout_ms);
+int ssh_stream_write(ssh_stream_t *stream, const void *buffer, int size);
+void ssh_stream_close(ssh_stream_t *stream);
+
+#endif // PROJETLP_SSH_POOL_H
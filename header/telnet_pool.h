@@ -0,0 +1,24 @@
+#ifndef PROJETLP_TELNET_POOL_H
+#define PROJETLP_TELNET_POOL_H
+
+#include "line_parser.h"
+
+// Client telnet intégré (sockets, sans expect ni binaire telnet).
+// Une session connectée et authentifiée est conservée par couple
+// adresse/port/utilisateur. Chaque commande est envoyée d'un bloc, encadrée
+// de marqueurs numérotés : la sortie et le code de retour sont délimités
+// sans dépendre de l'invite du shell distant.
+
+// Exécution d'une commande sur la session de l'hôte (connexion paresseuse) ;
+// la sortie est transmise au puits au fil de sa réception
+int telnet_pool_execute(const char *host, int port, const char *username, const char *password,
+                        const char *command, output_sink_t sink, void *context);
+
+// Ouvre la session si nécessaire (0 si la session est prête)
+int telnet_pool_connect(const char *host, int port, const char *username, const char *password);
+
+// Ferme la session d'un hôte / toutes les sessions
+void telnet_pool_disconnect(const char *host, int port, const char *username);
+void telnet_pool_cleanup(void);
+
+#endif // PROJETLP_TELNET_POOL_H
@@ -2,6 +2,10 @@
 #define UI_H
 
 #include "process.h"
+#include "network.h"
+#include "fleet.h"
+#include "cgroup.h"
+#include "watch.h"
 
 void ui_draw_help(void);
 
@@ -16,20 +20,37 @@ typedef enum {
     UI_ACTION_RESTART,
     UI_ACTION_QUIT,
     UI_ACTION_NEXT_HOST,
-    UI_ACTION_PREV_HOST
+    UI_ACTION_PREV_HOST,
+    UI_ACTION_SORT_CPU,
+    UI_ACTION_SORT_MEM,
+    UI_ACTION_CGROUPS,
+    UI_ACTION_SELECT,
+    UI_ACTION_WATCH
 } ui_action_t;
 
+/* Colonnes ajoutées à la liste des processus (ui_set_extra_columns) */
+#define UI_COLUMNS_RATES 1   // Défauts de page et changements de contexte par seconde
+#define UI_COLUMNS_SCHED 2   // Attente en file d'exécution et passages sur un CPU
+#define UI_COLUMNS_SOCKETS 4 // Sockets TCP par état et sockets UDP (--sockets)
+
 /* Cycle de vie UI */
 void ui_init(void);
 void ui_cleanup(void);
 
 /* Affichage */
 void ui_draw_header(void);
+void ui_set_header(const char *text);
+void ui_set_status(const char *text);
+void ui_set_extra_columns(int columns);
+void ui_set_watch(const watch_entry_t *entries, int count, int interval_ms);
 void ui_draw_processes(process_info_t *list, int count);
+void ui_draw_fleet(const fleet_row_t *rows, int count, const host_config_t *hosts);
+void ui_draw_cgroups(const cgroup_info_t *list, int count);
 
 /* Entrées utilisateur */
 ui_action_t ui_get_action(void);
 int ui_get_selected_index(void);
+void ui_reset_selection(void);
 
 /* Fenêtres */
 void ui_show_search(char *buffer, int maxlen);
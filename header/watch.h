@@ -0,0 +1,74 @@
+#ifndef PROJETLP_WATCH_H
+#define PROJETLP_WATCH_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+// Suivi rapproché de quelques processus locaux épinglés (touche w). Un
+// thread dédié les échantillonne toutes les 10 à 100 ms, indépendamment du
+// rafraîchissement de la table, et garde un historique court de leur CPU%
+// pour un mini-graphique. Chaque PID est ouvert avec pidfd_open() : la fin
+// du processus réveille le thread aussitôt, sans attendre l'échantillon
+// suivant, et un PID réutilisé entre-temps n'est jamais confondu avec
+// l'ancien. Sans pidfd (noyau antérieur à 5.3), la fin est détectée à
+// l'échantillon suivant par l'échec de la lecture ou le changement de la
+// date de démarrage.
+
+#define WATCH_MAX_PIDS 8                 // Processus épinglés en même temps
+#define WATCH_HISTORY 120                // Échantillons gardés par processus
+#define WATCH_DEFAULT_INTERVAL_MS 50
+#define WATCH_MIN_INTERVAL_MS 10
+#define WATCH_MAX_INTERVAL_MS 100
+#define WATCH_EXITED_KEEP_MS 10000       // Durée d'affichage d'un processus terminé
+
+typedef struct {
+    int pid;
+    char name[256];
+    int pidfd;                           // -1 si pidfd_open() est indisponible
+    unsigned long long starttime;        // Champ 22 de stat, identifie le processus derrière le PID
+    int exited;
+    long long exit_ms;                   // Date de la fin (network_now_ms())
+    char state;
+    float cpu_percent;                   // Sur le dernier intervalle (ns de schedstat, ticks à défaut)
+    float wait_percent;                  // Attente en file d'exécution (-1 sans schedstat)
+    int memory_kb;
+    int threads;
+    float history[WATCH_HISTORY];        // CPU% des derniers échantillons, anneau
+    int history_next;                    // Prochaine case écrite
+    int history_count;
+    // Lecture précédente, base des taux
+    unsigned long long last_run_ns;
+    unsigned long long last_wait_ns;
+    unsigned long long last_ticks;
+    long long last_sample_us;
+    int has_last;
+} watch_entry_t;
+
+typedef struct {
+    watch_entry_t entries[WATCH_MAX_PIDS];
+    int count;
+    int interval_ms;
+    unsigned long exit_id;               // Incrémenté à chaque fin détectée
+    char exit_message[256];              // Dernière fin détectée
+    pthread_t thread;
+    pthread_mutex_t lock;
+    int wake_pipe[2];                    // Réveille le thread (épinglage, arrêt)
+    int running;
+} watch_t;
+
+// Démarre le thread de suivi (intervalle borné à [WATCH_MIN_INTERVAL_MS, WATCH_MAX_INTERVAL_MS])
+int watch_start(watch_t *watch, int interval_ms);
+void watch_stop(watch_t *watch);
+
+// Épingle un PID, ou le retire s'il l'est déjà : 1 si épinglé, 0 si retiré,
+// -1 si le processus n'existe pas ou si WATCH_MAX_PIDS sont déjà suivis
+int watch_toggle(watch_t *watch, int pid);
+
+// Copie des processus suivis (nombre copié)
+int watch_snapshot(watch_t *watch, watch_entry_t *entries, int max);
+
+// Dernière fin de processus épinglé si elle est plus récente que *seen
+// (1 si un message a été copié)
+int watch_poll_exit(watch_t *watch, unsigned long *seen, char *buffer, size_t size);
+
+#endif // PROJETLP_WATCH_H
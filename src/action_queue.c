@@ -0,0 +1,217 @@
+#include "action_queue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Ajoute une action à un tableau dynamique (agrandi par doublement)
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int request_append(action_request_t **array, int *count, int *capacity,
+                          const action_request_t *request) {
+    if (*count >= *capacity) {
+        int new_capacity = *capacity ? *capacity * 2 : 16;
+        action_request_t *tmp = realloc(*array, sizeof(action_request_t) * new_capacity);
+        if (!tmp) return -1;
+        *array = tmp;
+        *capacity = new_capacity;
+    }
+    (*array)[(*count)++] = *request;
+    return 0;
+}
+
+/**
+ * @brief Choisit l'hôte de la plus ancienne action en attente dont aucun lot n'est en cours
+ *
+ * Doit être appelée sous queue->lock.
+ *
+ * @return Index de l'hôte, ou -1 si rien n'est disponible
+ */
+static int action_queue_pick_host(action_queue_t *queue) {
+    for (int i = 0; i < queue->pending_count; i++) {
+        if (!queue->host_busy[queue->pending[i].host]) return queue->pending[i].host;
+    }
+    return -1;
+}
+
+/**
+ * @brief Boucle d'un thread d'exécution des actions
+ *
+ * Retire d'un coup toutes les actions en attente de l'hôte choisi (dans
+ * leur ordre de dépôt), les exécute en une seule commande avec l'échéance
+ * de l'hôte, puis publie chaque résultat.
+ */
+static void *action_queue_worker(void *arg) {
+    action_queue_t *queue = arg;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->running) {
+        int host = action_queue_pick_host(queue);
+        if (host == -1) {
+            pthread_cond_wait(&queue->wake, &queue->lock);
+            continue;
+        }
+
+        // Regrouper les actions de cet hôte
+        int batch_count = 0;
+        for (int i = 0; i < queue->pending_count; i++) {
+            if (queue->pending[i].host == host) batch_count++;
+        }
+
+        action_request_t *batch = malloc(sizeof(action_request_t) * batch_count);
+        int *pids = malloc(sizeof(int) * batch_count);
+        process_action_t *actions = malloc(sizeof(process_action_t) * batch_count);
+        int *results = malloc(sizeof(int) * batch_count);
+        if (!batch || !pids || !actions || !results) {
+            free(batch);
+            free(pids);
+            free(actions);
+            free(results);
+            pthread_cond_wait(&queue->wake, &queue->lock);
+            continue;
+        }
+
+        int kept = 0;
+        int taken = 0;
+        for (int i = 0; i < queue->pending_count; i++) {
+            if (queue->pending[i].host == host) {
+                batch[taken] = queue->pending[i];
+                pids[taken] = batch[taken].pid;
+                actions[taken] = batch[taken].action;
+                taken++;
+            } else {
+                queue->pending[kept++] = queue->pending[i];
+            }
+        }
+        queue->pending_count = kept;
+        queue->host_busy[host] = 1;
+        const host_config_t *config = &queue->network->hosts[host];
+        pthread_mutex_unlock(&queue->lock);
+
+        network_set_deadline(network_now_ms() + config->deadline_ms);
+        remote_process_actions(config, pids, actions, results, batch_count);
+        network_set_deadline(0);
+
+        pthread_mutex_lock(&queue->lock);
+        for (int i = 0; i < batch_count; i++) {
+            batch[i].result = results[i];
+            request_append(&queue->done, &queue->done_count, &queue->done_capacity, &batch[i]);
+        }
+        queue->host_busy[host] = 0;
+        pthread_cond_broadcast(&queue->wake);
+
+        free(batch);
+        free(pids);
+        free(actions);
+        free(results);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return NULL;
+}
+
+/**
+ * @brief Démarre les threads d'exécution des actions
+ *
+ * @param queue Structure à initialiser
+ * @param network Gestionnaire réseau (doit rester valide jusqu'à action_queue_stop())
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int action_queue_start(action_queue_t *queue, network_manager_t *network) {
+    if (!queue || !network || network->count <= 0) return -1;
+
+    memset(queue, 0, sizeof(action_queue_t));
+    queue->network = network;
+    queue->host_busy = calloc(network->count, sizeof(int));
+    if (!queue->host_busy) return -1;
+
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->wake, NULL);
+    queue->running = 1;
+
+    for (int i = 0; i < ACTION_QUEUE_WORKERS; i++) {
+        if (pthread_create(&queue->workers[i], NULL, action_queue_worker, queue) != 0) break;
+        queue->worker_count++;
+    }
+
+    if (queue->worker_count == 0) {
+        action_queue_stop(queue);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Arrête les threads et libère la file
+ *
+ * Les lots en cours se terminent (bornés par l'échéance de leur hôte),
+ * les actions encore en attente sont abandonnées.
+ */
+void action_queue_stop(action_queue_t *queue) {
+    if (!queue || !queue->host_busy) return;
+
+    pthread_mutex_lock(&queue->lock);
+    queue->running = 0;
+    pthread_cond_broadcast(&queue->wake);
+    pthread_mutex_unlock(&queue->lock);
+
+    for (int i = 0; i < queue->worker_count; i++) {
+        pthread_join(queue->workers[i], NULL);
+    }
+
+    free(queue->pending);
+    free(queue->done);
+    free(queue->host_busy);
+    queue->pending = NULL;
+    queue->done = NULL;
+    queue->host_busy = NULL;
+    queue->pending_count = 0;
+    queue->done_count = 0;
+    queue->worker_count = 0;
+
+    pthread_cond_destroy(&queue->wake);
+    pthread_mutex_destroy(&queue->lock);
+}
+
+/**
+ * @brief Dépose une action dans la file
+ *
+ * @param queue La file
+ * @param host Index de l'hôte
+ * @param pid PID visé
+ * @param action Action à appliquer
+ * @return 0 en cas de succès, -1 si les paramètres sont invalides ou en cas d'erreur d'allocation
+ */
+int action_queue_submit(action_queue_t *queue, int host, int pid, process_action_t action) {
+    if (!queue || !queue->host_busy || host < 0 || host >= queue->network->count || pid <= 0) return -1;
+
+    action_request_t request = { host, pid, action, -1 };
+
+    pthread_mutex_lock(&queue->lock);
+    int result = request_append(&queue->pending, &queue->pending_count, &queue->pending_capacity, &request);
+    pthread_cond_broadcast(&queue->wake);
+    pthread_mutex_unlock(&queue->lock);
+    return result;
+}
+
+/**
+ * @brief Retire le plus ancien résultat d'action disponible
+ *
+ * @param queue La file
+ * @param result Pointeur qui recevra l'action terminée et son résultat
+ * @return 1 si un résultat a été copié, 0 si aucun n'est disponible
+ */
+int action_queue_poll_result(action_queue_t *queue, action_request_t *result) {
+    if (!queue || !queue->host_busy) return 0;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->done_count == 0) {
+        pthread_mutex_unlock(&queue->lock);
+        return 0;
+    }
+    *result = queue->done[0];
+    queue->done_count--;
+    memmove(queue->done, queue->done + 1, sizeof(action_request_t) * queue->done_count);
+    pthread_mutex_unlock(&queue->lock);
+    return 1;
+}
@@ -0,0 +1,725 @@
+#include "agent.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+// Charge utile d'une trame :
+//   delta uniquement : séquence de base (varint), jamais compressée
+//   corps, éventuellement compressé (taille décompressée en varint puis flux zlib) :
+//     uptime_ds (varint)
+//     keyframe : nombre (varint) puis enregistrements complets
+//     delta    : supprimés (nombre, écarts de PID), ajoutés (nombre, enregistrements
+//                complets), modifiés (nombre, puis écart de PID, masque, champs changés)
+// Les PID de chaque liste sont croissants et codés en écart avec le précédent.
+// Enregistrement complet : écart PID, ppid, cpu (centièmes de %), mémoire kB,
+// démarrage (dixièmes de s d'uptime), état (1), noyau (1), longueur du nom, nom.
+// Le nom n'est envoyé qu'à l'apparition d'un processus (ou s'il change).
+
+// Masque des champs d'un enregistrement modifié
+#define AGENT_CHANGED_PPID   0x01  // varint
+#define AGENT_CHANGED_CPU    0x02  // zigzag varint, différence avec la base
+#define AGENT_CHANGED_MEMORY 0x04  // zigzag varint, différence avec la base
+#define AGENT_CHANGED_START  0x08  // varint
+#define AGENT_CHANGED_STATE  0x10  // octet
+#define AGENT_CHANGED_KERNEL 0x20  // octet
+
+static void put_u32(unsigned char *p, unsigned int value) {
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = (value >> 24) & 0xFF;
+}
+
+static unsigned int get_u32(const unsigned char *p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8) |
+           ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+// Buffer d'écriture agrandi à la demande
+typedef struct {
+    unsigned char *data;
+    size_t len;
+    size_t capacity;
+    int failed;  // Erreur d'allocation (les écritures suivantes sont ignorées)
+} agent_buffer_t;
+
+static void buffer_reserve(agent_buffer_t *buffer, size_t extra) {
+    if (buffer->failed || buffer->len + extra <= buffer->capacity) return;
+
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (capacity < buffer->len + extra) capacity *= 2;
+    unsigned char *tmp = realloc(buffer->data, capacity);
+    if (!tmp) {
+        buffer->failed = 1;
+        return;
+    }
+    buffer->data = tmp;
+    buffer->capacity = capacity;
+}
+
+static void buffer_put(agent_buffer_t *buffer, const void *data, size_t len) {
+    buffer_reserve(buffer, len);
+    if (buffer->failed) return;
+    memcpy(buffer->data + buffer->len, data, len);
+    buffer->len += len;
+}
+
+static void buffer_put_byte(agent_buffer_t *buffer, unsigned char value) {
+    buffer_put(buffer, &value, 1);
+}
+
+static void buffer_put_varint(agent_buffer_t *buffer, unsigned long long value) {
+    unsigned char bytes[10];
+    size_t n = 0;
+    do {
+        bytes[n] = value & 0x7F;
+        value >>= 7;
+        if (value) bytes[n] |= 0x80;
+        n++;
+    } while (value);
+    buffer_put(buffer, bytes, n);
+}
+
+static void buffer_put_zigzag(agent_buffer_t *buffer, long long value) {
+    buffer_put_varint(buffer, ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63));
+}
+
+// Curseur de lecture borné
+typedef struct {
+    const unsigned char *p;
+    const unsigned char *end;
+    int failed;  // Lecture au-delà de la fin
+} agent_reader_t;
+
+static unsigned long long reader_varint(agent_reader_t *reader) {
+    unsigned long long value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (reader->p >= reader->end) break;
+        unsigned char byte = *reader->p++;
+        value |= (unsigned long long)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    reader->failed = 1;
+    return 0;
+}
+
+static long long reader_zigzag(agent_reader_t *reader) {
+    unsigned long long value = reader_varint(reader);
+    return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+static unsigned char reader_byte(agent_reader_t *reader) {
+    if (reader->p >= reader->end) {
+        reader->failed = 1;
+        return 0;
+    }
+    return *reader->p++;
+}
+
+// Valeurs transmises d'un processus (virgule fixe)
+static unsigned int record_cpu(const process_info_t *proc) {
+    return proc->cpu_percent > 0.0f ? (unsigned int)(proc->cpu_percent * 100.0f + 0.5f) : 0;
+}
+
+static unsigned int record_memory(const process_info_t *proc) {
+    return proc->memory_kb > 0 ? (unsigned int)proc->memory_kb : 0;
+}
+
+static unsigned int record_start(const process_info_t *proc, unsigned int uptime_ds) {
+    unsigned int elapsed = proc->time > 0.0f ? (unsigned int)(proc->time * 10.0f + 0.5f) : 0;
+    return elapsed < uptime_ds ? uptime_ds - elapsed : 0;
+}
+
+static int compare_pid(const void *a, const void *b) {
+    int pid_a = ((const process_info_t *)a)->pid;
+    int pid_b = ((const process_info_t *)b)->pid;
+    return (pid_a > pid_b) - (pid_a < pid_b);
+}
+
+void agent_snapshot_sort(agent_snapshot_t *snapshot) {
+    qsort(snapshot->list, snapshot->count, sizeof(process_info_t), compare_pid);
+}
+
+void agent_snapshot_free(agent_snapshot_t *snapshot) {
+    free(snapshot->list);
+    snapshot->list = NULL;
+    snapshot->count = 0;
+}
+
+/**
+ * @brief Écrit un enregistrement complet (apparition d'un processus)
+ */
+static void put_full_record(agent_buffer_t *buffer, const process_info_t *proc, int previous_pid,
+                            unsigned int uptime_ds) {
+    size_t name_len = strnlen(proc->name, 255);
+    buffer_put_varint(buffer, (unsigned int)(proc->pid - previous_pid));
+    buffer_put_varint(buffer, (unsigned int)(proc->ppid > 0 ? proc->ppid : 0));
+    buffer_put_varint(buffer, record_cpu(proc));
+    buffer_put_varint(buffer, record_memory(proc));
+    buffer_put_varint(buffer, record_start(proc, uptime_ds));
+    buffer_put_byte(buffer, (unsigned char)proc->state);
+    buffer_put_byte(buffer, proc->is_kernel ? 1 : 0);
+    buffer_put_varint(buffer, name_len);
+    buffer_put(buffer, proc->name, name_len);
+}
+
+/**
+ * @brief Lit un enregistrement complet
+ *
+ * @return 0 en cas de succès, -1 si l'enregistrement est tronqué
+ */
+static int read_full_record(agent_reader_t *reader, process_info_t *proc, int previous_pid,
+                            unsigned int uptime_ds) {
+    memset(proc, 0, sizeof(process_info_t));
+    proc->pid = previous_pid + (int)reader_varint(reader);
+    proc->ppid = (int)reader_varint(reader);
+    proc->cpu_percent = reader_varint(reader) / 100.0f;
+    proc->memory_kb = (int)reader_varint(reader);
+    unsigned int start = (unsigned int)reader_varint(reader);
+    proc->time = start < uptime_ds ? (uptime_ds - start) / 10.0f : 0.0f;
+    proc->state = (char)reader_byte(reader);
+    proc->is_kernel = reader_byte(reader);
+
+    unsigned long long name_len = reader_varint(reader);
+    if (reader->failed || name_len > 255 || name_len > (unsigned long long)(reader->end - reader->p)) return -1;
+    memcpy(proc->name, reader->p, name_len);
+    proc->name[name_len] = '\0';
+    reader->p += name_len;
+    return 0;
+}
+
+/**
+ * @brief Écrit le corps d'un delta : différences entre base et current (triés par PID)
+ */
+static void put_delta_body(agent_buffer_t *body, const agent_snapshot_t *current, const agent_snapshot_t *base) {
+    agent_buffer_t removed = {0}, added = {0}, changed = {0};
+    int removed_count = 0, added_count = 0, changed_count = 0;
+    int removed_pid = 0, added_pid = 0, changed_pid = 0;
+
+    int i = 0, j = 0;
+    while (i < current->count || j < base->count) {
+        const process_info_t *now = (i < current->count) ? &current->list[i] : NULL;
+        const process_info_t *old = (j < base->count) ? &base->list[j] : NULL;
+
+        if (old && (!now || old->pid < now->pid)) {
+            buffer_put_varint(&removed, (unsigned int)(old->pid - removed_pid));
+            removed_pid = old->pid;
+            removed_count++;
+            j++;
+            continue;
+        }
+        if (!old || now->pid < old->pid || strcmp(now->name, old->name) != 0) {
+            // PID réutilisé par un autre programme : suppression puis ajout
+            if (old && now->pid == old->pid) {
+                buffer_put_varint(&removed, (unsigned int)(old->pid - removed_pid));
+                removed_pid = old->pid;
+                removed_count++;
+                j++;
+            }
+            put_full_record(&added, now, added_pid, current->uptime_ds);
+            added_pid = now->pid;
+            added_count++;
+            i++;
+            continue;
+        }
+
+        // Même processus : seuls les champs modifiés sont envoyés
+        unsigned int start_now = record_start(now, current->uptime_ds);
+        unsigned int start_old = record_start(old, base->uptime_ds);
+        long long start_diff = (long long)start_now - start_old;
+
+        unsigned char mask = 0;
+        if (now->ppid != old->ppid) mask |= AGENT_CHANGED_PPID;
+        if (record_cpu(now) != record_cpu(old)) mask |= AGENT_CHANGED_CPU;
+        if (record_memory(now) != record_memory(old)) mask |= AGENT_CHANGED_MEMORY;
+        if (start_diff > 1 || start_diff < -1) mask |= AGENT_CHANGED_START;  // Arrondi ignoré
+        if (now->state != old->state) mask |= AGENT_CHANGED_STATE;
+        if ((now->is_kernel != 0) != (old->is_kernel != 0)) mask |= AGENT_CHANGED_KERNEL;
+
+        if (mask) {
+            buffer_put_varint(&changed, (unsigned int)(now->pid - changed_pid));
+            buffer_put_byte(&changed, mask);
+            if (mask & AGENT_CHANGED_PPID) buffer_put_varint(&changed, (unsigned int)(now->ppid > 0 ? now->ppid : 0));
+            if (mask & AGENT_CHANGED_CPU) buffer_put_zigzag(&changed, (long long)record_cpu(now) - record_cpu(old));
+            if (mask & AGENT_CHANGED_MEMORY) buffer_put_zigzag(&changed, (long long)record_memory(now) - record_memory(old));
+            if (mask & AGENT_CHANGED_START) buffer_put_varint(&changed, start_now);
+            if (mask & AGENT_CHANGED_STATE) buffer_put_byte(&changed, (unsigned char)now->state);
+            if (mask & AGENT_CHANGED_KERNEL) buffer_put_byte(&changed, now->is_kernel ? 1 : 0);
+            changed_pid = now->pid;
+            changed_count++;
+        }
+        i++;
+        j++;
+    }
+
+    buffer_put_varint(body, removed_count);
+    buffer_put(body, removed.data, removed.len);
+    buffer_put_varint(body, added_count);
+    buffer_put(body, added.data, added.len);
+    buffer_put_varint(body, changed_count);
+    buffer_put(body, changed.data, changed.len);
+    if (removed.failed || added.failed || changed.failed) body->failed = 1;
+
+    free(removed.data);
+    free(added.data);
+    free(changed.data);
+}
+
+/**
+ * @brief Encode un instantané dans une trame
+ *
+ * Sans base, la trame est une keyframe (instantané complet). Avec une
+ * base, seules les lignes supprimées, ajoutées et modifiées sont écrites,
+ * les nombres en varint et les variations en zigzag.
+ *
+ * @param current Instantané à envoyer (trié par PID)
+ * @param base Instantané de référence déjà acquitté (trié par PID), ou NULL
+ * @param compress Compresser le corps avec zlib si disponible
+ * @param frame Pointeur qui recevra la trame allouée
+ * @param frame_len Pointeur qui recevra la taille de la trame
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int agent_encode_frame(const agent_snapshot_t *current, const agent_snapshot_t *base, int compress,
+                       unsigned char **frame, size_t *frame_len) {
+    agent_buffer_t body = {0};
+    buffer_put_varint(&body, current->uptime_ds);
+
+    if (base) {
+        put_delta_body(&body, current, base);
+    } else {
+        buffer_put_varint(&body, (unsigned int)current->count);
+        int previous_pid = 0;
+        for (int i = 0; i < current->count; i++) {
+            put_full_record(&body, &current->list[i], previous_pid, current->uptime_ds);
+            previous_pid = current->list[i].pid;
+        }
+    }
+    if (body.failed) {
+        free(body.data);
+        return -1;
+    }
+
+    agent_buffer_t out = {0};
+    buffer_reserve(&out, AGENT_HEADER_SIZE);
+    out.len = AGENT_HEADER_SIZE;
+    if (base) buffer_put_varint(&out, base->sequence);
+
+    unsigned char flags = 0;
+#ifdef HAVE_ZLIB
+    if (compress) {
+        uLongf packed_len = compressBound(body.len);
+        buffer_put_varint(&out, body.len);
+        buffer_reserve(&out, packed_len);
+        if (!out.failed && compress2(out.data + out.len, &packed_len, body.data, body.len, Z_BEST_SPEED) == Z_OK) {
+            out.len += packed_len;
+            flags |= AGENT_FLAG_ZLIB;
+        } else {
+            out.failed = 1;
+        }
+    }
+#else
+    (void)compress;
+#endif
+    if (!(flags & AGENT_FLAG_ZLIB)) buffer_put(&out, body.data, body.len);
+    free(body.data);
+
+    size_t payload = out.len - AGENT_HEADER_SIZE;
+    if (out.failed || payload > AGENT_MAX_PAYLOAD) {
+        free(out.data);
+        return -1;
+    }
+
+    memcpy(out.data, AGENT_MAGIC, 4);
+    out.data[4] = AGENT_PROTOCOL_VERSION;
+    out.data[5] = base ? AGENT_FRAME_DELTA : AGENT_FRAME_KEYFRAME;
+    out.data[6] = flags;
+    out.data[7] = 0;
+    put_u32(out.data + 8, current->sequence);
+    put_u32(out.data + 12, (unsigned int)payload);
+
+    *frame = out.data;
+    *frame_len = out.len;
+    return 0;
+}
+
+/**
+ * @brief Détermine si une trame complète est disponible en tête d'un buffer
+ *
+ * @param buffer Données reçues
+ * @param len Nombre d'octets reçus
+ * @return Taille de la trame, 0 si elle n'est pas encore complète, -1 si l'en-tête est invalide
+ */
+long agent_frame_length(const unsigned char *buffer, size_t len) {
+    if (len < AGENT_HEADER_SIZE) return 0;
+    if (memcmp(buffer, AGENT_MAGIC, 4) != 0) return -1;
+    if (buffer[4] != AGENT_PROTOCOL_VERSION) return -1;
+
+    unsigned int payload = get_u32(buffer + 12);
+    if (payload > AGENT_MAX_PAYLOAD) return -1;
+
+    size_t total = AGENT_HEADER_SIZE + (size_t)payload;
+    return (len < total) ? 0 : (long)total;
+}
+
+/**
+ * @brief Lit la séquence de l'instantané de base d'une trame delta
+ *
+ * @return Séquence de base, 0 pour une keyframe, -1 si la trame est invalide
+ */
+long agent_frame_base(const unsigned char *frame, size_t frame_len) {
+    if (agent_frame_length(frame, frame_len) <= 0) return -1;
+    if (frame[5] == AGENT_FRAME_KEYFRAME) return 0;
+    if (frame[5] != AGENT_FRAME_DELTA) return -1;
+
+    agent_reader_t reader = { frame + AGENT_HEADER_SIZE, frame + frame_len, 0 };
+    unsigned long long base = reader_varint(&reader);
+    return (reader.failed || base > 0xFFFFFFFFull) ? -1 : (long)base;
+}
+
+/**
+ * @brief Applique le corps d'un delta à une copie de la base
+ *
+ * @return 0 en cas de succès, -1 si le corps est invalide
+ */
+static int read_delta_body(agent_reader_t *reader, const agent_snapshot_t *base, agent_snapshot_t *snapshot) {
+    unsigned long long removed_count = reader_varint(reader);
+    if (reader->failed || removed_count > (unsigned long long)base->count) return -1;
+
+    char *dead = calloc(base->count > 0 ? base->count : 1, 1);
+    if (!dead) return -1;
+
+    int pid = 0;
+    int found = 0;
+    for (unsigned long long i = 0; i < removed_count && !reader->failed; i++) {
+        pid += (int)reader_varint(reader);
+        process_info_t key = { .pid = pid };
+        process_info_t *hit = bsearch(&key, base->list, base->count, sizeof(process_info_t), compare_pid);
+        if (hit) {
+            dead[hit - base->list] = 1;
+            found++;
+        }
+    }
+
+    unsigned long long added_count = reader_varint(reader);
+    // Un enregistrement complet fait au moins 8 octets
+    if (reader->failed || added_count > (unsigned long long)(reader->end - reader->p) / 8) {
+        free(dead);
+        return -1;
+    }
+
+    int capacity = base->count - found + (int)added_count;
+    snapshot->list = malloc(sizeof(process_info_t) * (capacity > 0 ? capacity : 1));
+    if (!snapshot->list) {
+        free(dead);
+        return -1;
+    }
+
+    int count = 0;
+    for (int i = 0; i < base->count; i++) {
+        if (!dead[i]) snapshot->list[count++] = base->list[i];
+    }
+    free(dead);
+
+    // Le temps écoulé des processus inchangés avance avec l'uptime
+    float elapsed = (snapshot->uptime_ds > base->uptime_ds) ? (snapshot->uptime_ds - base->uptime_ds) / 10.0f : 0.0f;
+    for (int i = 0; i < count; i++) snapshot->list[i].time += elapsed;
+
+    // Ajoutés, décodés à la suite des survivants ; les modifiés sont ensuite
+    // cherchés parmi les seuls survivants (kept premiers), encore triés
+    int kept = count;
+    pid = 0;
+    int previous_added = 0;
+    for (unsigned long long i = 0; i < added_count && !reader->failed; i++) {
+        if (read_full_record(reader, &snapshot->list[count], previous_added, snapshot->uptime_ds) != 0) break;
+        previous_added = snapshot->list[count].pid;
+        count++;
+    }
+
+    unsigned long long changed_count = reader_varint(reader);
+    for (unsigned long long i = 0; i < changed_count && !reader->failed; i++) {
+        pid += (int)reader_varint(reader);
+        unsigned char mask = reader_byte(reader);
+
+        process_info_t key = { .pid = pid };
+        process_info_t *proc = bsearch(&key, snapshot->list, kept, sizeof(process_info_t), compare_pid);
+        process_info_t ignored;
+        if (!proc) {
+            memset(&ignored, 0, sizeof(ignored));
+            proc = &ignored;
+        }
+
+        if (mask & AGENT_CHANGED_PPID) proc->ppid = (int)reader_varint(reader);
+        if (mask & AGENT_CHANGED_CPU) {
+            long long cpu = (long long)record_cpu(proc) + reader_zigzag(reader);
+            proc->cpu_percent = cpu > 0 ? cpu / 100.0f : 0.0f;
+        }
+        if (mask & AGENT_CHANGED_MEMORY) {
+            long long memory = (long long)record_memory(proc) + reader_zigzag(reader);
+            proc->memory_kb = memory > 0 ? (int)memory : 0;
+        }
+        if (mask & AGENT_CHANGED_START) {
+            unsigned int start = (unsigned int)reader_varint(reader);
+            proc->time = start < snapshot->uptime_ds ? (snapshot->uptime_ds - start) / 10.0f : 0.0f;
+        }
+        if (mask & AGENT_CHANGED_STATE) proc->state = (char)reader_byte(reader);
+        if (mask & AGENT_CHANGED_KERNEL) proc->is_kernel = reader_byte(reader);
+    }
+
+    if (reader->failed) {
+        agent_snapshot_free(snapshot);
+        return -1;
+    }
+
+    snapshot->count = count;
+    agent_snapshot_sort(snapshot);
+    return 0;
+}
+
+/**
+ * @brief Décode une trame en instantané
+ *
+ * @param frame Trame complète (voir agent_frame_length())
+ * @param frame_len Taille de la trame
+ * @param base Instantané de base pour une trame delta (séquence donnée par agent_frame_base()), NULL pour une keyframe
+ * @param snapshot Instantané décodé (liste allouée, triée par PID)
+ * @return 0 en cas de succès, -1 si la trame est invalide ou la base ne correspond pas
+ */
+int agent_decode_frame(const unsigned char *frame, size_t frame_len, const agent_snapshot_t *base,
+                       agent_snapshot_t *snapshot) {
+    long base_sequence = agent_frame_base(frame, frame_len);
+    if (base_sequence < 0) return -1;
+
+    int is_delta = (frame[5] == AGENT_FRAME_DELTA);
+    if (is_delta && (!base || base->sequence != (unsigned int)base_sequence)) return -1;
+
+    agent_reader_t reader = { frame + AGENT_HEADER_SIZE, frame + frame_len, 0 };
+    if (is_delta) reader_varint(&reader);
+
+    unsigned char *unpacked = NULL;
+    if (frame[6] & AGENT_FLAG_ZLIB) {
+#ifdef HAVE_ZLIB
+        unsigned long long raw_len = reader_varint(&reader);
+        if (reader.failed || raw_len > AGENT_MAX_PAYLOAD) return -1;
+        unpacked = malloc(raw_len > 0 ? raw_len : 1);
+        if (!unpacked) return -1;
+        uLongf unpacked_len = (uLongf)raw_len;
+        if (uncompress(unpacked, &unpacked_len, reader.p, (uLong)(reader.end - reader.p)) != Z_OK ||
+            unpacked_len != raw_len) {
+            free(unpacked);
+            return -1;
+        }
+        reader.p = unpacked;
+        reader.end = unpacked + unpacked_len;
+#else
+        return -1;
+#endif
+    }
+
+    memset(snapshot, 0, sizeof(agent_snapshot_t));
+    snapshot->sequence = get_u32(frame + 8);
+    snapshot->uptime_ds = (unsigned int)reader_varint(&reader);
+
+    int result = 0;
+    if (is_delta) {
+        result = read_delta_body(&reader, base, snapshot);
+    } else {
+        unsigned long long n = reader_varint(&reader);
+        if (reader.failed || n > (unsigned long long)(reader.end - reader.p) / 8) {
+            result = -1;
+        } else {
+            snapshot->list = malloc(sizeof(process_info_t) * (n > 0 ? n : 1));
+            if (!snapshot->list) result = -1;
+            int previous_pid = 0;
+            for (unsigned long long i = 0; result == 0 && i < n; i++) {
+                if (read_full_record(&reader, &snapshot->list[i], previous_pid, snapshot->uptime_ds) != 0) {
+                    result = -1;
+                    break;
+                }
+                previous_pid = snapshot->list[i].pid;
+            }
+            if (result == 0) {
+                snapshot->count = (int)n;
+            } else {
+                agent_snapshot_free(snapshot);
+            }
+        }
+    }
+
+    free(unpacked);
+    return result;
+}
+
+/**
+ * @brief Écrit entièrement un buffer sur un descripteur
+ *
+ * @return 0 en cas de succès, -1 si le descripteur est fermé ou en erreur
+ */
+static int write_all(int fd, const unsigned char *buffer, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buffer, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buffer += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// État de l'agent : instantanés envoyés récemment et acquittements reçus
+typedef struct {
+    agent_snapshot_t history[AGENT_HISTORY_SIZE];  // Anneau, indexé par séquence
+    unsigned int acked;                            // Dernière séquence acquittée (0 = aucune)
+    int force_keyframe;
+    unsigned char message[AGENT_MESSAGE_SIZE];     // Message partiel reçu sur stdin
+    size_t message_len;
+} agent_state_t;
+
+/**
+ * @brief Traite les messages reçus du visualiseur
+ */
+static void agent_handle_input(agent_state_t *state, const unsigned char *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        state->message[state->message_len++] = data[i];
+        if (state->message_len < AGENT_MESSAGE_SIZE) continue;
+        state->message_len = 0;
+
+        unsigned int sequence = get_u32(state->message + 1);
+        if (state->message[0] == AGENT_MESSAGE_ACK) {
+            if (sequence > state->acked) state->acked = sequence;
+        } else if (state->message[0] == AGENT_MESSAGE_KEYFRAME) {
+            state->force_keyframe = 1;
+        }
+    }
+}
+
+static long long agent_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Attend la fin de l'intervalle en lisant les messages de stdin
+ *
+ * Les acquittements reçus pendant l'attente sont traités sans l'écourter :
+ * le rythme des trames ne dépend pas de celui du visualiseur. Seule une
+ * demande de keyframe y met fin aussitôt. Le visualiseur garde stdin
+ * ouvert tant qu'il lit les instantanés : sa fermeture (fin de session
+ * SSH) arrête l'agent.
+ *
+ * @param interval_ms Durée d'attente en millisecondes
+ * @return 0 pour continuer, -1 si stdin a été fermé
+ */
+static int wait_interval(agent_state_t *state, int interval_ms) {
+    long long deadline = agent_now_ms() + interval_ms;
+    for (;;) {
+        long long remaining = deadline - agent_now_ms();
+        if (remaining <= 0 || state->force_keyframe) return 0;
+
+        struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN, .revents = 0 };
+        int ready = poll(&pfd, 1, (int)remaining);
+        if (ready < 0 && errno != EINTR) return 0;
+        if (ready <= 0) continue;
+
+        unsigned char buffer[256];
+        ssize_t n = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (n > 0) {
+            agent_handle_input(state, buffer, (size_t)n);
+        } else if (!(n < 0 && errno == EINTR)) {
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief Lit l'uptime de l'hôte en dixièmes de seconde
+ */
+static unsigned int read_uptime_ds(void) {
+    double uptime = 0.0;
+    FILE *f = fopen("/proc/uptime", "r");
+    if (f) {
+        if (fscanf(f, "%lf", &uptime) != 1) uptime = 0.0;
+        fclose(f);
+    }
+    return (unsigned int)(uptime * 10.0);
+}
+
+/**
+ * @brief Boucle principale de l'agent distant
+ *
+ * Collecte la liste des processus avec get_process_list() à intervalle fixe
+ * et l'écrit sur stdout sous forme de trames binaires : une keyframe au
+ * départ, toutes les AGENT_KEYFRAME_INTERVAL trames ou à la demande du
+ * visualiseur, sinon un delta par rapport au dernier instantané acquitté.
+ * Un premier échantillon est pris avant la première trame pour que les
+ * pourcentages CPU soient déjà significatifs.
+ *
+ * @param interval_ms Intervalle entre deux instantanés en millisecondes
+ * @param compress Compresser les trames avec zlib (ignoré sans zlib)
+ * @return 0 à la fermeture normale du flux, 1 en cas d'erreur
+ */
+int agent_run(int interval_ms, int compress) {
+    if (interval_ms < 100) interval_ms = 100;
+    signal(SIGPIPE, SIG_IGN);
+
+    agent_state_t state;
+    memset(&state, 0, sizeof(state));
+
+    process_info_t *list = NULL;
+    int count = 0;
+
+    // Échantillon initial pour le calcul du CPU
+    if (get_process_list(&list, &count) == 0) free(list);
+    if (wait_interval(&state, interval_ms < 250 ? interval_ms : 250) != 0) return 0;
+
+    int exit_code = 0;
+    unsigned int since_keyframe = 0;
+    for (unsigned int sequence = 1; ; sequence++) {
+        agent_snapshot_t *current = &state.history[sequence % AGENT_HISTORY_SIZE];
+        agent_snapshot_free(current);
+        if (get_process_list(&current->list, &current->count) != 0) {
+            exit_code = 1;
+            break;
+        }
+        current->sequence = sequence;
+        current->uptime_ds = read_uptime_ds();
+        agent_snapshot_sort(current);
+
+        // Base : dernier instantané acquitté, s'il est encore dans l'historique
+        const agent_snapshot_t *base = NULL;
+        if (state.acked > 0 && !state.force_keyframe && since_keyframe < AGENT_KEYFRAME_INTERVAL) {
+            const agent_snapshot_t *candidate = &state.history[state.acked % AGENT_HISTORY_SIZE];
+            if (candidate->sequence == state.acked && candidate->list && state.acked != sequence) {
+                base = candidate;
+            }
+        }
+
+        unsigned char *frame = NULL;
+        size_t frame_len = 0;
+        if (agent_encode_frame(current, base, compress, &frame, &frame_len) != 0) {
+            exit_code = 1;
+            break;
+        }
+        since_keyframe = base ? since_keyframe + 1 : 0;
+        state.force_keyframe = 0;
+
+        int written = write_all(STDOUT_FILENO, frame, frame_len);
+        free(frame);
+        if (written != 0) break;
+
+        if (wait_interval(&state, interval_ms) != 0) break;
+    }
+
+    for (int i = 0; i < AGENT_HISTORY_SIZE; i++) agent_snapshot_free(&state.history[i]);
+    return exit_code;
+}
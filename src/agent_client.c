@@ -0,0 +1,305 @@
+#include "agent_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "arena.h"
+#include "agent.h"
+#include "ssh_pool.h"
+#include "filter.h"
+
+// Flux vers l'agent d'un hôte et derniers instantanés décodés
+typedef struct {
+    char address[128];
+    int port;
+    char username[64];
+    ssh_stream_t *stream;
+    unsigned char *rx;       // Octets reçus pas encore décodés
+    size_t rx_len;
+    size_t rx_capacity;
+    agent_snapshot_t history[AGENT_HISTORY_SIZE];  // Instantanés décodés, indexés par séquence (bases des deltas)
+    agent_snapshot_t *latest;                      // Dernier instantané appliqué
+    unsigned int acked;      // Dernière séquence acquittée auprès de l'agent
+    int has_snapshot;
+    pthread_mutex_t lock;    // Une seule collecte à la fois par session
+} agent_session_t;
+
+static agent_session_t **sessions = NULL;
+static int session_count = 0;
+static int session_capacity = 0;
+static pthread_mutex_t sessions_lock = PTHREAD_MUTEX_INITIALIZER;  // Protège le tableau des sessions
+
+/**
+ * @brief Recherche la session agent d'un hôte (sous sessions_lock)
+ */
+static agent_session_t *session_find(const host_config_t *host) {
+    for (int i = 0; i < session_count; i++) {
+        if (sessions[i]->port == host->port &&
+            strcmp(sessions[i]->address, host->address) == 0 &&
+            strcmp(sessions[i]->username, host->username) == 0) {
+            return sessions[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Recherche ou crée la session agent d'un hôte, puis la verrouille
+ *
+ * @param host Configuration de l'hôte
+ * @return Pointeur vers la session verrouillée, ou NULL en cas d'erreur d'allocation
+ */
+static agent_session_t *session_acquire(const host_config_t *host) {
+    pthread_mutex_lock(&sessions_lock);
+    agent_session_t *session = session_find(host);
+
+    if (!session) {
+        if (session_count >= session_capacity) {
+            int capacity = session_capacity ? session_capacity * 2 : 8;
+            agent_session_t **tmp = realloc(sessions, sizeof(agent_session_t *) * capacity);
+            if (!tmp) {
+                pthread_mutex_unlock(&sessions_lock);
+                return NULL;
+            }
+            sessions = tmp;
+            session_capacity = capacity;
+        }
+
+        session = calloc(1, sizeof(agent_session_t));
+        if (!session) {
+            pthread_mutex_unlock(&sessions_lock);
+            return NULL;
+        }
+
+        snprintf(session->address, sizeof(session->address), "%s", host->address);
+        snprintf(session->username, sizeof(session->username), "%s", host->username);
+        session->port = host->port;
+        pthread_mutex_init(&session->lock, NULL);
+
+        sessions[session_count++] = session;
+    }
+    pthread_mutex_unlock(&sessions_lock);
+
+    pthread_mutex_lock(&session->lock);
+    return session;
+}
+
+/**
+ * @brief Ferme le flux d'une session (rouvert au prochain appel)
+ */
+static void session_close(agent_session_t *session) {
+    if (session->stream) {
+        ssh_stream_close(session->stream);
+        session->stream = NULL;
+    }
+    session->rx_len = 0;
+
+    // Un nouvel agent repart d'une keyframe, avec ses propres séquences
+    for (int i = 0; i < AGENT_HISTORY_SIZE; i++) agent_snapshot_free(&session->history[i]);
+    session->latest = NULL;
+    session->acked = 0;
+    session->has_snapshot = 0;
+}
+
+/**
+ * @brief Envoie un message de contrôle à l'agent (acquittement ou demande de keyframe)
+ *
+ * @return 0 en cas de succès, -1 si le flux est fermé
+ */
+static int session_send(agent_session_t *session, unsigned char type, unsigned int sequence) {
+    unsigned char message[AGENT_MESSAGE_SIZE] = {
+        type, sequence & 0xFF, (sequence >> 8) & 0xFF, (sequence >> 16) & 0xFF, (sequence >> 24) & 0xFF
+    };
+    return ssh_stream_write(session->stream, message, AGENT_MESSAGE_SIZE) == AGENT_MESSAGE_SIZE ? 0 : -1;
+}
+
+/**
+ * @brief Retrouve un instantané décodé par sa séquence
+ */
+static const agent_snapshot_t *session_snapshot(agent_session_t *session, unsigned int sequence) {
+    agent_snapshot_t *snapshot = &session->history[sequence % AGENT_HISTORY_SIZE];
+    return (snapshot->list && snapshot->sequence == sequence) ? snapshot : NULL;
+}
+
+/**
+ * @brief Décode toutes les trames complètes reçues
+ *
+ * Chaque delta est appliqué à l'instantané de base qu'il désigne. Si
+ * cette base n'est plus dans l'historique, la trame est ignorée et une
+ * keyframe est demandée à l'agent.
+ *
+ * @return 0 en cas de succès, -1 si le flux est désynchronisé
+ */
+static int session_consume_frames(agent_session_t *session) {
+    size_t offset = 0;
+
+    for (;;) {
+        const unsigned char *frame = session->rx + offset;
+        long frame_len = agent_frame_length(frame, session->rx_len - offset);
+        if (frame_len == 0) break;
+        if (frame_len < 0) return -1;
+        offset += (size_t)frame_len;
+
+        long base_sequence = agent_frame_base(frame, (size_t)frame_len);
+        if (base_sequence < 0) return -1;
+
+        const agent_snapshot_t *base = NULL;
+        if (base_sequence > 0) {
+            base = session_snapshot(session, (unsigned int)base_sequence);
+            if (!base) {
+                if (session_send(session, AGENT_MESSAGE_KEYFRAME, (unsigned int)base_sequence) != 0) return -1;
+                continue;
+            }
+        }
+
+        agent_snapshot_t snapshot;
+        if (agent_decode_frame(frame, (size_t)frame_len, base, &snapshot) != 0) return -1;
+
+        agent_snapshot_t *slot = &session->history[snapshot.sequence % AGENT_HISTORY_SIZE];
+        agent_snapshot_free(slot);
+        *slot = snapshot;
+        session->latest = slot;
+        session->has_snapshot = 1;
+    }
+
+    if (offset > 0) {
+        memmove(session->rx, session->rx + offset, session->rx_len - offset);
+        session->rx_len -= offset;
+    }
+    return 0;
+}
+
+/**
+ * @brief Lit les données disponibles sur le flux de l'agent
+ *
+ * Sans instantané déjà reçu, attend la première trame jusqu'à
+ * AGENT_FIRST_FRAME_TIMEOUT_MS (ou l'échéance du thread si elle est plus
+ * proche) ; sinon lit uniquement ce qui est déjà arrivé, sans bloquer.
+ *
+ * @return 0 en cas de succès, -1 si le flux a été perdu
+ */
+static int session_drain(agent_session_t *session) {
+    long long deadline = network_now_ms() + AGENT_FIRST_FRAME_TIMEOUT_MS;
+    if (network_get_deadline() > 0 && network_get_deadline() < deadline) {
+        deadline = network_get_deadline();
+    }
+
+    for (;;) {
+        if (session->rx_capacity - session->rx_len < 4096) {
+            size_t capacity = session->rx_capacity ? session->rx_capacity * 2 : 16384;
+            unsigned char *tmp = realloc(session->rx, capacity);
+            if (!tmp) return -1;
+            session->rx = tmp;
+            session->rx_capacity = capacity;
+        }
+
+        int wait_ms = 0;
+        if (!session->has_snapshot) {
+            long long remaining = deadline - network_now_ms();
+            if (remaining <= 0) return -1;
+            wait_ms = (int)remaining;
+        }
+
+        int n = ssh_stream_read(session->stream, session->rx + session->rx_len,
+                                (int)(session->rx_capacity - session->rx_len), wait_ms);
+        if (n < 0) return -1;
+        if (n == 0) {
+            if (!session->has_snapshot) return -1;
+
+            // Le dernier instantané appliqué devient la base des prochains deltas
+            if (session->latest->sequence != session->acked) {
+                if (session_send(session, AGENT_MESSAGE_ACK, session->latest->sequence) != 0) return -1;
+                session->acked = session->latest->sequence;
+            }
+            return 0;
+        }
+
+        session->rx_len += (size_t)n;
+        if (session_consume_frames(session) != 0) return -1;
+    }
+}
+
+/**
+ * @brief Récupère le dernier instantané envoyé par l'agent d'un hôte
+ *
+ * Le flux vers l'agent est lancé au premier appel puis gardé ouvert ;
+ * en cas de perte, il est relancé au prochain appel.
+ *
+ * @param host Configuration de l'hôte distant
+ * @param list Pointeur qui recevra une copie de la liste des processus
+ * @param count Pointeur qui recevra le nombre de processus
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int agent_client_fetch(const host_config_t *host, process_info_t **list, int *count) {
+    agent_session_t *session = session_acquire(host);
+    if (!session) return -1;
+
+    int result = -1;
+    if (!session->stream) {
+        // L'agent envoie ses instantanés au rythme de collecte de l'hôte,
+        // filtrés de son côté (les noms d'utilisateur y sont résolus)
+        char command[128 + 4 * FILTER_MAX_LENGTH];
+#ifdef HAVE_ZLIB
+        const char *options = " --compress";
+#else
+        const char *options = "";
+#endif
+        const filter_t *filter = process_get_filter();
+        char *quoted_filter = filter ? network_shell_quote(filter->source) : NULL;
+        snprintf(command, sizeof(command), "%s --interval %d%s%s%s", AGENT_REMOTE_COMMAND,
+                 host->interval_ms > 0 ? host->interval_ms : AGENT_DEFAULT_INTERVAL_MS, options,
+                 quoted_filter ? " --filter " : "", quoted_filter ? quoted_filter : "");
+        free(quoted_filter);
+        session->stream = ssh_stream_open(host->address, host->port, host->username,
+                                          host->password, command);
+    }
+
+    if (session->stream && session_drain(session) == 0) {
+        int n = session->latest->count;
+        *list = snapshot_alloc(sizeof(process_info_t) * (n > 0 ? n : 1));
+        if (*list) {
+            memcpy(*list, session->latest->list, sizeof(process_info_t) * n);
+            *count = n;
+            result = 0;
+        }
+    } else {
+        network_set_error(session->stream ? "agent : flux perdu ou sans instantané"
+                                          : "agent : lancement impossible");
+        session_close(session);
+    }
+
+    pthread_mutex_unlock(&session->lock);
+    return result;
+}
+
+void agent_client_close(const host_config_t *host) {
+    pthread_mutex_lock(&sessions_lock);
+    agent_session_t *session = session_find(host);
+    pthread_mutex_unlock(&sessions_lock);
+
+    if (session) {
+        pthread_mutex_lock(&session->lock);
+        session_close(session);
+        pthread_mutex_unlock(&session->lock);
+    }
+}
+
+/**
+ * @brief Ferme tous les flux vers les agents et libère les sessions
+ *
+ * Les threads de collecte doivent être arrêtés au préalable.
+ */
+void agent_client_cleanup(void) {
+    pthread_mutex_lock(&sessions_lock);
+    for (int i = 0; i < session_count; i++) {
+        session_close(sessions[i]);
+        pthread_mutex_destroy(&sessions[i]->lock);
+        free(sessions[i]->rx);
+        free(sessions[i]);
+    }
+    free(sessions);
+    sessions = NULL;
+    session_count = 0;
+    session_capacity = 0;
+    pthread_mutex_unlock(&sessions_lock);
+}
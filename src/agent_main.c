@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <string.h>
+
+#include "../header/agent.h"
+#include "../header/filter.h"
+
+/** @brief Point d'entrée de l'agent de collecte distant (build sans ncurses)
+*
+* Lancé par le visualiseur sur l'hôte distant à travers un canal SSH, il
+* envoie un instantané binaire de la liste des processus à intervalle fixe
+* sur sa sortie standard (trame complète ou delta, compressée avec -z).
+*
+* @param argc Nombre d'options
+* @param argv Options (-i/--interval MS, -z/--compress, -k/--top-k K, --top-by cpu|mem, -S/--schedstat,
+*                  -F/--filter EXPR)
+* @return 0 à la fermeture du flux, 1 en cas d'erreur
+*/
+int main(int argc, char **argv) {
+    int interval_ms = AGENT_DEFAULT_INTERVAL_MS;
+    int compress = 0;
+    int top_k = 0;
+    process_rank_t top_by = PROCESS_RANK_CPU;
+    static filter_t filter;  // Installé pour toute la durée de l'agent
+
+    struct option long_options[] = {
+        {"interval", required_argument, 0, 'i'},
+        {"compress", no_argument, 0, 'z'},
+        {"top-k", required_argument, 0, 'k'},
+        {"top-by", required_argument, 0, 1},
+        {"schedstat", no_argument, 0, 'S'},
+        {"filter", required_argument, 0, 'F'},
+        {0, 0, 0, 0}
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "i:zk:SF:", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'i':
+                interval_ms = atoi(optarg);
+                break;
+            case 'z':
+                compress = 1;
+                break;
+            case 'k':
+                top_k = atoi(optarg);
+                break;
+            case 1:
+                top_by = (strcmp(optarg, "mem") == 0) ? PROCESS_RANK_MEM : PROCESS_RANK_CPU;
+                break;
+            case 'S':
+                process_set_sampling(PROCESS_SAMPLING_SCHEDSTAT);
+                break;
+            case 'F':
+                if (filter_compile(&filter, optarg) != 0) {
+                    fprintf(stderr, "%s\n", filter.error);
+                    return 1;
+                }
+                process_set_filter(&filter);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-i|--interval MS] [-z|--compress] [-k|--top-k K [--top-by cpu|mem]] [-S|--schedstat] [-F|--filter EXPR]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    process_set_top_k(top_k, top_by);
+    return agent_run(interval_ms, compress);
+}
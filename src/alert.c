@@ -0,0 +1,626 @@
+#define _GNU_SOURCE
+#include "alert.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <float.h>
+
+#define ALERT_SLOT_FREE -1
+#define ALERT_SLOT_DELETED -2
+#define ALERT_INITIAL_SLOTS 64
+
+/**
+ * @brief Lit une valeur avec suffixe optionnel
+ *
+ * Mémoire : K, M ou G (résultat en Ko, Ko sans suffixe). Durée : ms, s,
+ * m ou h (résultat en ms, secondes sans suffixe).
+ *
+ * @return 0 en cas de succès, -1 si la valeur est invalide
+ */
+static int parse_quantity(const char *text, int is_duration, double *value) {
+    char *end;
+    double number = strtod(text, &end);
+    if (end == text || number < 0) return -1;
+
+    double unit = is_duration ? 1000.0 : 1.0;
+    if (is_duration) {
+        if (strcmp(end, "ms") == 0) unit = 1.0;
+        else if (strcmp(end, "m") == 0) unit = 60000.0;
+        else if (strcmp(end, "h") == 0) unit = 3600000.0;
+        else if (*end && strcmp(end, "s") != 0) return -1;
+    } else {
+        switch (toupper((unsigned char)*end)) {
+            case '\0':
+            case 'K': unit = 1.0; break;
+            case 'M': unit = 1024.0; break;
+            case 'G': unit = 1024.0 * 1024.0; break;
+            default: return -1;
+        }
+        if (*end && end[1] && strcasecmp(end + 1, "B") != 0) return -1;
+    }
+
+    *value = number * unit;
+    return 0;
+}
+
+int alert_engine_init(alert_engine_t *engine, const host_config_t *hosts, int host_count) {
+    memset(engine, 0, sizeof(alert_engine_t));
+    engine->host_configs = hosts;
+    engine->host_count = host_count;
+    snprintf(engine->log_file, sizeof(engine->log_file), "%s", ALERTS_DEFAULT_LOG);
+    pthread_mutex_init(&engine->lock, NULL);
+    return 0;
+}
+
+/**
+ * @brief Ajoute une ligne du fichier de règles (règle ou directive log/hook)
+ *
+ * Les lignes vides et les commentaires sont ignorés.
+ *
+ * @return 0 en cas de succès, -1 si la ligne est invalide
+ */
+int alert_engine_add_rule(alert_engine_t *engine, const char *line) {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s", line);
+    buffer[strcspn(buffer, "\r\n#")] = '\0';
+
+    char *start = buffer;
+    while (isspace((unsigned char)*start)) start++;
+    size_t len = strlen(start);
+    while (len > 0 && isspace((unsigned char)start[len - 1])) start[--len] = '\0';
+    if (len == 0) return 0;
+
+    if (strncmp(start, "hook ", 5) == 0) {
+        snprintf(engine->hook, sizeof(engine->hook), "%s", start + 5);
+        return 0;
+    }
+
+    alert_rule_t rule;
+    memset(&rule, 0, sizeof(rule));
+    snprintf(rule.text, sizeof(rule.text), "%.127s", start);
+
+    char *save = NULL;
+    char *tokens[16] = { NULL };
+    int token_count = 0;
+    for (char *token = strtok_r(start, " \t", &save); token && token_count < 16;
+         token = strtok_r(NULL, " \t", &save)) {
+        tokens[token_count++] = token;
+    }
+    if (token_count == 0) return -1;
+
+    int next = 0;
+    if (strcmp(tokens[0], "log") == 0) {
+        if (token_count != 2) return -1;
+        snprintf(engine->log_file, sizeof(engine->log_file), "%s", tokens[1]);
+        return 0;
+    } else if (strcmp(tokens[0], "missing") == 0) {
+        if (token_count < 2) return -1;
+        rule.metric = ALERT_METRIC_MISSING;
+        snprintf(rule.name, sizeof(rule.name), "%s", tokens[1]);
+        next = 2;
+    } else if (strcmp(tokens[0], "cpu") == 0 || strcmp(tokens[0], "mem") == 0) {
+        rule.metric = (tokens[0][0] == 'c') ? ALERT_METRIC_CPU : ALERT_METRIC_MEM;
+        if (token_count < 3 || strcmp(tokens[1], ">") != 0) return -1;
+        if (parse_quantity(tokens[2], 0, &rule.threshold) != 0) return -1;
+        rule.clear = rule.threshold;
+        next = 3;
+    } else {
+        return -1;
+    }
+
+    // Options par paires : for, clear, name, host
+    for (; next + 1 < token_count; next += 2) {
+        const char *key = tokens[next];
+        const char *value = tokens[next + 1];
+        double number;
+        if (strcmp(key, "for") == 0) {
+            if (parse_quantity(value, 1, &number) != 0) return -1;
+            rule.duration_ms = (int)number;
+        } else if (strcmp(key, "clear") == 0 && rule.metric != ALERT_METRIC_MISSING) {
+            if (parse_quantity(value, 0, &number) != 0 || number > rule.threshold) return -1;
+            rule.clear = number;
+        } else if (strcmp(key, "name") == 0 && rule.metric != ALERT_METRIC_MISSING) {
+            snprintf(rule.name, sizeof(rule.name), "%s", value);
+        } else if (strcmp(key, "host") == 0) {
+            snprintf(rule.host, sizeof(rule.host), "%s", value);
+        } else {
+            return -1;
+        }
+    }
+    if (next != token_count) return -1;
+
+    if (engine->rule_count >= engine->rule_capacity) {
+        int capacity = engine->rule_capacity ? engine->rule_capacity * 2 : 16;
+        alert_rule_t *tmp = realloc(engine->rules, sizeof(alert_rule_t) * capacity);
+        if (!tmp) return -1;
+        engine->rules = tmp;
+        engine->rule_capacity = capacity;
+    }
+    engine->rules[engine->rule_count++] = rule;
+    return 0;
+}
+
+static int compare_rule_clear(const void *a, const void *b, void *context) {
+    const alert_rule_t *rules = context;
+    double clear_a = rules[*(const int *)a].clear;
+    double clear_b = rules[*(const int *)b].clear;
+    return (clear_a > clear_b) - (clear_a < clear_b);
+}
+
+static int compare_rule_name(const void *a, const void *b, void *context) {
+    const alert_rule_t *rules = context;
+    return strcmp(rules[*(const int *)a].name, rules[*(const int *)b].name);
+}
+
+static unsigned int name_hash(const char *name) {
+    unsigned int hash = 2166136261u;  // FNV-1a
+    for (; *name; name++) hash = (hash ^ (unsigned char)*name) * 16777619u;
+    return hash;
+}
+
+/**
+ * @brief Indexe les noms distincts des règles par nom (named_rules déjà trié)
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int name_table_build(const alert_rule_t *rules, alert_host_t *state) {
+    int capacity = 16;
+    while (capacity < state->named_count * 4) capacity *= 2;
+    state->name_table = malloc(sizeof(int) * capacity);
+    if (!state->name_table) return -1;
+    state->name_capacity = capacity;
+    for (int i = 0; i < capacity; i++) state->name_table[i] = -1;
+
+    unsigned int mask = (unsigned int)capacity - 1;
+    for (int i = 0; i < state->named_count; i++) {
+        const char *name = rules[state->named_rules[i]].name;
+        if (i > 0 && strcmp(rules[state->named_rules[i - 1]].name, name) == 0) continue;
+        unsigned int j = name_hash(name) & mask;
+        while (state->name_table[j] != -1) j = (j + 1) & mask;
+        state->name_table[j] = i;
+    }
+    return 0;
+}
+
+/**
+ * @brief Première règle portant ce nom dans named_rules
+ *
+ * @return Position dans named_rules, -1 si aucune règle ne porte ce nom
+ */
+static int name_table_find(const alert_rule_t *rules, const alert_host_t *state, const char *name) {
+    unsigned int mask = (unsigned int)state->name_capacity - 1;
+    for (unsigned int j = name_hash(name) & mask; state->name_table[j] != -1; j = (j + 1) & mask) {
+        int first = state->name_table[j];
+        if (strcmp(rules[state->named_rules[first]].name, name) == 0) return first;
+    }
+    return -1;
+}
+
+static alert_slot_t *slots_alloc(int capacity) {
+    alert_slot_t *slots = malloc(sizeof(alert_slot_t) * capacity);
+    if (!slots) return NULL;
+    for (int i = 0; i < capacity; i++) slots[i].rule = ALERT_SLOT_FREE;
+    return slots;
+}
+
+/**
+ * @brief Compile les règles de chaque hôte (index triés, état vide)
+ *
+ * À appeler une fois toutes les règles ajoutées, avant alert_evaluate().
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+int alert_engine_compile(alert_engine_t *engine) {
+    engine->hosts = calloc(engine->host_count > 0 ? engine->host_count : 1, sizeof(alert_host_t));
+    if (!engine->hosts) return -1;
+
+    int rules = engine->rule_count > 0 ? engine->rule_count : 1;
+    for (int h = 0; h < engine->host_count; h++) {
+        alert_host_t *state = &engine->hosts[h];
+        pthread_mutex_init(&state->lock, NULL);
+        state->cpu_rules = malloc(sizeof(int) * rules);
+        state->mem_rules = malloc(sizeof(int) * rules);
+        state->named_rules = malloc(sizeof(int) * rules);
+        state->missing_rules = malloc(sizeof(int) * rules);
+        state->missing_state = calloc(rules, sizeof(alert_slot_t));
+        state->slots = slots_alloc(ALERT_INITIAL_SLOTS);
+        state->live_slots = malloc(sizeof(int) * ALERT_INITIAL_SLOTS);
+        if (!state->cpu_rules || !state->mem_rules || !state->named_rules ||
+            !state->missing_rules || !state->missing_state || !state->slots || !state->live_slots) {
+            return -1;
+        }
+        state->slot_capacity = ALERT_INITIAL_SLOTS;
+        state->cpu_floor = DBL_MAX;
+        state->mem_floor = DBL_MAX;
+
+        for (int r = 0; r < engine->rule_count; r++) {
+            const alert_rule_t *rule = &engine->rules[r];
+            if (rule->host[0] && strcmp(rule->host, engine->host_configs[h].name) != 0) continue;
+
+            if (rule->metric == ALERT_METRIC_MISSING) state->missing_rules[state->missing_count++] = r;
+            if (rule->metric == ALERT_METRIC_CPU && rule->clear < state->cpu_floor) state->cpu_floor = rule->clear;
+            if (rule->metric == ALERT_METRIC_MEM && rule->clear < state->mem_floor) state->mem_floor = rule->clear;
+            if (rule->name[0]) {
+                state->named_rules[state->named_count++] = r;
+            } else if (rule->metric == ALERT_METRIC_CPU) {
+                state->cpu_rules[state->cpu_count++] = r;
+            } else {
+                state->mem_rules[state->mem_count++] = r;
+            }
+        }
+
+        qsort_r(state->cpu_rules, state->cpu_count, sizeof(int), compare_rule_clear, engine->rules);
+        qsort_r(state->mem_rules, state->mem_count, sizeof(int), compare_rule_clear, engine->rules);
+        qsort_r(state->named_rules, state->named_count, sizeof(int), compare_rule_name, engine->rules);
+        if (name_table_build(engine->rules, state) != 0) return -1;
+    }
+    return 0;
+}
+
+void alert_engine_free(alert_engine_t *engine) {
+    for (int h = 0; engine->hosts && h < engine->host_count; h++) {
+        alert_host_t *state = &engine->hosts[h];
+        free(state->cpu_rules);
+        free(state->mem_rules);
+        free(state->named_rules);
+        free(state->name_table);
+        free(state->missing_rules);
+        free(state->missing_state);
+        free(state->slots);
+        free(state->live_slots);
+        pthread_mutex_destroy(&state->lock);
+    }
+    free(engine->hosts);
+    free(engine->rules);
+    pthread_mutex_destroy(&engine->lock);
+    memset(engine, 0, sizeof(alert_engine_t));
+}
+
+/**
+ * @brief Charge un fichier de règles et compile les règles de chaque hôte
+ *
+ * En cas de ligne invalide, le message de l'engine indique la ligne fautive.
+ *
+ * @param engine Moteur à initialiser (à libérer avec alert_engine_free() si le résultat est >= 0)
+ * @param filename Fichier de règles
+ * @param network Hôtes sur lesquels évaluer les règles
+ * @return Nombre de règles chargées, -1 si le fichier est illisible ou invalide
+ */
+int alert_engine_load(alert_engine_t *engine, const char *filename, const network_manager_t *network) {
+    FILE *file = fopen(filename, "r");
+    if (!file) return -1;
+
+    alert_engine_init(engine, network->hosts, network->count);
+    char line[512];
+    int line_number = 0;
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        if (alert_engine_add_rule(engine, line) != 0) {
+            fclose(file);
+            char message[256];
+            snprintf(message, sizeof(message), " Alertes : règle invalide ligne %d de %s", line_number, filename);
+            alert_engine_free(engine);
+            snprintf(engine->message, sizeof(engine->message), "%s", message);
+            return -1;
+        }
+    }
+    fclose(file);
+
+    if (alert_engine_compile(engine) != 0) {
+        alert_engine_free(engine);
+        return -1;
+    }
+    return engine->rule_count;
+}
+
+/**
+ * @brief Lance la commande du hook sans l'attendre
+ *
+ * Double fork : le processus intermédiaire se termine aussitôt, le hook
+ * est adopté par init et ne laisse pas de zombie. L'environnement est
+ * préparé avant le fork (pas d'allocation dans le fils d'un programme
+ * multi-thread).
+ */
+static void alert_run_hook(const char *hook, const char *state, const char *host, const char *rule,
+                           int pid, const char *process, double value) {
+    char env_state[64], env_host[128], env_rule[192], env_pid[32], env_process[96], env_value[64];
+    char env_path[1024];
+    snprintf(env_state, sizeof(env_state), "ALERT_STATE=%s", state);
+    snprintf(env_host, sizeof(env_host), "ALERT_HOST=%s", host);
+    snprintf(env_rule, sizeof(env_rule), "ALERT_RULE=%s", rule);
+    snprintf(env_pid, sizeof(env_pid), "ALERT_PID=%d", pid);
+    snprintf(env_process, sizeof(env_process), "ALERT_PROCESS=%s", process);
+    snprintf(env_value, sizeof(env_value), "ALERT_VALUE=%.1f", value);
+    const char *path = getenv("PATH");
+    snprintf(env_path, sizeof(env_path), "PATH=%s", path ? path : "/usr/bin:/bin");
+    char *const envp[] = { env_state, env_host, env_rule, env_pid, env_process, env_value, env_path, NULL };
+
+    pid_t child = fork();
+    if (child == 0) {
+        if (fork() == 0) {
+            execle("/bin/sh", "sh", "-c", hook, (char *)NULL, envp);
+            _exit(127);
+        }
+        _exit(0);
+    }
+    if (child > 0) waitpid(child, NULL, 0);
+}
+
+/**
+ * @brief Publie un début ou une fin d'alerte (ligne d'état, journal, hook)
+ */
+static void alert_emit(alert_engine_t *engine, int host, const alert_rule_t *rule, int pid,
+                       const char *process, double value, int firing) {
+    const char *host_name = engine->host_configs[host].name;
+    const char *state = firing ? "FIRING" : "RESOLVED";
+
+    char event[256];
+    if (rule->metric == ALERT_METRIC_MISSING) {
+        snprintf(event, sizeof(event), "%s %s : %s", firing ? "ALERTE" : "FIN", host_name, rule->text);
+    } else {
+        snprintf(event, sizeof(event), "%s %s : %s (pid %d %s : %.1f)", firing ? "ALERTE" : "FIN",
+                 host_name, rule->text, pid, process, value);
+    }
+
+    // Seul l'état partagé est mis à jour sous le verrou : le journal et le
+    // hook (fork, waitpid) ne doivent pas bloquer les autres collectes
+    char log_file[sizeof(engine->log_file)];
+    char hook[sizeof(engine->hook)];
+    pthread_mutex_lock(&engine->lock);
+    engine->active += firing ? 1 : -1;
+    snprintf(engine->message, sizeof(engine->message), " %.254s", event);
+    engine->message_id++;
+    memcpy(log_file, engine->log_file, sizeof(log_file));
+    memcpy(hook, engine->hook, sizeof(hook));
+    pthread_mutex_unlock(&engine->lock);
+
+    FILE *log = log_file[0] ? fopen(log_file, "a") : NULL;
+    if (log) {
+        char date[32];
+        time_t now = time(NULL);
+        struct tm tm;
+        localtime_r(&now, &tm);
+        strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &tm);
+        fprintf(log, "%s %s %s\n", date, state, event);
+        fclose(log);
+    }
+
+    if (hook[0]) {
+        alert_run_hook(hook, state, host_name, rule->text, pid, process, value);
+    }
+}
+
+static unsigned int slot_hash(int rule, int pid) {
+    return ((unsigned int)pid * 2654435761u) ^ ((unsigned int)rule * 2246822519u);
+}
+
+static alert_slot_t *slot_find(alert_host_t *state, int rule, int pid) {
+    unsigned int mask = (unsigned int)state->slot_capacity - 1;
+    for (unsigned int i = slot_hash(rule, pid) & mask;; i = (i + 1) & mask) {
+        alert_slot_t *slot = &state->slots[i];
+        if (slot->rule == ALERT_SLOT_FREE) return NULL;
+        if (slot->rule == rule && slot->pid == pid) return slot;
+    }
+}
+
+/**
+ * @brief Reconstruit la table à la taille des conditions en cours, sans les suppressions
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int slots_rehash(alert_host_t *state) {
+    int live = state->live_count;
+
+    // Un tiers de remplissage au plus : la table rétrécit aussi après une
+    // rafale, pour que les recherches restent courtes
+    int capacity = ALERT_INITIAL_SLOTS;
+    while ((live + 1) * 3 > capacity) capacity *= 2;
+
+    alert_slot_t *slots = slots_alloc(capacity);
+    int *live_slots = malloc(sizeof(int) * capacity);
+    if (!slots || !live_slots) {
+        free(slots);
+        free(live_slots);
+        return -1;
+    }
+
+    unsigned int mask = (unsigned int)capacity - 1;
+    for (int i = 0; i < live; i++) {
+        const alert_slot_t *slot = &state->slots[state->live_slots[i]];
+        unsigned int j = slot_hash(slot->rule, slot->pid) & mask;
+        while (slots[j].rule != ALERT_SLOT_FREE) j = (j + 1) & mask;
+        slots[j] = *slot;
+        live_slots[i] = (int)j;
+    }
+
+    free(state->slots);
+    free(state->live_slots);
+    state->slots = slots;
+    state->live_slots = live_slots;
+    state->slot_capacity = capacity;
+    state->slot_used = live;
+    return 0;
+}
+
+/**
+ * @brief Crée l'état d'une condition (absente de la table)
+ *
+ * @return L'emplacement, NULL en cas d'erreur d'allocation
+ */
+static alert_slot_t *slot_insert(alert_host_t *state, int rule, int pid) {
+    if ((state->slot_used + 1) * 2 > state->slot_capacity && slots_rehash(state) != 0) return NULL;
+
+    unsigned int mask = (unsigned int)state->slot_capacity - 1;
+    unsigned int i = slot_hash(rule, pid) & mask;
+    while (state->slots[i].rule >= 0) i = (i + 1) & mask;
+
+    alert_slot_t *slot = &state->slots[i];
+    if (slot->rule == ALERT_SLOT_FREE) state->slot_used++;
+    state->live_slots[state->live_count++] = (int)i;
+    memset(slot, 0, sizeof(alert_slot_t));
+    slot->rule = rule;
+    slot->pid = pid;
+    return slot;
+}
+
+/**
+ * @brief Applique une règle à un processus dont la valeur dépasse le seuil de fin
+ *
+ * Crée l'état de la condition quand le seuil est franchi, déclenche
+ * l'alerte une fois la durée minimale écoulée, et garde une alerte active
+ * tant que la valeur reste au-dessus du seuil de fin.
+ */
+static void alert_check(alert_engine_t *engine, int host, alert_host_t *state, int r,
+                        const process_info_t *proc, double value, long long now_ms) {
+    const alert_rule_t *rule = &engine->rules[r];
+    int active = value > rule->threshold;
+
+    alert_slot_t *slot = slot_find(state, r, proc->pid);
+    if (!slot) {
+        if (!active) return;
+        slot = slot_insert(state, r, proc->pid);
+        if (!slot) return;
+        slot->since_ms = now_ms;
+        snprintf(slot->process, sizeof(slot->process), "%.31s", proc->name);
+    }
+
+    // Condition retombée avant la durée minimale : l'état est effacé au balayage
+    if (!active && !slot->firing) return;
+
+    slot->seen = state->evaluation;
+    slot->value = (float)value;
+    if (!slot->firing && now_ms - slot->since_ms >= rule->duration_ms) {
+        slot->firing = 1;
+        alert_emit(engine, host, rule, proc->pid, slot->process, value, 1);
+    }
+}
+
+static double rule_value(const alert_rule_t *rule, const process_info_t *proc) {
+    return (rule->metric == ALERT_METRIC_CPU) ? proc->cpu_percent : (double)proc->memory_kb;
+}
+
+/**
+ * @brief Évalue les règles d'un hôte sur un nouvel instantané
+ *
+ * Un processus sous les seuils de fin de toutes les règles cpu et mem est
+ * écarté sur deux comparaisons, sans recherche de son nom dès que tous les
+ * processus attendus (règles missing) ont été vus. Sinon, seules les
+ * règles dont le seuil de fin est sous sa valeur sont parcourues (listes
+ * triées), plus les règles portant son nom (table des noms). Les
+ * conditions qui n'ont pas été revues (processus disparu ou valeur
+ * retombée) sont ensuite effacées, avec un message de fin si l'alerte
+ * était active : seuls les emplacements occupés sont parcourus.
+ *
+ * @param engine Moteur compilé
+ * @param host Index de l'hôte
+ * @param list Processus de l'instantané
+ * @param count Nombre de processus
+ * @param now_ms Date de l'instantané (network_now_ms())
+ */
+void alert_evaluate(alert_engine_t *engine, int host, const process_info_t *list, int count, long long now_ms) {
+    if (!engine || !engine->hosts || host < 0 || host >= engine->host_count) return;
+
+    alert_host_t *state = &engine->hosts[host];
+    pthread_mutex_lock(&state->lock);
+    unsigned int evaluation = ++state->evaluation;
+    int missing_pending = state->missing_count;  // Règles missing dont le processus n'a pas encore été vu
+
+    for (int p = 0; p < count; p++) {
+        const process_info_t *proc = &list[p];
+
+        double cpu = proc->cpu_percent;
+        double mem = proc->memory_kb;
+        if (cpu <= state->cpu_floor && mem <= state->mem_floor && missing_pending == 0) continue;
+
+        for (int i = 0; i < state->cpu_count && engine->rules[state->cpu_rules[i]].clear < cpu; i++) {
+            alert_check(engine, host, state, state->cpu_rules[i], proc, cpu, now_ms);
+        }
+
+        for (int i = 0; i < state->mem_count && engine->rules[state->mem_rules[i]].clear < mem; i++) {
+            alert_check(engine, host, state, state->mem_rules[i], proc, mem, now_ms);
+        }
+
+        if (state->named_count == 0) continue;
+
+        int first = name_table_find(engine->rules, state, proc->name);
+        if (first < 0) continue;
+        for (int i = first; i < state->named_count; i++) {
+            int r = state->named_rules[i];
+            const alert_rule_t *rule = &engine->rules[r];
+            if (strcmp(rule->name, proc->name) != 0) break;
+
+            if (rule->metric == ALERT_METRIC_MISSING) {
+                if (state->missing_state[r].seen != evaluation) missing_pending--;
+                state->missing_state[r].seen = evaluation;
+            } else {
+                double value = rule_value(rule, proc);
+                if (value > rule->clear) alert_check(engine, host, state, r, proc, value, now_ms);
+            }
+        }
+    }
+
+    // Processus attendus : absents depuis "for", ou revenus
+    for (int i = 0; i < state->missing_count; i++) {
+        int r = state->missing_rules[i];
+        alert_slot_t *missing = &state->missing_state[r];
+        if (missing->seen == evaluation) {
+            if (missing->firing) alert_emit(engine, host, &engine->rules[r], 0, "", 0.0, 0);
+            missing->firing = 0;
+            missing->since_ms = 0;
+        } else {
+            if (missing->since_ms == 0) missing->since_ms = now_ms;
+            if (!missing->firing && now_ms - missing->since_ms >= engine->rules[r].duration_ms) {
+                missing->firing = 1;
+                alert_emit(engine, host, &engine->rules[r], 0, "", 0.0, 1);
+            }
+        }
+    }
+
+    // Conditions non revues : processus disparu ou valeur sous le seuil de fin
+    int live = 0;
+    for (int i = 0; i < state->live_count; i++) {
+        alert_slot_t *slot = &state->slots[state->live_slots[i]];
+        if (slot->seen == evaluation) {
+            state->live_slots[live++] = state->live_slots[i];
+            continue;
+        }
+        if (slot->firing) {
+            alert_emit(engine, host, &engine->rules[slot->rule], slot->pid, slot->process, slot->value, 0);
+        }
+        slot->rule = ALERT_SLOT_DELETED;
+    }
+    state->live_count = live;
+
+    pthread_mutex_unlock(&state->lock);
+}
+
+/**
+ * @brief Copie le dernier événement d'alerte s'il n'a pas encore été lu
+ *
+ * @param engine Le moteur
+ * @param seen Identifiant du dernier message lu par l'appelant (mis à jour)
+ * @param buffer Buffer qui recevra le message
+ * @param size Taille du buffer
+ * @return 1 si un nouveau message a été copié, 0 sinon
+ */
+int alert_poll_message(alert_engine_t *engine, unsigned long *seen, char *buffer, size_t size) {
+    pthread_mutex_lock(&engine->lock);
+    int fresh = engine->message_id != *seen;
+    if (fresh) {
+        snprintf(buffer, size, "%s", engine->message);
+        *seen = engine->message_id;
+    }
+    pthread_mutex_unlock(&engine->lock);
+    return fresh;
+}
+
+int alert_active_count(alert_engine_t *engine) {
+    pthread_mutex_lock(&engine->lock);
+    int active = engine->active;
+    pthread_mutex_unlock(&engine->lock);
+    return active;
+}
@@ -0,0 +1,151 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdalign.h>
+
+#define ARENA_ALIGN alignof(max_align_t)
+#define ARENA_ROUND(size) (((size) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+#define ARENA_HEADER ARENA_ROUND(sizeof(arena_block_t))
+
+// Arène dans laquelle les collecteurs du thread allouent leurs listes
+static __thread arena_t *current_arena = NULL;
+
+void arena_init(arena_t *arena) {
+    memset(arena, 0, sizeof(arena_t));
+}
+
+/**
+ * @brief Alloue une zone dans l'arène (alignée comme malloc)
+ *
+ * Prend la place à la suite du bloc courant ; si elle manque, chaîne un
+ * nouveau bloc au moins deux fois plus grand (ou de la taille prévue par
+ * la collecte précédente).
+ *
+ * @return Pointeur vers la zone, NULL en cas d'erreur d'allocation
+ */
+void *arena_alloc(arena_t *arena, size_t size) {
+    size = ARENA_ROUND(size ? size : 1);
+
+    arena_block_t *block = arena->head;
+    if (!block || block->size - block->used < size) {
+        size_t block_size = arena->reserve > ARENA_MIN_BLOCK ? arena->reserve : ARENA_MIN_BLOCK;
+        if (block && block_size < block->size * 2) block_size = block->size * 2;
+        if (block_size < size) block_size = size;
+
+        block = malloc(ARENA_HEADER + block_size);
+        if (!block) return NULL;
+        block->size = block_size;
+        block->used = 0;
+        block->next = arena->head;
+        arena->head = block;
+    }
+
+    void *ptr = (unsigned char *)block + ARENA_HEADER + block->used;
+    block->used += size;
+    arena->used += size;
+    arena->last = ptr;
+    arena->last_size = size;
+    return ptr;
+}
+
+/**
+ * @brief Agrandit (ou réduit) une zone de l'arène
+ *
+ * La dernière zone allouée grandit sur place tant que le bloc a de la
+ * place : une liste remplie par doublements successifs n'est pas recopiée.
+ * Les autres zones sont recopiées, l'ancienne place n'étant rendue qu'au
+ * prochain reset.
+ *
+ * @return Pointeur vers la zone (éventuellement déplacée), NULL en cas d'erreur
+ */
+void *arena_realloc(arena_t *arena, void *ptr, size_t old_size, size_t new_size) {
+    if (!ptr) return arena_alloc(arena, new_size);
+
+    size_t rounded = ARENA_ROUND(new_size ? new_size : 1);
+    if (ptr == arena->last) {
+        arena_block_t *block = arena->head;
+        if (rounded <= arena->last_size || rounded - arena->last_size <= block->size - block->used) {
+            block->used = block->used - arena->last_size + rounded;
+            arena->used = arena->used - arena->last_size + rounded;
+            arena->last_size = rounded;
+            return ptr;
+        }
+    } else if (new_size <= old_size) {
+        return ptr;
+    }
+
+    void *moved = arena_alloc(arena, new_size);
+    if (!moved) return NULL;
+    memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+    return moved;
+}
+
+/**
+ * @brief Libère d'un coup toutes les zones de l'arène
+ *
+ * Le bloc courant est gardé s'il suffit à contenir une collecte comme
+ * celle qui se termine (avec 25 % de marge) sans être démesuré ; sinon la
+ * prochaine allocation prendra un bloc unique de cette taille.
+ */
+void arena_reset(arena_t *arena) {
+    size_t needed = arena->used + arena->used / 4;
+    if (needed < ARENA_MIN_BLOCK) needed = ARENA_MIN_BLOCK;
+    arena->reserve = needed;
+
+    arena_block_t *keep = arena->head;
+    if (keep && (keep->size < needed || keep->size > needed * 4)) keep = NULL;
+
+    arena_block_t *block = arena->head;
+    while (block) {
+        arena_block_t *next = block->next;
+        if (block != keep) free(block);
+        block = next;
+    }
+
+    if (keep) {
+        keep->next = NULL;
+        keep->used = 0;
+    }
+    arena->head = keep;
+    arena->used = 0;
+    arena->last = NULL;
+    arena->last_size = 0;
+}
+
+void arena_destroy(arena_t *arena) {
+    arena_block_t *block = arena->head;
+    while (block) {
+        arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+    memset(arena, 0, sizeof(arena_t));
+}
+
+/**
+ * @brief Lie une arène au thread courant (NULL pour revenir à malloc)
+ */
+void arena_bind(arena_t *arena) {
+    current_arena = arena;
+}
+
+void *snapshot_alloc(size_t size) {
+    return current_arena ? arena_alloc(current_arena, size) : malloc(size);
+}
+
+void *snapshot_realloc(void *ptr, size_t old_size, size_t new_size) {
+    return current_arena ? arena_realloc(current_arena, ptr, old_size, new_size) : realloc(ptr, new_size);
+}
+
+/**
+ * @brief Libère une liste d'instantané (sans effet dans une arène : la
+ * place est rendue au reset)
+ */
+void snapshot_free(void *ptr) {
+    if (!current_arena) free(ptr);
+}
+
+int snapshot_capacity_hint(int fallback) {
+    if (!current_arena || current_arena->count_hint <= 0) return fallback;
+    return current_arena->count_hint + current_arena->count_hint / 8 + 16;
+}
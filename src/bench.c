@@ -0,0 +1,636 @@
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "poller.h"
+#include "proc_parse.h"
+#include "alert.h"
+#include "mock_transport.h"
+
+#define BENCH_IDLE_INTERVAL_MS (3600 * 1000)  // Aucune collecte planifiée : seuls les tours déclenchent
+
+static int compare_long_long(const void *a, const void *b) {
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Attend qu'aucune collecte ne soit en cours
+ */
+static void bench_wait_idle(poller_t *poller) {
+    for (;;) {
+        int busy = 0;
+        pthread_mutex_lock(&poller->lock);
+        for (int i = 0; i < poller->slot_count; i++) busy |= poller->slots[i].in_flight;
+        pthread_mutex_unlock(&poller->lock);
+        if (!busy) return;
+        usleep(1000);
+    }
+}
+
+/**
+ * @brief Mesure un nombre d'hôtes simulés et affiche une ligne de résultats
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int bench_hosts(int host_count, const char *spec) {
+    network_manager_t network;
+    memset(&network, 0, sizeof(network));
+    network.hosts = calloc(host_count, sizeof(host_config_t));
+    long long *latencies = malloc(sizeof(long long) * host_count * BENCH_ROUNDS);
+    unsigned long *generations = calloc(host_count, sizeof(unsigned long));
+    int *done = calloc(host_count, sizeof(int));
+    if (!network.hosts || !latencies || !generations || !done) {
+        free(network.hosts);
+        free(latencies);
+        free(generations);
+        free(done);
+        return -1;
+    }
+
+    for (int i = 0; i < host_count; i++) {
+        host_config_t *host = &network.hosts[i];
+        snprintf(host->name, sizeof(host->name), "mock%d", i);
+        snprintf(host->address, sizeof(host->address), "%s", spec);
+        host->type = CONNECTION_MOCK;
+        host->mode = COLLECT_PS;
+        host->interval_ms = BENCH_IDLE_INTERVAL_MS;
+        host->deadline_ms = DEFAULT_DEADLINE_MS;
+    }
+    network.count = host_count;
+
+    poller_t poller;
+    if (poller_start(&poller, &network) != 0) {
+        free(network.hosts);
+        free(latencies);
+        free(generations);
+        free(done);
+        return -1;
+    }
+
+    int samples = 0;
+    int failures = 0;
+    long long total_ms = 0;
+
+    for (int round = 0; round <= BENCH_ROUNDS; round++) {  // Le tour 0 sert d'échauffement
+        bench_wait_idle(&poller);
+
+        pthread_mutex_lock(&poller.lock);
+        for (int i = 0; i < host_count; i++) generations[i] = poller.slots[i].generation;
+        pthread_mutex_unlock(&poller.lock);
+        memset(done, 0, sizeof(int) * host_count);
+
+        long long start = network_now_ms();
+        for (int i = 0; i < host_count; i++) poller_refresh_now(&poller, i);
+
+        int remaining = host_count;
+        while (remaining > 0) {
+            usleep(500);
+            long long now = network_now_ms();
+
+            pthread_mutex_lock(&poller.lock);
+            for (int i = 0; i < host_count; i++) {
+                if (done[i]) continue;
+                poller_slot_t *slot = &poller.slots[i];
+                int success = slot->generation != generations[i];
+                int failed = !slot->in_flight && slot->next_due_ms > start && slot->last_result != 0;
+                if (!success && !failed) continue;
+
+                done[i] = 1;
+                remaining--;
+                if (round == 0) continue;
+                if (success) {
+                    latencies[samples++] = now - start;
+                } else {
+                    failures++;
+                }
+            }
+            pthread_mutex_unlock(&poller.lock);
+        }
+
+        if (round > 0) total_ms += network_now_ms() - start;
+    }
+
+    poller_stop(&poller);
+
+    qsort(latencies, samples, sizeof(long long), compare_long_long);
+    long long p50 = samples ? latencies[samples / 2] : 0;
+    long long p95 = samples ? latencies[(samples * 95) / 100 < samples ? (samples * 95) / 100 : samples - 1] : 0;
+    long long max = samples ? latencies[samples - 1] : 0;
+    double throughput = total_ms > 0 ? samples * 1000.0 / total_ms : 0.0;
+
+    printf("%6d %8d %7d %8lld %8lld %8lld %10.1f %11.1f\n", host_count, samples, failures,
+           p50, p95, max, (double)total_ms / BENCH_ROUNDS, throughput);
+
+    free(network.hosts);
+    free(latencies);
+    free(generations);
+    free(done);
+    return 0;
+}
+
+/**
+ * @brief Mesure une évaluation de BENCH_ALERT_RULES règles sur BENCH_ALERT_PROCESSES processus
+ *
+ * Règles cpu et mem à seuils variés, règles par nom et règles missing ;
+ * un processus sur mille dépasse les seuils cpu, pour que la table d'état serve.
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int bench_alerts(void) {
+    host_config_t host;
+    memset(&host, 0, sizeof(host));
+    snprintf(host.name, sizeof(host.name), "mock0");
+
+    process_info_t *list = calloc(BENCH_ALERT_PROCESSES, sizeof(process_info_t));
+    if (!list) return -1;
+    unsigned int seed = 42;
+    for (int i = 0; i < BENCH_ALERT_PROCESSES; i++) {
+        list[i].pid = i + 1;
+        snprintf(list[i].name, sizeof(list[i].name), "proc%d", i % 500);
+        list[i].cpu_percent = (i % 1000 == 0) ? 95.0f : (float)(rand_r(&seed) % 500) / 100.0f;
+        list[i].memory_kb = 1024 + rand_r(&seed) % (64 * 1024);
+    }
+
+    alert_engine_t engine;
+    alert_engine_init(&engine, &host, 1);
+    engine.log_file[0] = '\0';  // Ni journal ni hook pendant la mesure
+    char rule[128];
+    for (int r = 0; r < BENCH_ALERT_RULES; r++) {
+        switch (r % 4) {
+            case 0: snprintf(rule, sizeof(rule), "cpu > %d for 30s clear %d", 50 + r % 50, 40 + r % 50); break;
+            case 1: snprintf(rule, sizeof(rule), "mem > %dM", 128 + r); break;
+            case 2: snprintf(rule, sizeof(rule), "cpu > %d name proc%d", 10 + r % 80, r); break;
+            default: snprintf(rule, sizeof(rule), "missing proc%d for 10s", r); break;
+        }
+        if (alert_engine_add_rule(&engine, rule) != 0) {
+            alert_engine_free(&engine);
+            free(list);
+            return -1;
+        }
+    }
+    if (alert_engine_compile(&engine) != 0) {
+        alert_engine_free(&engine);
+        free(list);
+        return -1;
+    }
+
+    struct timespec start, end;
+    long long now_ms = 0;
+    alert_evaluate(&engine, 0, list, BENCH_ALERT_PROCESSES, now_ms);  // Échauffement
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        now_ms += 1000;
+        alert_evaluate(&engine, 0, list, BENCH_ALERT_PROCESSES, now_ms);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double total_us = (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3;
+
+    printf("Alertes : %d règles, %d processus : %.1f us par évaluation (%d conditions suivies)\n",
+           BENCH_ALERT_RULES, BENCH_ALERT_PROCESSES, total_us / BENCH_ROUNDS, engine.hosts[0].live_count);
+
+    alert_engine_free(&engine);
+    free(list);
+    return 0;
+}
+
+// Analyseurs de proc_parse.h, numérotés comme le premier octet des entrées
+// de proc_parse_fuzz_one()
+enum {
+    PARSER_STAT,
+    PARSER_STATUS,
+    PARSER_STATM,
+    PARSER_CPU_TOTAL,
+    PARSER_PS_COLUMNS,
+    PARSER_PS_AUX,
+    PARSER_SCHEDSTAT,
+    PARSER_NET_SOCKET,
+    PARSER_COUNT
+};
+
+static const char *parser_names[PARSER_COUNT] = {
+    "/proc/[pid]/stat", "/proc/[pid]/status", "/proc/[pid]/statm", "/proc/stat", "ps -eo", "ps aux", "schedstat",
+    "/proc/net/tcp"
+};
+
+// Cas du corpus : entrée et résultat attendu. values selon l'analyseur :
+//   stat   : pid, ppid, utime, stime, starttime, rss_pages, minflt, majflt
+//   status : pid, ppid, vmrss_kb, kthread, voluntary_switches, nonvoluntary_switches
+//   statm  : taille, pages résidentes
+//   cpu    : total
+//   ps     : pid, ppid, memory_kb, time, is_kernel, cpu_percent * 10
+//   schedstat : run_ns, wait_ns, slices
+//   net    : état, inode
+typedef struct {
+    int parser;
+    const char *input;
+    int result;           // Retour attendu (les champs ne sont vérifiés que pour 0)
+    char state;           // 0 : non vérifié
+    const char *name;     // NULL : non vérifié
+    long long values[8];
+} parser_case_t;
+
+// Champs 25 à 52 d'une ligne stat ordinaire
+#define STAT_TAIL " 18446744073709551615 94000000000000 94000000100000 140000000000000 0 0 65536 3670020" \
+                  " 0 0 0 17 0 0 0 0 0 0 94000000200000 94000000300000 94000000400000 140000000100000" \
+                  " 140000000200000 140000000200000 140000000300000 0\n"
+
+static const parser_case_t parser_corpus[] = {
+    { PARSER_STAT, "1234 (bash) S 1 1234 1234 34816 5678 4194304 1500 20000 2 10 150 45 30 12 20 0 1 0 98765 12345678 1024" STAT_TAIL,
+      0, 'S', "bash", { 1234, 1, 150, 45, 98765, 1024, 1500, 2 } },
+    { PARSER_STAT, "4321 (my prog) R 1234 4321 1234 34816 4321 4194304 10 0 0 0 7 3 0 0 20 0 1 0 100000 2000000 300" STAT_TAIL,
+      0, 'R', "my prog", { 4321, 1234, 7, 3, 100000, 300, 10, 0 } },
+    { PARSER_STAT, "77 (a) b (c) S 1 77 77 0 -1 4194560 5 0 0 0 1 1 0 0 20 0 1 0 500 1000 10" STAT_TAIL,
+      0, 'S', "a) b (c", { 77, 1, 1, 1, 500, 10, 5, 0 } },
+    { PARSER_STAT, "78 ()) D 2 0 0 0 -1 2129984 0 0 0 0 0 0 0 0 20 0 1 0 42 0 0" STAT_TAIL,
+      0, 'D', ")", { 78, 2, 0, 0, 42, 0 } },
+    { PARSER_STAT, "79 (1 2 3 4 5) S 1 79 79 0 -1 4194304 0 0 0 0 11 22 0 0 20 0 1 0 33 44 55" STAT_TAIL,
+      0, 'S', "1 2 3 4 5", { 79, 1, 11, 22, 33, 55 } },
+    { PARSER_STAT, "80 () Z 1 80 80 0 -1 4227084 0 0 0 0 0 0 0 0 20 0 1 0 700 0 0" STAT_TAIL,
+      0, 'Z', "", { 80, 1, 0, 0, 700, 0 } },
+    { PARSER_STAT, "81 (rt-task) S 1 81 81 0 -1 4194304 0 0 0 0 9 8 0 0 -100 -20 4 0 600 1000 20" STAT_TAIL,
+      0, 'S', "rt-task", { 81, 1, 9, 8, 600, 20 } },
+    { PARSER_STAT, "82 (a\nb) S 1 82 82 0 -1 4194304 0 0 0 0 5 6 0 0 20 0 1 0 7 8 9" STAT_TAIL,
+      0, 'S', "a\nb", { 82, 1, 5, 6, 7, 9 } },
+    { PARSER_STAT, "2 (kthreadd) S 0 0 0 0 -1 2129984 0 0 0 0 0 12 0 0 20 0 1 0 3 0 0 18446744073709551615"
+                   " 0 0 0 0 0 0 0 2147483647 0 1 0 0 17 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n",
+      0, 'S', "kthreadd", { 2, 0, 0, 12, 3, 0 } },
+    { PARSER_STAT, "1234 (bash) S 1 1234 1234 34816 5678 4194304 1500 20000 2 10 150 45", -1, 0, NULL, { 0 } },
+    { PARSER_STAT, "1234 bash S 1 1234 1234 34816 5678 4194304 1500 20000 2 10 150 45" STAT_TAIL, -1, 0, NULL, { 0 } },
+    { PARSER_STAT, "12x (bash) S 1 1234 1234 34816 5678 4194304 1500 20000 2 10 150 45 30 12 20 0 1 0 98765 12345678 1024" STAT_TAIL,
+      -1, 0, NULL, { 0 } },
+    { PARSER_STAT, "1234 (bash) S 1 1234 1234 34816 5678 4194304 1500 20000 2 10 15x0 45 30 12 20 0 1 0 98765 12345678 1024" STAT_TAIL,
+      -1, 0, NULL, { 0 } },
+    { PARSER_STAT, "", -1, 0, NULL, { 0 } },
+
+    { PARSER_STATUS, "Name:\tbash\nUmask:\t0022\nState:\tS (sleeping)\nTgid:\t1234\nNgid:\t0\nPid:\t1234\nPPid:\t1\n"
+                     "TracerPid:\t0\nUid:\t1000\t1000\t1000\t1000\nVmPeak:\t   12000 kB\nVmRSS:\t    4096 kB\n"
+                     "RssAnon:\t    1024 kB\nThreads:\t1\nKthread:\t0\nvoluntary_ctxt_switches:\t1520\n"
+                     "nonvoluntary_ctxt_switches:\t37\n",
+      0, 'S', "bash", { 1234, 1, 4096, 0, 1520, 37 } },
+    { PARSER_STATUS, "Name:\tkworker/0:1-events\nUmask:\t0000\nState:\tI (idle)\nTgid:\t15\nPid:\t15\nPPid:\t2\n"
+                     "Kthread:\t1\nThreads:\t1\n",
+      0, 'I', "kworker/0:1-events", { 15, 2, -1, 1, -1, -1 } },
+    { PARSER_STATUS, "Name:\tmy prog (x)\nState:\tR (running)\nPid:\t42\nPPid:\t1\nVmRSS:\t     12 kB\n",
+      0, 'R', "my prog (x)", { 42, 1, 12, -1, -1, -1 } },
+    { PARSER_STATUS, "Tgid:\t7\nPid:\t7\nPPid:\t0", 0, '?', "", { 7, 0, -1, -1, -1, -1 } },
+    { PARSER_STATUS, "Name:\tx\nState:\tS (sleeping)\n", -1, 0, NULL, { 0 } },
+    { PARSER_STATUS, "Pid:\tabc\n", -1, 0, NULL, { 0 } },
+
+    { PARSER_STATM, "3000 1024 512 100 0 800 0\n", 0, 0, NULL, { 3000, 1024 } },
+    { PARSER_STATM, "3000", -1, 0, NULL, { 0 } },
+    { PARSER_STATM, "x 1\n", -1, 0, NULL, { 0 } },
+
+    { PARSER_CPU_TOTAL, "cpu  100 20 30 4000 5 6 7 8 0 0\ncpu0 50 10 15 2000 2 3 3 4 0 0\nintr 1\n", 0, 0, NULL, { 4168 } },
+    { PARSER_CPU_TOTAL, "cpu0 1 2 3 4 5 6 7\n", -1, 0, NULL, { 0 } },
+    { PARSER_CPU_TOTAL, "cpu  1 2 3\n", -1, 0, NULL, { 0 } },
+    { PARSER_CPU_TOTAL, "intr 1\n", -1, 0, NULL, { 0 } },
+
+    { PARSER_PS_COLUMNS, "    1     0 Ss    0.0 11856 123456 systemd", 0, 'S', "systemd", { 1, 0, 11856, 123456, 0, 0 } },
+    { PARSER_PS_COLUMNS, "  812     1 Sl   12.5 40960   3600 my daemon (x)", 0, 'S', "my daemon (x)", { 812, 1, 40960, 3600, 0, 125 } },
+    { PARSER_PS_COLUMNS, "    3     2 I<    0.0     0    99 rcu_gp", 0, 'I', "rcu_gp", { 3, 2, 0, 99, 1, 0 } },
+    { PARSER_PS_COLUMNS, "  PID  PPID STAT %CPU   RSS ELAPSED COMMAND", -1, 0, NULL, { 0 } },
+    { PARSER_PS_COLUMNS, "    5     1 S     0.0", -1, 0, NULL, { 0 } },
+    { PARSER_PS_COLUMNS, "    6     1 S     0.0   100     5 ", -1, 0, NULL, { 0 } },
+
+    { PARSER_PS_AUX, "root         1  0.0  0.1 167744 11856 ?        Ss   Oct18   0:03 /sbin/init splash",
+      0, 'S', "/sbin/init splash", { 1, 0, 11856, 0, 0, 0 } },
+    { PARSER_PS_AUX, "root         2  0.0  0.0      0     0 ?        S    Oct18   0:00 [kthreadd]",
+      0, 'S', "[kthreadd]", { 2, 0, 0, 0, 1, 0 } },
+    { PARSER_PS_AUX, "www-data   900 25.3  1.2 250000 50000 ?        R    10:02   1:10 php-fpm: pool www",
+      0, 'R', "php-fpm: pool www", { 900, 0, 50000, 0, 0, 253 } },
+    { PARSER_PS_AUX, "USER         PID %CPU %MEM    VSZ   RSS TTY      STAT START   TIME COMMAND", -1, 0, NULL, { 0 } },
+
+    { PARSER_SCHEDSTAT, "1000638790 25427079 42\n", 0, 0, NULL, { 1000638790, 25427079, 42 } },
+    { PARSER_SCHEDSTAT, "0 0 0", 0, 0, NULL, { 0, 0, 0 } },
+    { PARSER_SCHEDSTAT, "1000638790 25427079\n", -1, 0, NULL, { 0 } },
+
+    { PARSER_NET_SOCKET, "   0: 0100007F:0913 00000000:0000 0A 00000000:00000000 00:00000000 00000000     0        0 23793 1"
+                         " 00000000edda2ec7 100 0 0 10 0\n", 0, 0, NULL, { 0x0a, 23793 } },
+    { PARSER_NET_SOCKET, "  12: 0000000000000000FFFF00000100007F:D2F4 0000000000000000FFFF00000100007F:1F90 01"
+                         " 00000000:00000000 02:000A3C8D 00000000  1000        0 4172916 2 000000003c1b7c2f 20 4 30 10 -1\n",
+                         0, 0, NULL, { 0x01, 4172916 } },
+    { PARSER_NET_SOCKET, " 301: 0100007F:9C40 0100007F:0913 06 00000000:00000000 03:00000D2C 00000000     0        0 0 3"
+                         " 00000000b0f1c6a5\n", 0, 0, NULL, { 0x06, 0 } },
+    { PARSER_NET_SOCKET, "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode\n",
+      -1, 0, NULL, { 0 } },
+    { PARSER_NET_SOCKET, "   0: 0100007F:0913 00000000:0000 0A 00000000:00000000 00:00000000 00000000     0", -1, 0, NULL, { 0 } },
+    { PARSER_NET_SOCKET, "   0: 0100007F:0913 00000000:0000 0G 00000000:00000000 00:00000000 00000000 0 0 23793", -1, 0, NULL, { 0 } },
+};
+
+#define PARSER_CORPUS_SIZE ((int)(sizeof(parser_corpus) / sizeof(parser_corpus[0])))
+
+/**
+ * @brief Exécute l'analyseur d'un cas du corpus
+ *
+ * @param c Cas (analyseur et entrée)
+ * @param values Valeurs lues, dans l'ordre de parser_case_t
+ * @param state État lu (0 si l'analyseur n'en donne pas)
+ * @param name Nom lu (chaîne vide si l'analyseur n'en donne pas)
+ * @return Retour de l'analyseur
+ */
+static int bench_parse_case(const parser_case_t *c, long long values[8], char *state, char name[256]) {
+    size_t len = strlen(c->input);
+    int result = -1;
+    memset(values, 0, sizeof(long long) * 8);
+    *state = 0;
+    name[0] = '\0';
+
+    switch (c->parser) {
+        case PARSER_STAT: {
+            proc_stat_t stat;
+            result = proc_parse_stat(c->input, len, &stat);
+            values[0] = stat.pid;
+            values[1] = stat.ppid;
+            values[2] = (long long)stat.utime;
+            values[3] = (long long)stat.stime;
+            values[4] = (long long)stat.starttime;
+            values[5] = (long long)stat.rss_pages;
+            values[6] = (long long)stat.minflt;
+            values[7] = (long long)stat.majflt;
+            *state = stat.state;
+            strcpy(name, stat.name);
+            break;
+        }
+        case PARSER_STATUS: {
+            proc_status_t status;
+            result = proc_parse_status(c->input, len, &status);
+            values[0] = status.pid;
+            values[1] = status.ppid;
+            values[2] = status.vmrss_kb;
+            values[3] = status.kthread;
+            values[4] = status.voluntary_switches;
+            values[5] = status.nonvoluntary_switches;
+            *state = status.state;
+            strcpy(name, status.name);
+            break;
+        }
+        case PARSER_STATM: {
+            unsigned long long size_pages = 0, resident_pages = 0;
+            result = proc_parse_statm(c->input, len, &size_pages, &resident_pages);
+            values[0] = (long long)size_pages;
+            values[1] = (long long)resident_pages;
+            break;
+        }
+        case PARSER_CPU_TOTAL: {
+            unsigned long long total = 0;
+            result = proc_parse_cpu_total(c->input, len, &total);
+            values[0] = (long long)total;
+            break;
+        }
+        case PARSER_SCHEDSTAT: {
+            proc_schedstat_t schedstat = { 0, 0, 0 };
+            result = proc_parse_schedstat(c->input, len, &schedstat);
+            values[0] = (long long)schedstat.run_ns;
+            values[1] = (long long)schedstat.wait_ns;
+            values[2] = (long long)schedstat.slices;
+            break;
+        }
+        case PARSER_NET_SOCKET: {
+            proc_net_socket_t entry = { 0, 0 };
+            result = proc_parse_net_socket(c->input, len, &entry);
+            values[0] = entry.state;
+            values[1] = (long long)entry.inode;
+            break;
+        }
+        default: {
+            process_info_t proc;
+            ps_format_t format = (c->parser == PARSER_PS_COLUMNS) ? PS_FORMAT_COLUMNS : PS_FORMAT_AUX;
+            result = proc_parse_ps_line(c->input, len, format, &proc);
+            values[0] = proc.pid;
+            values[1] = proc.ppid;
+            values[2] = proc.memory_kb;
+            values[3] = (long long)proc.time;
+            values[4] = proc.is_kernel;
+            values[5] = (long long)(proc.cpu_percent * 10.0f + 0.5f);
+            *state = proc.state;
+            strcpy(name, proc.name);
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Vérifie tout le corpus et affiche les cas en échec
+ *
+ * @return Nombre de cas en échec
+ */
+static int bench_parsers_check(void) {
+    int failures = 0;
+    for (int i = 0; i < PARSER_CORPUS_SIZE; i++) {
+        const parser_case_t *c = &parser_corpus[i];
+        long long values[8];
+        char state;
+        char name[256];
+        int result = bench_parse_case(c, values, &state, name);
+
+        int ok = (result == c->result);
+        if (ok && result == 0) {
+            ok = memcmp(values, c->values, sizeof(values)) == 0 &&
+                 (!c->state || state == c->state) &&
+                 (!c->name || strcmp(name, c->name) == 0);
+        }
+        if (!ok) {
+            printf("  échec : cas %d (%s), retour %d, état '%c', nom \"%s\", valeurs %lld %lld %lld %lld %lld %lld %lld %lld\n",
+                   i, parser_names[c->parser], result, state ? state : ' ', name,
+                   values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7]);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/**
+ * @brief Mesure le débit de chaque analyseur sur les cas valides du corpus
+ */
+static void bench_parsers_throughput(void) {
+    printf(" analyseur            ns/appel    Mo/s\n");
+    for (int parser = 0; parser < PARSER_COUNT; parser++) {
+        const parser_case_t *cases[PARSER_CORPUS_SIZE];
+        int case_count = 0;
+        for (int i = 0; i < PARSER_CORPUS_SIZE; i++) {
+            if (parser_corpus[i].parser == parser && parser_corpus[i].result == 0) cases[case_count++] = &parser_corpus[i];
+        }
+        if (case_count == 0) continue;
+
+        long long values[8];
+        char state;
+        char name[256];
+        size_t bytes = 0;
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < BENCH_PARSER_ITERATIONS; i++) {
+            const parser_case_t *c = cases[i % case_count];
+            bench_parse_case(c, values, &state, name);
+            bytes += strlen(c->input);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double total_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+        printf(" %-20s %8.0f %7.1f\n", parser_names[parser], total_ns / BENCH_PARSER_ITERATIONS,
+               bytes / (total_ns / 1e9) / 1e6);
+    }
+}
+
+/**
+ * @brief Générateur pseudo-aléatoire de la boucle de fuzzing (xorshift32)
+ */
+static unsigned int bench_random(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+/**
+ * @brief Boucle de fuzzing par mutations des entrées du corpus
+ *
+ * Chaque entrée mutée (octets remplacés par des caractères significatifs
+ * pour les analyseurs, insérés, supprimés, ou troncature) est copiée dans
+ * un bloc alloué à sa taille exacte, pour qu'une lecture hors limites soit
+ * détectée par AddressSanitizer, puis passée à proc_parse_fuzz_one().
+ *
+ * @return Nombre d'entrées dont le résultat viole un invariant, -1 en cas d'erreur d'allocation
+ */
+static int bench_parsers_fuzz(void) {
+    static const char interesting[] = " ()\n\t-0123456789:|[]\0";
+    unsigned int seed = BENCH_FUZZ_SEED;
+    char work[1024];
+    int anomalies = 0;
+
+    for (int iteration = 0; iteration < BENCH_FUZZ_ITERATIONS; iteration++) {
+        const parser_case_t *c = &parser_corpus[bench_random(&seed) % PARSER_CORPUS_SIZE];
+        size_t len = strlen(c->input);
+        if (len > sizeof(work) - 8) len = sizeof(work) - 8;
+        work[0] = (char)c->parser;
+        memcpy(work + 1, c->input, len);
+        len++;
+
+        int mutations = 1 + bench_random(&seed) % 4;
+        for (int m = 0; m < mutations; m++) {
+            unsigned int r = bench_random(&seed);
+            size_t position = 1 + (len > 1 ? r % (len - 1) : 0);
+            char byte = (r & 0x100) ? interesting[(r >> 9) % (sizeof(interesting) - 1)] : (char)(r >> 16);
+            switch ((r >> 24) % 4) {
+                case 0:
+                    if (position < len) work[position] = byte;
+                    break;
+                case 1:
+                    if (len < sizeof(work) - 1) {
+                        memmove(work + position + 1, work + position, len - position);
+                        work[position] = byte;
+                        len++;
+                    }
+                    break;
+                case 2:
+                    if (position < len) {
+                        memmove(work + position, work + position + 1, len - position - 1);
+                        len--;
+                    }
+                    break;
+                default:
+                    len = position;
+                    break;
+            }
+        }
+
+        char *input = malloc(len);
+        if (!input) return -1;
+        memcpy(input, work, len);
+        if (proc_parse_fuzz_one(input, len) != 0) {
+            if (anomalies == 0) printf("  anomalie à l'itération %d (analyseur %s)\n", iteration, parser_names[c->parser]);
+            anomalies++;
+        }
+        free(input);
+    }
+    return anomalies;
+}
+
+/**
+ * @brief Écrit le corpus comme graines de la cible libFuzzer
+ *
+ * Un fichier par cas : premier octet = analyseur, puis l'entrée.
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int bench_parsers_export(const char *directory) {
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) return -1;
+
+    for (int i = 0; i < PARSER_CORPUS_SIZE; i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/seed-%02d", directory, i);
+        FILE *file = fopen(path, "wb");
+        if (!file) return -1;
+        fputc(parser_corpus[i].parser, file);
+        fputs(parser_corpus[i].input, file);
+        if (fclose(file) != 0) return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Vérifie, mesure et fuzze les analyseurs de /proc et de ps
+ *
+ * @param corpus_dir Répertoire où écrire les graines de fuzzing, NULL pour aucun
+ * @return 0 si le corpus et le fuzzing sont sans échec, 1 sinon
+ */
+int bench_parsers(const char *corpus_dir) {
+    int failures = bench_parsers_check();
+    printf("Analyseurs : corpus de %d cas, %d échec(s)\n", PARSER_CORPUS_SIZE, failures);
+
+    bench_parsers_throughput();
+
+    int anomalies = bench_parsers_fuzz();
+    if (anomalies < 0) {
+        fprintf(stderr, "Fuzzing impossible\n");
+        return 1;
+    }
+    printf("Fuzzing : %d entrées mutées (graine %#x), %d anomalie(s)\n",
+           BENCH_FUZZ_ITERATIONS, BENCH_FUZZ_SEED, anomalies);
+
+    if (corpus_dir && corpus_dir[0]) {
+        if (bench_parsers_export(corpus_dir) != 0) {
+            fprintf(stderr, "Impossible d'écrire le corpus dans %s\n", corpus_dir);
+            return 1;
+        }
+        printf("Corpus écrit dans %s\n", corpus_dir);
+    }
+    return (failures > 0 || anomalies > 0) ? 1 : 0;
+}
+
+/**
+ * @brief Lance le benchmark de collecte sur 1, 10 et 100 hôtes simulés
+ *
+ * @param spec Paramètres des hôtes simulés (latence, gigue, échecs, processus), NULL pour les valeurs par défaut
+ * @return 0 en cas de succès, 1 en cas d'erreur
+ */
+int bench_run(const char *spec) {
+    static const int host_counts[] = { 1, 10, 100 };
+    if (!spec || !spec[0]) spec = BENCH_DEFAULT_SPEC;
+
+    mock_spec_t parsed;
+    mock_spec_parse(spec, &parsed);
+    printf("Hôtes simulés : latence %d ms (+/- %d), échecs %.0f%%, %d processus, %d tours, %d collectes simultanées au plus\n",
+           parsed.latency_ms, parsed.jitter_ms, parsed.failure_rate * 100.0, parsed.process_count,
+           BENCH_ROUNDS, POLLER_MAX_WORKERS);
+    printf(" hôtes  succès  échecs  p50(ms)  p95(ms)  max(ms)  tour(ms)  instant./s\n");
+
+    for (size_t i = 0; i < sizeof(host_counts) / sizeof(host_counts[0]); i++) {
+        if (bench_hosts(host_counts[i], spec) != 0) {
+            fprintf(stderr, "Benchmark impossible pour %d hôtes\n", host_counts[i]);
+            return 1;
+        }
+    }
+
+    if (bench_alerts() != 0) {
+        fprintf(stderr, "Benchmark des alertes impossible\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,413 @@
+#define _GNU_SOURCE
+#include "cgroup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+// Compteurs cumulés d'un cgroup, gardés d'une lecture à l'autre pour les débits
+typedef struct {
+    char path[256];
+    unsigned long long usage_usec;
+    unsigned long long throttled_usec;
+    unsigned long long nr_throttled;
+    unsigned long long read_bytes;
+    unsigned long long write_bytes;
+} cgroup_sample_t;
+
+// Cgroup d'un processus, lu une fois dans /proc/[pid]/cgroup
+typedef struct {
+    int pid;
+    float time;          // Âge du processus à la lecture : détecte la réutilisation du PID
+    char path[256];
+} cgroup_owner_t;
+
+// Lecture en cours : cgroups trouvés et leurs compteurs bruts
+typedef struct {
+    const char *root;
+    cgroup_info_t *list;
+    cgroup_sample_t *raw;
+    int count;
+    int capacity;
+} cgroup_walk_t;
+
+// Échantillons de la lecture précédente, triés par chemin
+static cgroup_sample_t *samples = NULL;
+static int sample_count = 0;
+static struct timespec sample_time;
+
+// Cache PID -> cgroup, trié par PID (appelé depuis la boucle d'affichage uniquement)
+static cgroup_owner_t *owners = NULL;
+static int owner_count = 0;
+
+/**
+ * @brief Retourne la racine de la hiérarchie cgroup v2
+ *
+ * @return CGROUP_ROOT si la hiérarchie unifiée y est montée, CGROUP_ROOT/unified
+ *         en mode hybride, NULL si cgroup v2 n'est pas disponible
+ */
+static const char *cgroup_root(void) {
+    if (access(CGROUP_ROOT "/cgroup.controllers", F_OK) == 0) return CGROUP_ROOT;
+    if (access(CGROUP_ROOT "/unified/cgroup.controllers", F_OK) == 0) return CGROUP_ROOT "/unified";
+    return NULL;
+}
+
+/**
+ * @brief Lit un petit fichier de /sys ou /proc en un seul appel
+ *
+ * @return Nombre d'octets lus (texte terminé par '\0'), -1 si le fichier est absent
+ */
+static int read_small_file(const char *path, char *buffer, size_t size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    ssize_t n = read(fd, buffer, size - 1);
+    close(fd);
+    if (n < 0) return -1;
+    buffer[n] = '\0';
+    return (int)n;
+}
+
+/**
+ * @brief Valeur d'un champ "clé valeur" (cpu.stat, memory.stat)
+ *
+ * @return La valeur, 0 si le champ est absent
+ */
+static unsigned long long stat_field(const char *text, const char *key) {
+    size_t key_len = strlen(key);
+    const char *line = text;
+    while (line && *line) {
+        if (strncmp(line, key, key_len) == 0 && line[key_len] == ' ') {
+            return strtoull(line + key_len + 1, NULL, 10);
+        }
+        line = strchr(line, '\n');
+        if (line) line++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Somme d'un champ "clé=valeur" sur tous les périphériques de io.stat
+ */
+static unsigned long long io_stat_total(const char *text, const char *key) {
+    unsigned long long total = 0;
+    size_t key_len = strlen(key);
+    const char *p = text;
+    while ((p = strstr(p, key)) != NULL) {
+        if ((p == text || p[-1] == ' ') && p[key_len] == '=') {
+            total += strtoull(p + key_len + 1, NULL, 10);
+        }
+        p += key_len;
+    }
+    return total;
+}
+
+/**
+ * @brief Lit les fichiers d'un cgroup et l'ajoute à la liste
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int cgroup_read(cgroup_walk_t *walk, const char *relative, int depth) {
+    if (walk->count >= walk->capacity) {
+        int capacity = walk->capacity ? walk->capacity * 2 : 64;
+        cgroup_info_t *list = realloc(walk->list, sizeof(cgroup_info_t) * capacity);
+        if (!list) return -1;
+        walk->list = list;
+        cgroup_sample_t *raw = realloc(walk->raw, sizeof(cgroup_sample_t) * capacity);
+        if (!raw) return -1;
+        walk->raw = raw;
+        walk->capacity = capacity;
+    }
+
+    cgroup_info_t *info = &walk->list[walk->count];
+    cgroup_sample_t *raw = &walk->raw[walk->count];
+    memset(info, 0, sizeof(cgroup_info_t));
+    memset(raw, 0, sizeof(cgroup_sample_t));
+    snprintf(info->path, sizeof(info->path), "%s", relative[0] ? relative : "/");
+    snprintf(raw->path, sizeof(raw->path), "%s", info->path);
+    info->depth = depth;
+
+    char path[512];
+    char buffer[4096];
+
+    snprintf(path, sizeof(path), "%s%s/cpu.stat", walk->root, relative);
+    if (read_small_file(path, buffer, sizeof(buffer)) > 0) {
+        raw->usage_usec = stat_field(buffer, "usage_usec");
+        raw->throttled_usec = stat_field(buffer, "throttled_usec");
+        raw->nr_throttled = stat_field(buffer, "nr_throttled");
+    }
+
+    snprintf(path, sizeof(path), "%s%s/memory.current", walk->root, relative);
+    if (read_small_file(path, buffer, sizeof(buffer)) > 0) {
+        info->memory_kb = (long)(strtoull(buffer, NULL, 10) / 1024);
+    }
+
+    snprintf(path, sizeof(path), "%s%s/memory.stat", walk->root, relative);
+    if (read_small_file(path, buffer, sizeof(buffer)) > 0) {
+        info->anon_kb = (long)(stat_field(buffer, "anon") / 1024);
+        info->file_kb = (long)(stat_field(buffer, "file") / 1024);
+    }
+
+    snprintf(path, sizeof(path), "%s%s/io.stat", walk->root, relative);
+    if (read_small_file(path, buffer, sizeof(buffer)) > 0) {
+        raw->read_bytes = io_stat_total(buffer, "rbytes");
+        raw->write_bytes = io_stat_total(buffer, "wbytes");
+    }
+
+    walk->count++;
+    return 0;
+}
+
+/**
+ * @brief Parcourt un cgroup et ses sous-groupes (parent avant enfants)
+ */
+static int cgroup_walk(cgroup_walk_t *walk, const char *relative, int depth) {
+    if (cgroup_read(walk, relative, depth) != 0) return -1;
+    if (depth >= CGROUP_MAX_DEPTH) return 0;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s", walk->root, relative);
+    DIR *directory = opendir(path);
+    if (!directory) return 0;
+
+    struct dirent *entry;
+    while ((entry = readdir(directory)) != NULL) {
+        if (entry->d_type != DT_DIR || entry->d_name[0] == '.') continue;
+
+        char child[256];
+        if (snprintf(child, sizeof(child), "%s/%s", relative, entry->d_name) >= (int)sizeof(child)) continue;
+        if (cgroup_walk(walk, child, depth + 1) != 0) {
+            closedir(directory);
+            return -1;
+        }
+    }
+    closedir(directory);
+    return 0;
+}
+
+static int compare_sample_path(const void *a, const void *b) {
+    return strcmp(((const cgroup_sample_t *)a)->path, ((const cgroup_sample_t *)b)->path);
+}
+
+static unsigned long long counter_delta(unsigned long long current, unsigned long long previous) {
+    return current >= previous ? current - previous : 0;
+}
+
+/**
+ * @brief Récupère la liste des cgroups et leurs débits depuis la lecture précédente
+ *
+ * À la première lecture (ou pour un cgroup nouveau), les débits sont nuls.
+ *
+ * @param list Pointeur qui recevra la liste allouée (à libérer)
+ * @param count Pointeur qui recevra le nombre de cgroups
+ * @return 0 en cas de succès, -1 si cgroup v2 n'est pas disponible ou en cas d'erreur
+ */
+int get_cgroup_list(cgroup_info_t **list, int *count) {
+    const char *root = cgroup_root();
+    if (!root) return -1;
+
+    cgroup_walk_t walk = { root, NULL, NULL, 0, 0 };
+    if (cgroup_walk(&walk, "", 0) != 0) {
+        free(walk.list);
+        free(walk.raw);
+        return -1;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed_us = 0.0;
+    if (samples) {
+        elapsed_us = (now.tv_sec - sample_time.tv_sec) * 1e6 + (now.tv_nsec - sample_time.tv_nsec) / 1e3;
+    }
+
+    for (int i = 0; i < walk.count && elapsed_us > 0.0; i++) {
+        const cgroup_sample_t *previous = bsearch(&walk.raw[i], samples, sample_count,
+                                                  sizeof(cgroup_sample_t), compare_sample_path);
+        if (!previous) continue;
+
+        const cgroup_sample_t *current = &walk.raw[i];
+        cgroup_info_t *info = &walk.list[i];
+        info->cpu_percent = counter_delta(current->usage_usec, previous->usage_usec) * 100.0 / elapsed_us;
+        info->throttled_percent = counter_delta(current->throttled_usec, previous->throttled_usec) * 100.0 / elapsed_us;
+        info->nr_throttled = (unsigned long)counter_delta(current->nr_throttled, previous->nr_throttled);
+        info->io_read_kbps = counter_delta(current->read_bytes, previous->read_bytes) / 1024.0 / (elapsed_us / 1e6);
+        info->io_write_kbps = counter_delta(current->write_bytes, previous->write_bytes) / 1024.0 / (elapsed_us / 1e6);
+    }
+
+    // Les compteurs de cette lecture deviennent la référence de la suivante
+    qsort(walk.raw, walk.count, sizeof(cgroup_sample_t), compare_sample_path);
+    free(samples);
+    samples = walk.raw;
+    sample_count = walk.count;
+    sample_time = now;
+
+    *list = walk.list;
+    *count = walk.count;
+    return 0;
+}
+
+static int compare_owner_pid(const void *a, const void *b) {
+    int pid_a = ((const cgroup_owner_t *)a)->pid;
+    int pid_b = ((const cgroup_owner_t *)b)->pid;
+    return (pid_a > pid_b) - (pid_a < pid_b);
+}
+
+static const cgroup_owner_t *owner_find(int pid) {
+    if (!owners) return NULL;
+
+    cgroup_owner_t key;
+    key.pid = pid;
+    return bsearch(&key, owners, owner_count, sizeof(cgroup_owner_t), compare_owner_pid);
+}
+
+/**
+ * @brief Lit le cgroup v2 d'un processus (ligne "0::/chemin" de /proc/[pid]/cgroup)
+ *
+ * @return 0 en cas de succès, -1 si le processus a disparu ou n'a pas de cgroup v2
+ */
+static int read_process_cgroup(int pid, char *path, size_t size) {
+    char filename[64];
+    char buffer[4096];
+    snprintf(filename, sizeof(filename), "/proc/%d/cgroup", pid);
+    if (read_small_file(filename, buffer, sizeof(buffer)) <= 0) return -1;
+
+    char *line = buffer;
+    while (line && *line) {
+        char *next = strchr(line, '\n');
+        if (next) *next++ = '\0';
+        if (strncmp(line, "0::", 3) == 0) {
+            snprintf(path, size, "%s", line + 3);
+            return 0;
+        }
+        line = next;
+    }
+    return -1;
+}
+
+static int compare_info_path(const void *a, const void *b, void *context) {
+    const cgroup_info_t *list = context;
+    return strcmp(list[*(const int *)a].path, list[*(const int *)b].path);
+}
+
+/**
+ * @brief Recherche dichotomique d'un cgroup par chemin
+ *
+ * @return Index du cgroup dans list, -1 s'il est absent
+ */
+static int find_info_path(const cgroup_info_t *list, const int *by_path, int count, const char *path) {
+    int low = 0;
+    int high = count - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        int order = strcmp(list[by_path[middle]].path, path);
+        if (order == 0) return by_path[middle];
+        if (order < 0) low = middle + 1; else high = middle - 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief Rattache chaque processus à son cgroup et compte les processus par cgroup
+ *
+ * Le cgroup d'un PID n'est lu qu'une fois ; il est relu si le PID a été
+ * réutilisé (processus plus jeune que lors de la lecture). Les processus
+ * disparus quittent le cache.
+ *
+ * @param list Cgroups obtenus par get_cgroup_list()
+ * @param count Nombre de cgroups
+ * @param procs Liste des processus locaux
+ * @param proc_count Nombre de processus
+ */
+void cgroup_count_processes(cgroup_info_t *list, int count, const process_info_t *procs, int proc_count) {
+    cgroup_owner_t *updated = malloc(sizeof(cgroup_owner_t) * (proc_count > 0 ? proc_count : 1));
+    if (!updated) return;
+
+    int updated_count = 0;
+    for (int i = 0; i < proc_count; i++) {
+        cgroup_owner_t *owner = &updated[updated_count];
+        const cgroup_owner_t *cached = owner_find(procs[i].pid);
+        if (cached && cached->time <= procs[i].time + 1.0f) {
+            *owner = *cached;
+        } else {
+            owner->pid = procs[i].pid;
+            if (read_process_cgroup(procs[i].pid, owner->path, sizeof(owner->path)) != 0) continue;
+        }
+        owner->time = procs[i].time;
+        updated_count++;
+    }
+
+    qsort(updated, updated_count, sizeof(cgroup_owner_t), compare_owner_pid);
+    free(owners);
+    owners = updated;
+    owner_count = updated_count;
+
+    // Chaque processus compte pour son cgroup et tous ses parents
+    int *by_path = malloc(sizeof(int) * (count > 0 ? count : 1));
+    if (!by_path) return;
+    for (int i = 0; i < count; i++) {
+        by_path[i] = i;
+        list[i].process_count = 0;
+    }
+    qsort_r(by_path, count, sizeof(int), compare_info_path, list);
+
+    for (int i = 0; i < owner_count; i++) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s", owners[i].path);
+        for (;;) {
+            int index = find_info_path(list, by_path, count, path);
+            if (index >= 0) list[index].process_count++;
+            if (strcmp(path, "/") == 0) break;
+
+            char *slash = strrchr(path, '/');
+            if (slash == path) slash[1] = '\0'; else *slash = '\0';
+        }
+    }
+    free(by_path);
+}
+
+/**
+ * @brief Extrait les processus d'un cgroup et de ses sous-groupes
+ *
+ * Utilise le cache rempli par cgroup_count_processes().
+ *
+ * @param path Chemin du cgroup ("/" pour tous les processus)
+ * @param procs Liste des processus locaux
+ * @param proc_count Nombre de processus
+ * @param list Pointeur qui recevra la liste allouée (à libérer)
+ * @param count Pointeur qui recevra le nombre de processus retenus
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+int cgroup_filter_processes(const char *path, const process_info_t *procs, int proc_count,
+                            process_info_t **list, int *count) {
+    *list = malloc(sizeof(process_info_t) * (proc_count > 0 ? proc_count : 1));
+    if (!*list) return -1;
+
+    int all = strcmp(path, "/") == 0;
+    size_t path_len = strlen(path);
+    int n = 0;
+    for (int i = 0; i < proc_count; i++) {
+        const cgroup_owner_t *owner = owner_find(procs[i].pid);
+        if (!owner) continue;
+        if (all || (strncmp(owner->path, path, path_len) == 0 &&
+                    (owner->path[path_len] == '\0' || owner->path[path_len] == '/'))) {
+            (*list)[n++] = procs[i];
+        }
+    }
+    *count = n;
+    return 0;
+}
+
+/**
+ * @brief Libère les échantillons et le cache des cgroups
+ */
+void cgroup_cleanup(void) {
+    free(samples);
+    samples = NULL;
+    sample_count = 0;
+    free(owners);
+    owners = NULL;
+    owner_count = 0;
+}
@@ -0,0 +1,272 @@
+#include "collector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "agent.h"
+#include "arena.h"
+#include "agent_client.h"
+#include "remote_proc.h"
+#include "shm.h"
+#include "filter.h"
+
+static int procfs_sample(void *context, process_info_t **list, int *count) {
+    (void)context;
+    return get_process_list(list, count);
+}
+
+static int remote_sample(void *context, process_info_t **list, int *count) {
+    return remote_ps_fetch(context, list, count);
+}
+
+static int remote_proc_sample(void *context, process_info_t **list, int *count) {
+    return remote_proc_fetch(context, list, count);
+}
+
+static void remote_proc_shutdown(void *context) {
+    remote_proc_forget(context);
+}
+
+static int agent_sample(void *context, process_info_t **list, int *count) {
+    return agent_client_fetch(context, list, count);
+}
+
+static void agent_shutdown(void *context) {
+    agent_client_close(context);
+}
+
+// Rejeu : enregistrement chargé en mémoire et instantanés déjà décodés
+typedef struct {
+    unsigned char *data;
+    size_t len;
+    size_t offset;                                 // Prochaine trame à rejouer
+    agent_snapshot_t history[AGENT_HISTORY_SIZE];  // Bases possibles des trames delta
+} replay_state_t;
+
+static void replay_rewind(replay_state_t *state) {
+    state->offset = 0;
+    for (int i = 0; i < AGENT_HISTORY_SIZE; i++) agent_snapshot_free(&state->history[i]);
+}
+
+/**
+ * @brief Charge un enregistrement de l'agent (chemin dans le champ adresse)
+ *
+ * @return 0 en cas de succès, -1 si le fichier est illisible ou vide
+ */
+static int replay_init(const host_config_t *host, void **context) {
+    FILE *file = fopen(host->address, "rb");
+    if (!file) {
+        network_set_error("replay : %s illisible", host->address);
+        return -1;
+    }
+
+    replay_state_t *state = calloc(1, sizeof(replay_state_t));
+    size_t capacity = 0;
+    for (;;) {
+        if (!state) break;
+        if (state->len == capacity) {
+            size_t new_capacity = capacity ? capacity * 2 : 65536;
+            unsigned char *tmp = realloc(state->data, new_capacity);
+            if (!tmp) break;
+            state->data = tmp;
+            capacity = new_capacity;
+        }
+        size_t n = fread(state->data + state->len, 1, capacity - state->len, file);
+        if (n == 0) break;
+        state->len += n;
+    }
+    fclose(file);
+
+    if (!state || state->len == 0) {
+        if (state) free(state->data);
+        free(state);
+        network_set_error("replay : enregistrement vide");
+        return -1;
+    }
+
+    *context = state;
+    return 0;
+}
+
+/**
+ * @brief Rejoue l'instantané suivant de l'enregistrement
+ *
+ * Les trames sont rejouées une par collecte, dans l'ordre, puis depuis le
+ * début. Un delta dont la base n'a pas été rejouée est sauté.
+ */
+static int replay_sample(void *context, process_info_t **list, int *count) {
+    replay_state_t *state = context;
+    int rewinds = 0;
+
+    for (;;) {
+        long frame_len = (state->offset < state->len)
+                       ? agent_frame_length(state->data + state->offset, state->len - state->offset) : 0;
+        if (frame_len <= 0) {
+            // Fin (ou trame tronquée) : reprendre au début, une seule fois par collecte
+            if (rewinds++ > 0) {
+                network_set_error("replay : aucune trame lisible");
+                return -1;
+            }
+            replay_rewind(state);
+            continue;
+        }
+
+        const unsigned char *frame = state->data + state->offset;
+        state->offset += (size_t)frame_len;
+
+        long base_sequence = agent_frame_base(frame, (size_t)frame_len);
+        const agent_snapshot_t *base = NULL;
+        if (base_sequence > 0) {
+            base = &state->history[base_sequence % AGENT_HISTORY_SIZE];
+            if (!base->list || base->sequence != (unsigned int)base_sequence) continue;
+        } else if (base_sequence < 0) {
+            continue;
+        }
+
+        agent_snapshot_t snapshot;
+        if (agent_decode_frame(frame, (size_t)frame_len, base, &snapshot) != 0) continue;
+
+        agent_snapshot_t *slot = &state->history[snapshot.sequence % AGENT_HISTORY_SIZE];
+        agent_snapshot_free(slot);
+        *slot = snapshot;
+
+        *list = snapshot_alloc(sizeof(process_info_t) * (slot->count > 0 ? slot->count : 1));
+        if (!*list) return -1;
+        memcpy(*list, slot->list, sizeof(process_info_t) * slot->count);
+        *count = slot->count;
+        return 0;
+    }
+}
+
+static void replay_shutdown(void *context) {
+    replay_state_t *state = context;
+    replay_rewind(state);
+    free(state->data);
+    free(state);
+}
+
+static int shm_init(const host_config_t *host, void **context) {
+    shm_reader_t *reader = malloc(sizeof(shm_reader_t));
+    if (!reader) return -1;
+    shm_reader_init(reader, host->address);
+    *context = reader;
+    return 0;
+}
+
+static int shm_sample(void *context, process_info_t **list, int *count) {
+    return shm_read(context, list, count);
+}
+
+static void shm_shutdown(void *context) {
+    shm_reader_close(context);
+    free(context);
+}
+
+static const collector_backend_t procfs_backend = {
+    "procfs", COLLECTOR_CAP_INSTANT_CPU | COLLECTOR_CAP_ACTIONS | COLLECTOR_CAP_FILTERED,
+    NULL, procfs_sample, NULL
+};
+
+static const collector_backend_t remote_backend = {
+    "remote", COLLECTOR_CAP_REMOTE | COLLECTOR_CAP_ACTIONS,
+    NULL, remote_sample, NULL
+};
+
+static const collector_backend_t remote_proc_backend = {
+    "remote-proc", COLLECTOR_CAP_INSTANT_CPU | COLLECTOR_CAP_REMOTE | COLLECTOR_CAP_ACTIONS,
+    NULL, remote_proc_sample, remote_proc_shutdown
+};
+
+static const collector_backend_t agent_backend = {
+    "agent", COLLECTOR_CAP_INSTANT_CPU | COLLECTOR_CAP_REMOTE | COLLECTOR_CAP_ACTIONS | COLLECTOR_CAP_PUSH,
+    NULL, agent_sample, agent_shutdown
+};
+
+static const collector_backend_t replay_backend = {
+    "replay", COLLECTOR_CAP_INSTANT_CPU,
+    replay_init, replay_sample, replay_shutdown
+};
+
+// Processus de la machine locale : les actions restent possibles
+static const collector_backend_t shm_backend = {
+    "shm", COLLECTOR_CAP_INSTANT_CPU | COLLECTOR_CAP_ACTIONS,
+    shm_init, shm_sample, shm_shutdown
+};
+
+/**
+ * @brief Choisit le backend de collecte d'un hôte
+ *
+ * L'agent n'est disponible que sur SSH ; sur un autre transport, le mode
+ * agent retombe sur ps.
+ *
+ * @param host Configuration de l'hôte
+ * @return Le backend, ou NULL si l'hôte n'a pas de source utilisable
+ */
+const collector_backend_t *collector_backend_for(const host_config_t *host) {
+    if (!host) return NULL;
+    if (host->type == CONNECTION_SHM) return &shm_backend;
+    if (host->is_local) return &procfs_backend;
+    if (host->type == CONNECTION_REPLAY) return &replay_backend;
+    if (!transport_for(host)) return NULL;
+
+    if (host->mode == COLLECT_AGENT && host->type == CONNECTION_SSH) return &agent_backend;
+    if (host->mode == COLLECT_PROC) return &remote_proc_backend;
+    return &remote_backend;
+}
+
+/**
+ * @brief Ouvre le collecteur d'un hôte
+ *
+ * @param collector Collecteur à initialiser (backend NULL en cas d'échec)
+ * @param host Configuration de l'hôte (doit rester valide jusqu'à collector_close())
+ * @return 0 en cas de succès, -1 si l'hôte n'a pas de source ou si son initialisation échoue
+ */
+int collector_open(collector_t *collector, const host_config_t *host) {
+    collector->backend = NULL;
+    collector->context = NULL;
+
+    const collector_backend_t *backend = collector_backend_for(host);
+    if (!backend) return -1;
+
+    if (backend->init) {
+        if (backend->init(host, &collector->context) != 0) return -1;
+    } else {
+        collector->context = (void *)host;
+    }
+    collector->backend = backend;
+    return 0;
+}
+
+/**
+ * @brief Collecte la liste des processus d'une source ouverte
+ *
+ * @param collector Collecteur ouvert par collector_open()
+ * @param list Pointeur qui recevra la liste allouée (à libérer)
+ * @param count Pointeur qui recevra le nombre de processus
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int collector_sample(collector_t *collector, process_info_t **list, int *count) {
+    if (!collector->backend) {
+        network_set_error("source indisponible");
+        return -1;
+    }
+    int result = collector->backend->sample(collector->context, list, count);
+
+    // Sources sans filtrage à la collecte : liste reçue filtrée ici (l'agent
+    // a déjà filtré de son côté, uid compris : le refiltrage ne retire rien)
+    const filter_t *filter = process_get_filter();
+    if (result == 0 && filter && !(collector->backend->capabilities & COLLECTOR_CAP_FILTERED)) {
+        *count = filter_apply(filter, *list, *count, FILTER_FIELDS_REMOTE);
+    }
+    return result;
+}
+
+/**
+ * @brief Ferme un collecteur et libère l'état de son backend
+ */
+void collector_close(collector_t *collector) {
+    if (collector->backend && collector->backend->shutdown) {
+        collector->backend->shutdown(collector->context);
+    }
+    collector->backend = NULL;
+    collector->context = NULL;
+}
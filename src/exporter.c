@@ -0,0 +1,480 @@
+#define _GNU_SOURCE
+#include "exporter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define EXPORTER_BUFFER_SIZE 16384
+#define EXPORTER_LINE_MAX 1024  // Une ligne de métrique tient toujours dans cette place
+
+typedef struct {
+    int top;
+    int by_mem;
+    char host[64];
+    char name[64];
+} exporter_query_t;
+
+// Réponse écrite par blocs : jamais construite en entier en mémoire
+typedef struct {
+    int fd;
+    char buffer[EXPORTER_BUFFER_SIZE];
+    size_t used;
+    int failed;      // Client parti ou trop lent : la suite est ignorée
+} exporter_stream_t;
+
+static void stream_flush(exporter_stream_t *stream) {
+    size_t sent = 0;
+    while (!stream->failed && sent < stream->used) {
+        ssize_t n = send(stream->fd, stream->buffer + sent, stream->used - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) stream->failed = 1;
+        else sent += (size_t)n;
+    }
+    stream->used = 0;
+}
+
+static void stream_printf(exporter_stream_t *stream, const char *format, ...) {
+    if (stream->failed) return;
+    if (sizeof(stream->buffer) - stream->used < EXPORTER_LINE_MAX) stream_flush(stream);
+
+    size_t room = sizeof(stream->buffer) - stream->used;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(stream->buffer + stream->used, room, format, args);
+    va_end(args);
+    if (n > 0) stream->used += ((size_t)n < room) ? (size_t)n : room - 1;
+}
+
+/**
+ * @brief Copie une valeur de label en l'échappant (\, " et retour à la ligne)
+ *
+ * Les caractères non imprimables sont remplacés par '_' et la valeur est
+ * coupée à max_chars caractères.
+ */
+static void escape_label(char *out, size_t size, const char *value, size_t max_chars) {
+    size_t used = 0;
+    for (size_t i = 0; value[i] && i < max_chars && used + 3 < size; i++) {
+        unsigned char c = (unsigned char)value[i];
+        if (c == '\\' || c == '"') {
+            out[used++] = '\\';
+            out[used++] = (char)c;
+        } else if (c == '\n') {
+            out[used++] = '\\';
+            out[used++] = 'n';
+        } else {
+            out[used++] = (c < 0x20 || c >= 0x7f) ? '_' : (char)c;
+        }
+    }
+    out[used] = '\0';
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Décode une valeur de la chaîne de requête (%XX et '+')
+static void url_decode(char *out, size_t size, const char *value, size_t length) {
+    size_t used = 0;
+    for (size_t i = 0; i < length && used + 1 < size; i++) {
+        if (value[i] == '+') {
+            out[used++] = ' ';
+        } else if (value[i] == '%' && i + 2 < length && hex_value(value[i + 1]) >= 0 && hex_value(value[i + 2]) >= 0) {
+            out[used++] = (char)(hex_value(value[i + 1]) * 16 + hex_value(value[i + 2]));
+            i += 2;
+        } else {
+            out[used++] = value[i];
+        }
+    }
+    out[used] = '\0';
+}
+
+/**
+ * @brief Lit la ligne de requête "GET /metrics?... HTTP/1.x"
+ *
+ * @return 0 pour /metrics, -1 pour toute autre requête
+ */
+static int parse_request(const char *request, exporter_query_t *query) {
+    memset(query, 0, sizeof(exporter_query_t));
+    query->top = EXPORTER_DEFAULT_TOP;
+
+    if (strncmp(request, "GET ", 4) != 0) return -1;
+    const char *path = request + 4;
+    size_t path_length = strcspn(path, " \r\n");
+    size_t route_length = strcspn(path, "? \r\n");
+    if (route_length != 8 || strncmp(path, "/metrics", 8) != 0) return -1;
+
+    const char *params = path + route_length;
+    const char *end = path + path_length;
+    while (params < end) {
+        params++;  // '?' ou '&'
+        size_t length = strcspn(params, "& \r\n");
+        const char *equal = memchr(params, '=', length);
+        if (equal) {
+            size_t key_length = (size_t)(equal - params);
+            char value[64];
+            url_decode(value, sizeof(value), equal + 1, length - key_length - 1);
+            if (key_length == 3 && strncmp(params, "top", 3) == 0) {
+                query->top = atoi(value);
+                if (query->top < 0) query->top = 0;
+                if (query->top > EXPORTER_MAX_TOP) query->top = EXPORTER_MAX_TOP;
+            } else if (key_length == 4 && strncmp(params, "sort", 4) == 0) {
+                query->by_mem = strcmp(value, "mem") == 0;
+            } else if (key_length == 4 && strncmp(params, "host", 4) == 0) {
+                snprintf(query->host, sizeof(query->host), "%s", value);
+            } else if (key_length == 4 && strncmp(params, "name", 4) == 0) {
+                snprintf(query->name, sizeof(query->name), "%s", value);
+            }
+        }
+        params += length;
+    }
+    return 0;
+}
+
+/**
+ * @brief Retient les processus exportés d'un instantané (ordre du tri demandé)
+ *
+ * @return Nombre d'index écrits dans selected (max au plus)
+ */
+static int select_processes(const poller_snapshot_t *snapshot, const exporter_query_t *query,
+                            int *selected, int max) {
+    const int *order = query->by_mem ? snapshot->by_mem : snapshot->by_cpu;
+    int count = 0;
+    for (int i = 0; i < snapshot->count && count < max; i++) {
+        int index = order ? order[i] : i;
+        if (query->name[0] && !strstr(snapshot->list[index].name, query->name)) continue;
+        selected[count++] = index;
+    }
+    return count;
+}
+
+static void write_family(exporter_stream_t *stream, const char *name, const char *type, const char *help) {
+    stream_printf(stream, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+/**
+ * @brief Écrit toutes les métriques demandées
+ *
+ * Les instantanés des hôtes retenus sont tenus pendant toute l'écriture :
+ * toutes les familles décrivent les mêmes instantanés, et le poller en
+ * prépare de nouveaux dans d'autres arènes en attendant.
+ */
+static void write_metrics(exporter_t *exporter, exporter_stream_t *stream, const exporter_query_t *query) {
+    int host_count = exporter->network->count;
+    poller_snapshot_t **snapshots = calloc(host_count, sizeof(poller_snapshot_t *));
+    host_health_t *health = calloc(host_count, sizeof(host_health_t));
+    char (*labels)[192] = calloc(host_count, sizeof(*labels));
+    int *selected = malloc(sizeof(int) * (EXPORTER_MAX_SERIES + 1));
+    int *selected_start = calloc(host_count + 1, sizeof(int));
+    if (!snapshots || !health || !labels || !selected || !selected_start) {
+        free(snapshots);
+        free(health);
+        free(labels);
+        free(selected);
+        free(selected_start);
+        return;
+    }
+
+    int truncated = 0;
+    int series = 0;
+    for (int i = 0; i < host_count; i++) {
+        selected_start[i] = series;
+        const char *name = exporter->network->hosts[i].name;
+        if (query->host[0] && strcmp(query->host, name) != 0) continue;
+
+        char host[160];
+        escape_label(host, sizeof(host), name, 64);
+        snprintf(labels[i], sizeof(labels[i]), "host=\"%s\"", host);
+        poller_get_health(exporter->poller, i, &health[i]);
+
+        unsigned long generation = 0;
+        snapshots[i] = poller_acquire_snapshot(exporter->poller, i, &generation);
+        if (!snapshots[i]) continue;
+
+        int budget = EXPORTER_MAX_SERIES - series;
+        int wanted = query->top < budget ? query->top : budget;
+        int count = select_processes(snapshots[i], query, selected + series, wanted + 1);
+        if (count > budget) truncated = 1;
+        series += (count < wanted) ? count : wanted;
+    }
+    selected_start[host_count] = series;
+
+    write_family(stream, "gestion_host_up", "gauge", "Hôte joignable (up ou degraded)");
+    for (int i = 0; i < host_count; i++) {
+        if (!labels[i][0]) continue;
+        int up = health[i].status == HOST_STATUS_UP || health[i].status == HOST_STATUS_DEGRADED;
+        stream_printf(stream, "gestion_host_up{%s} %d\n", labels[i], up);
+    }
+
+    write_family(stream, "gestion_host_rtt_ms", "gauge", "Délai avant le premier octet, lissé");
+    for (int i = 0; i < host_count; i++) {
+        if (labels[i][0] && health[i].rtt_ms >= 0) {
+            stream_printf(stream, "gestion_host_rtt_ms{%s} %d\n", labels[i], health[i].rtt_ms);
+        }
+    }
+
+    write_family(stream, "gestion_host_fetch_ms", "gauge", "Durée de la dernière collecte");
+    for (int i = 0; i < host_count; i++) {
+        if (labels[i][0]) stream_printf(stream, "gestion_host_fetch_ms{%s} %d\n", labels[i], health[i].fetch_ms);
+    }
+
+    write_family(stream, "gestion_host_fetch_success_total", "counter", "Collectes réussies");
+    for (int i = 0; i < host_count; i++) {
+        if (labels[i][0]) {
+            stream_printf(stream, "gestion_host_fetch_success_total{%s} %lu\n", labels[i], health[i].success_count);
+        }
+    }
+
+    write_family(stream, "gestion_host_fetch_failure_total", "counter", "Collectes en échec");
+    for (int i = 0; i < host_count; i++) {
+        if (labels[i][0]) {
+            stream_printf(stream, "gestion_host_fetch_failure_total{%s} %lu\n", labels[i], health[i].failure_count);
+        }
+    }
+
+    write_family(stream, "gestion_host_processes", "gauge", "Processus du dernier instantané");
+    for (int i = 0; i < host_count; i++) {
+        if (snapshots[i]) stream_printf(stream, "gestion_host_processes{%s} %d\n", labels[i], snapshots[i]->count);
+    }
+
+    write_family(stream, "gestion_host_cpu_percent", "gauge", "Somme du CPU des processus, en % d'un cœur");
+    for (int i = 0; i < host_count; i++) {
+        if (!snapshots[i]) continue;
+        double total = 0.0;
+        for (int p = 0; p < snapshots[i]->count; p++) total += snapshots[i]->list[p].cpu_percent;
+        stream_printf(stream, "gestion_host_cpu_percent{%s} %.1f\n", labels[i], total);
+    }
+
+    write_family(stream, "gestion_host_memory_kb", "gauge", "Somme de la mémoire résidente des processus");
+    for (int i = 0; i < host_count; i++) {
+        if (!snapshots[i]) continue;
+        long long total = 0;
+        for (int p = 0; p < snapshots[i]->count; p++) total += snapshots[i]->list[p].memory_kb;
+        stream_printf(stream, "gestion_host_memory_kb{%s} %lld\n", labels[i], total);
+    }
+
+    // Séries par processus : top N de chaque hôte, étiquetées host, pid et name
+    for (int metric = 0; metric < 2; metric++) {
+        const char *family = metric == 0 ? "gestion_process_cpu_percent" : "gestion_process_memory_kb";
+        write_family(stream, family, "gauge", metric == 0 ? "CPU du processus, en % d'un cœur"
+                                                          : "Mémoire résidente du processus");
+        for (int i = 0; i < host_count; i++) {
+            for (int s = selected_start[i]; snapshots[i] && s < selected_start[i + 1]; s++) {
+                const process_info_t *proc = &snapshots[i]->list[selected[s]];
+                char name[EXPORTER_NAME_MAX * 2 + 1];
+                escape_label(name, sizeof(name), proc->name, EXPORTER_NAME_MAX);
+                if (metric == 0) {
+                    stream_printf(stream, "%s{%s,pid=\"%d\",name=\"%s\"} %.1f\n", family, labels[i],
+                                  proc->pid, name, proc->cpu_percent);
+                } else {
+                    stream_printf(stream, "%s{%s,pid=\"%d\",name=\"%s\"} %d\n", family, labels[i],
+                                  proc->pid, name, proc->memory_kb);
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < host_count; i++) {
+        if (snapshots[i]) poller_release_snapshot(exporter->poller, snapshots[i]);
+    }
+
+    if (exporter->alerts) {
+        write_family(stream, "gestion_alerts_active", "gauge", "Alertes en cours, tous hôtes confondus");
+        stream_printf(stream, "gestion_alerts_active %d\n", alert_active_count(exporter->alerts));
+    }
+    write_family(stream, "gestion_exporter_truncated", "gauge",
+                 "Séries par processus limitées par EXPORTER_MAX_SERIES");
+    stream_printf(stream, "gestion_exporter_truncated %d\n", truncated);
+    write_family(stream, "gestion_exporter_scrapes_total", "counter", "Collectes servies");
+    stream_printf(stream, "gestion_exporter_scrapes_total %lu\n", ++exporter->scrapes);
+
+    free(snapshots);
+    free(health);
+    free(labels);
+    free(selected);
+    free(selected_start);
+}
+
+/**
+ * @brief Répond à un client (une requête par connexion)
+ */
+static void exporter_serve(exporter_t *exporter, int fd) {
+    struct timeval timeout = { EXPORTER_TIMEOUT_MS / 1000, (EXPORTER_TIMEOUT_MS % 1000) * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // En-têtes lus en entier : fermer avec des données non lues couperait la réponse
+    char request[2048];
+    size_t used = 0;
+    while (used + 1 < sizeof(request)) {
+        ssize_t n = recv(fd, request + used, sizeof(request) - used - 1, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        used += (size_t)n;
+        request[used] = '\0';
+        if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n")) break;
+    }
+    request[used] = '\0';
+    if (used == 0) return;
+
+    exporter_stream_t *stream = malloc(sizeof(exporter_stream_t));
+    if (!stream) return;
+    stream->fd = fd;
+    stream->used = 0;
+    stream->failed = 0;
+
+    exporter_query_t query;
+    if (parse_request(request, &query) != 0) {
+        stream_printf(stream, "HTTP/1.0 404 Not Found\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\n"
+                              "GET /metrics[?top=N&sort=cpu|mem&host=NOM&name=TEXTE]\n");
+    } else {
+        stream_printf(stream, "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                              "Connection: close\r\n\r\n");
+        write_metrics(exporter, stream, &query);
+    }
+    stream_flush(stream);
+    free(stream);
+}
+
+static void *exporter_thread(void *arg) {
+    exporter_t *exporter = arg;
+    struct pollfd fds[2] = {
+        { exporter->listen_fd, POLLIN, 0 },
+        { exporter->wake_pipe[0], POLLIN, 0 }
+    };
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) break;
+        if (fds[0].revents & POLLIN) {
+            int client = accept4(exporter->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+            if (client < 0) continue;
+            exporter_serve(exporter, client);
+            close(client);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Ouvre la socket d'écoute ("unix:/chemin", "PORT" ou "ADRESSE:PORT")
+ *
+ * Sans adresse explicite, seul 127.0.0.1 écoute. Les sockets ne sont pas
+ * héritées par les commandes lancées (hook des alertes).
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int exporter_listen(exporter_t *exporter, const char *address) {
+    int fd;
+    if (strncmp(address, "unix:", 5) == 0) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        const char *path = address + 5;
+        if (!path[0] || strlen(path) >= sizeof(addr.sun_path)) return -1;
+        memcpy(addr.sun_path, path, strlen(path) + 1);
+
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        unlink(path);  // Socket laissée par une exécution précédente
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+        snprintf(exporter->unix_path, sizeof(exporter->unix_path), "%s", path);
+    } else {
+        char host[64] = "127.0.0.1";
+        const char *port = address;
+        const char *colon = strrchr(address, ':');
+        if (colon) {
+            snprintf(host, sizeof(host), "%.*s", (int)(colon - address), address);
+            port = colon + 1;
+        }
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((unsigned short)atoi(port));
+        if (atoi(port) <= 0 || atoi(port) > 65535 || inet_pton(AF_INET, host, &addr.sin_addr) != 1) return -1;
+
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    if (listen(fd, 8) != 0) {
+        close(fd);
+        if (exporter->unix_path[0]) unlink(exporter->unix_path);
+        return -1;
+    }
+    exporter->listen_fd = fd;
+    return 0;
+}
+
+/**
+ * @brief Ouvre l'adresse d'export et lance le thread qui sert les collectes
+ *
+ * @param exporter Structure à initialiser
+ * @param address Adresse d'écoute (voir exporter.h)
+ * @param poller Poller dont les instantanés sont exportés (doit rester valide jusqu'à exporter_stop())
+ * @param network Hôtes du poller
+ * @param alerts Moteur d'alertes (NULL si aucun)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int exporter_start(exporter_t *exporter, const char *address, poller_t *poller,
+                   network_manager_t *network, alert_engine_t *alerts) {
+    memset(exporter, 0, sizeof(exporter_t));
+    exporter->poller = poller;
+    exporter->network = network;
+    exporter->alerts = alerts;
+    exporter->listen_fd = -1;
+
+    if (!address || exporter_listen(exporter, address) != 0) return -1;
+    if (pipe2(exporter->wake_pipe, O_CLOEXEC) != 0) {
+        close(exporter->listen_fd);
+        if (exporter->unix_path[0]) unlink(exporter->unix_path);
+        return -1;
+    }
+    if (pthread_create(&exporter->thread, NULL, exporter_thread, exporter) != 0) {
+        close(exporter->wake_pipe[0]);
+        close(exporter->wake_pipe[1]);
+        close(exporter->listen_fd);
+        if (exporter->unix_path[0]) unlink(exporter->unix_path);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Arrête le thread (après la réponse en cours) et ferme l'adresse d'export
+ */
+void exporter_stop(exporter_t *exporter) {
+    if (write(exporter->wake_pipe[1], "", 1) != 1) {
+        // Tube plein ou fermé : le thread est déjà réveillé
+    }
+    pthread_join(exporter->thread, NULL);
+    close(exporter->wake_pipe[0]);
+    close(exporter->wake_pipe[1]);
+    close(exporter->listen_fd);
+    if (exporter->unix_path[0]) unlink(exporter->unix_path);
+}
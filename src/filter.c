@@ -0,0 +1,400 @@
+#include "filter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <pwd.h>
+
+typedef enum {
+    TOKEN_END,
+    TOKEN_WORD,
+    TOKEN_STRING,     // Entre guillemets
+    TOKEN_COMPARE,
+    TOKEN_OPEN,
+    TOKEN_CLOSE,
+    TOKEN_COMMA
+} token_type_t;
+
+typedef struct {
+    token_type_t type;
+    filter_compare_t compare;
+    char text[64];
+    int position;     // Position dans l'expression, pour les messages d'erreur
+} token_t;
+
+// Analyseur : position courante et jeton lu d'avance
+typedef struct {
+    filter_t *filter;
+    const char *input;
+    int offset;
+    token_t token;
+    int depth;
+} parser_t;
+
+static const struct {
+    const char *name;
+    unsigned short field;
+} filter_fields[] = {
+    { "pid", FILTER_FIELD_PID },
+    { "ppid", FILTER_FIELD_PPID },
+    { "uid", FILTER_FIELD_UID },
+    { "user", FILTER_FIELD_UID },
+    { "name", FILTER_FIELD_NAME },
+    { "state", FILTER_FIELD_STATE },
+    { "kernel", FILTER_FIELD_KERNEL },
+    { "cpu", FILTER_FIELD_CPU },
+    { "mem", FILTER_FIELD_MEM },
+    { "time", FILTER_FIELD_TIME }
+};
+
+static int is_word_char(char c) {
+    return c != '\0' && (isalnum((unsigned char)c) || strchr("_-.:/@+*%", c) != NULL);
+}
+
+static int parse_error(parser_t *parser, const char *message) {
+    snprintf(parser->filter->error, sizeof(parser->filter->error), "filtre : %s (position %d)",
+             message, parser->token.position + 1);
+    return -1;
+}
+
+/**
+ * @brief Lit le jeton suivant dans parser->token
+ *
+ * @return 0 en cas de succès, -1 si un texte est trop long ou un guillemet non fermé
+ */
+static int next_token(parser_t *parser) {
+    const char *input = parser->input;
+    int i = parser->offset;
+    while (isspace((unsigned char)input[i])) i++;
+
+    token_t *token = &parser->token;
+    memset(token, 0, sizeof(token_t));
+    token->position = i;
+
+    char c = input[i];
+    if (c == '\0') {
+        token->type = TOKEN_END;
+    } else if (c == '(' || c == ')' || c == ',') {
+        token->type = (c == '(') ? TOKEN_OPEN : (c == ')') ? TOKEN_CLOSE : TOKEN_COMMA;
+        i++;
+    } else if (c == '=' || c == '!' || c == '<' || c == '>' || c == '~') {
+        token->type = TOKEN_COMPARE;
+        int equal = input[i + 1] == '=';
+        switch (c) {
+            case '=': token->compare = FILTER_CMP_EQ; break;
+            case '!': token->compare = FILTER_CMP_NE; break;
+            case '<': token->compare = equal ? FILTER_CMP_LE : FILTER_CMP_LT; break;
+            case '>': token->compare = equal ? FILTER_CMP_GE : FILTER_CMP_GT; break;
+            default: token->compare = FILTER_CMP_CONTAINS; break;
+        }
+        if (c == '!' && !equal) {
+            // "!" seul : négation
+            token->type = TOKEN_WORD;
+            strcpy(token->text, "not");
+        }
+        i += (equal && c != '~') ? 2 : 1;
+    } else if (c == '&' && input[i + 1] == '&') {
+        token->type = TOKEN_WORD;
+        strcpy(token->text, "and");
+        i += 2;
+    } else if (c == '|' && input[i + 1] == '|') {
+        token->type = TOKEN_WORD;
+        strcpy(token->text, "or");
+        i += 2;
+    } else if (c == '"' || c == '\'') {
+        token->type = TOKEN_STRING;
+        const char *end = strchr(input + i + 1, c);
+        if (!end) {
+            parser->offset = i;
+            return parse_error(parser, "guillemet non fermé");
+        }
+        size_t len = (size_t)(end - (input + i + 1));
+        if (len >= sizeof(token->text)) return parse_error(parser, "texte trop long");
+        memcpy(token->text, input + i + 1, len);
+        i += (int)len + 2;
+    } else if (is_word_char(c)) {
+        token->type = TOKEN_WORD;
+        size_t len = 0;
+        while (is_word_char(input[i + len])) len++;
+        if (len >= sizeof(token->text)) return parse_error(parser, "mot trop long");
+        memcpy(token->text, input + i, len);
+        i += (int)len;
+    } else {
+        return parse_error(parser, "caractère inattendu");
+    }
+
+    parser->offset = i;
+    return 0;
+}
+
+static int is_keyword(const token_t *token, const char *keyword) {
+    return token->type == TOKEN_WORD && strcasecmp(token->text, keyword) == 0;
+}
+
+static int emit(parser_t *parser, const filter_instruction_t *instruction) {
+    filter_t *filter = parser->filter;
+    if (filter->length >= FILTER_MAX_INSTRUCTIONS) return parse_error(parser, "expression trop longue");
+    filter->program[filter->length++] = *instruction;
+    return 0;
+}
+
+static int emit_operator(parser_t *parser, filter_opcode_t opcode) {
+    filter_instruction_t instruction;
+    memset(&instruction, 0, sizeof(instruction));
+    instruction.opcode = opcode;
+    return emit(parser, &instruction);
+}
+
+/**
+ * @brief Convertit la valeur d'une clause numérique
+ *
+ * Mémoire en Ko (suffixes K, M, G), durée en secondes (s, m, h, d), uid
+ * depuis un nom d'utilisateur local : un nom inconnu ici donne un uid qui
+ * ne correspond à aucun processus (l'agent distant résout le nom de son côté).
+ *
+ * @return 0 en cas de succès, -1 si la valeur est invalide
+ */
+static int parse_value(unsigned short field, const char *text, double *value) {
+    char *end;
+    double number = strtod(text, &end);
+
+    if (field == FILTER_FIELD_UID && (end == text || *end)) {
+        struct passwd *user = getpwnam(text);
+        *value = user ? (double)user->pw_uid : -1.0;
+        return 0;
+    }
+    if (end == text) return -1;
+
+    double unit = 1.0;
+    if (field == FILTER_FIELD_MEM) {
+        switch (toupper((unsigned char)*end)) {
+            case '\0':
+            case 'K': unit = 1.0; break;
+            case 'M': unit = 1024.0; break;
+            case 'G': unit = 1024.0 * 1024.0; break;
+            default: return -1;
+        }
+        if (*end && end[1] && strcasecmp(end + 1, "B") != 0) return -1;
+    } else if (field == FILTER_FIELD_TIME) {
+        switch (*end) {
+            case '\0':
+            case 's': unit = 1.0; break;
+            case 'm': unit = 60.0; break;
+            case 'h': unit = 3600.0; break;
+            case 'd': unit = 86400.0; break;
+            default: return -1;
+        }
+        if (*end && end[1]) return -1;
+    } else if (*end && !(field == FILTER_FIELD_CPU && strcmp(end, "%") == 0)) {
+        return -1;
+    }
+
+    *value = number * unit;
+    return 0;
+}
+
+/**
+ * @brief Clause : champ, opérateur et valeur (ou « kernel » seul)
+ */
+static int parse_clause(parser_t *parser) {
+    if (parser->token.type != TOKEN_WORD) return parse_error(parser, "champ attendu");
+
+    filter_instruction_t clause;
+    memset(&clause, 0, sizeof(clause));
+    clause.opcode = FILTER_OP_CLAUSE;
+    for (size_t i = 0; i < sizeof(filter_fields) / sizeof(filter_fields[0]); i++) {
+        if (strcasecmp(parser->token.text, filter_fields[i].name) == 0) clause.field = filter_fields[i].field;
+    }
+    if (clause.field == 0) return parse_error(parser, "champ inconnu");
+    if (next_token(parser) != 0) return -1;
+
+    if (clause.field == FILTER_FIELD_KERNEL && parser->token.type != TOKEN_COMPARE) {
+        clause.compare = FILTER_CMP_NE;
+        clause.number = 0;
+        parser->filter->fields |= clause.field;
+        return emit(parser, &clause);
+    }
+
+    if (parser->token.type != TOKEN_COMPARE) return parse_error(parser, "opérateur attendu");
+    clause.compare = parser->token.compare;
+    int textual = clause.field == FILTER_FIELD_NAME || clause.field == FILTER_FIELD_STATE;
+    if (clause.compare == FILTER_CMP_CONTAINS && clause.field != FILTER_FIELD_NAME) {
+        return parse_error(parser, "~ ne s'applique qu'au nom");
+    }
+    if (clause.field == FILTER_FIELD_STATE && clause.compare != FILTER_CMP_EQ && clause.compare != FILTER_CMP_NE) {
+        return parse_error(parser, "état : = ou != seulement");
+    }
+    if (next_token(parser) != 0) return -1;
+
+    if (parser->token.type != TOKEN_WORD && parser->token.type != TOKEN_STRING) {
+        return parse_error(parser, "valeur attendue");
+    }
+    if (textual) {
+        if (parser->token.text[0] == '\0') return parse_error(parser, "valeur vide");
+        snprintf(clause.text, sizeof(clause.text), "%s", parser->token.text);
+    } else if (parse_value(clause.field, parser->token.text, &clause.number) != 0) {
+        return parse_error(parser, "valeur invalide");
+    }
+
+    parser->filter->fields |= clause.field;
+    if (emit(parser, &clause) != 0) return -1;
+    return next_token(parser);
+}
+
+static int parse_or(parser_t *parser);
+
+static int parse_not(parser_t *parser) {
+    if (is_keyword(&parser->token, "not")) {
+        if (next_token(parser) != 0 || parse_not(parser) != 0) return -1;
+        return emit_operator(parser, FILTER_OP_NOT);
+    }
+    if (parser->token.type == TOKEN_OPEN) {
+        if (++parser->depth > 16) return parse_error(parser, "trop de parenthèses imbriquées");
+        if (next_token(parser) != 0 || parse_or(parser) != 0) return -1;
+        if (parser->token.type != TOKEN_CLOSE) return parse_error(parser, "')' attendue");
+        parser->depth--;
+        return next_token(parser);
+    }
+    return parse_clause(parser);
+}
+
+static int parse_and(parser_t *parser) {
+    if (parse_not(parser) != 0) return -1;
+    while (is_keyword(&parser->token, "and") || parser->token.type == TOKEN_COMMA) {
+        if (next_token(parser) != 0 || parse_not(parser) != 0) return -1;
+        if (emit_operator(parser, FILTER_OP_AND) != 0) return -1;
+    }
+    return 0;
+}
+
+static int parse_or(parser_t *parser) {
+    if (parse_and(parser) != 0) return -1;
+    while (is_keyword(&parser->token, "or")) {
+        if (next_token(parser) != 0 || parse_and(parser) != 0) return -1;
+        if (emit_operator(parser, FILTER_OP_OR) != 0) return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Compile une expression en programme postfixé
+ *
+ * Descente récursive : or est moins prioritaire que and, lui-même moins
+ * prioritaire que not. Chaque clause devient une instruction, chaque
+ * opérateur une instruction qui combine les deux (ou le) derniers résultats.
+ *
+ * @param filter Filtre à remplir
+ * @param expression Expression (voir filter.h)
+ * @return 0 en cas de succès, -1 si l'expression est invalide (filter->error)
+ */
+int filter_compile(filter_t *filter, const char *expression) {
+    memset(filter, 0, sizeof(filter_t));
+    if (!expression || strlen(expression) >= FILTER_MAX_LENGTH) {
+        snprintf(filter->error, sizeof(filter->error), "filtre : expression vide ou trop longue (%d caractères au plus)",
+                 FILTER_MAX_LENGTH - 1);
+        return -1;
+    }
+    snprintf(filter->source, sizeof(filter->source), "%s", expression);
+
+    parser_t parser;
+    memset(&parser, 0, sizeof(parser));
+    parser.filter = filter;
+    parser.input = filter->source;
+
+    if (next_token(&parser) != 0) return -1;
+    if (parser.token.type == TOKEN_END) {
+        snprintf(filter->error, sizeof(filter->error), "filtre : expression vide");
+        return -1;
+    }
+    if (parse_or(&parser) != 0) return -1;
+    if (parser.token.type != TOKEN_END) return parse_error(&parser, "fin d'expression attendue");
+    return 0;
+}
+
+static int compare_number(filter_compare_t compare, double value, double reference) {
+    switch (compare) {
+        case FILTER_CMP_EQ: return value == reference;
+        case FILTER_CMP_NE: return value != reference;
+        case FILTER_CMP_LT: return value < reference;
+        case FILTER_CMP_LE: return value <= reference;
+        case FILTER_CMP_GT: return value > reference;
+        case FILTER_CMP_GE: return value >= reference;
+        default: return 0;
+    }
+}
+
+static int clause_match(const filter_instruction_t *clause, const process_info_t *proc) {
+    switch (clause->field) {
+        case FILTER_FIELD_NAME:
+            if (clause->compare == FILTER_CMP_CONTAINS) return strstr(proc->name, clause->text) != NULL;
+            return (strcmp(proc->name, clause->text) == 0) == (clause->compare == FILTER_CMP_EQ);
+        case FILTER_FIELD_STATE:
+            return (proc->state && strchr(clause->text, proc->state) != NULL) == (clause->compare == FILTER_CMP_EQ);
+        case FILTER_FIELD_PID: return compare_number(clause->compare, proc->pid, clause->number);
+        case FILTER_FIELD_PPID: return compare_number(clause->compare, proc->ppid, clause->number);
+        case FILTER_FIELD_UID: return compare_number(clause->compare, proc->uid, clause->number);
+        case FILTER_FIELD_KERNEL: return compare_number(clause->compare, proc->is_kernel ? 1 : 0, clause->number);
+        case FILTER_FIELD_CPU: return compare_number(clause->compare, proc->cpu_percent, clause->number);
+        case FILTER_FIELD_MEM: return compare_number(clause->compare, proc->memory_kb, clause->number);
+        case FILTER_FIELD_TIME: return compare_number(clause->compare, proc->time, clause->number);
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Exécute le programme sur une pile de valeurs à trois états
+ *
+ * and est faux dès qu'un membre est faux, or vrai dès qu'un membre est
+ * vrai ; sinon un membre inconnu rend le résultat inconnu.
+ */
+int filter_match(const filter_t *filter, const process_info_t *proc, unsigned int known) {
+    if (!filter || filter->length == 0) return FILTER_ACCEPT;
+
+    unsigned char stack[FILTER_MAX_INSTRUCTIONS];
+    int top = 0;
+    for (int i = 0; i < filter->length; i++) {
+        const filter_instruction_t *instruction = &filter->program[i];
+        switch (instruction->opcode) {
+            case FILTER_OP_CLAUSE:
+                if (!(known & instruction->field)) {
+                    stack[top++] = FILTER_UNKNOWN;
+                } else {
+                    stack[top++] = clause_match(instruction, proc) ? FILTER_ACCEPT : FILTER_REJECT;
+                }
+                break;
+            case FILTER_OP_NOT:
+                if (stack[top - 1] != FILTER_UNKNOWN) stack[top - 1] = !stack[top - 1];
+                break;
+            case FILTER_OP_AND: {
+                unsigned char right = stack[--top];
+                unsigned char left = stack[top - 1];
+                if (left == FILTER_REJECT || right == FILTER_REJECT) stack[top - 1] = FILTER_REJECT;
+                else if (left == FILTER_ACCEPT && right == FILTER_ACCEPT) stack[top - 1] = FILTER_ACCEPT;
+                else stack[top - 1] = FILTER_UNKNOWN;
+                break;
+            }
+            case FILTER_OP_OR: {
+                unsigned char right = stack[--top];
+                unsigned char left = stack[top - 1];
+                if (left == FILTER_ACCEPT || right == FILTER_ACCEPT) stack[top - 1] = FILTER_ACCEPT;
+                else if (left == FILTER_REJECT && right == FILTER_REJECT) stack[top - 1] = FILTER_REJECT;
+                else stack[top - 1] = FILTER_UNKNOWN;
+                break;
+            }
+        }
+    }
+    return stack[0];
+}
+
+int filter_apply(const filter_t *filter, process_info_t *list, int count, unsigned int known) {
+    if (!filter || filter->length == 0) return count;
+
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        if (filter_match(filter, &list[i], known) == FILTER_REJECT) continue;
+        if (kept != i) list[kept] = list[i];
+        kept++;
+    }
+    return kept;
+}
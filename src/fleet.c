@@ -0,0 +1,106 @@
+#include "fleet.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Curseur dans la liste triée d'un hôte
+typedef struct {
+    int host;
+    int position;
+    float key;  // Valeur de tri de l'élément courant
+} fleet_cursor_t;
+
+/**
+ * @brief Valeur de tri d'un processus
+ */
+static float fleet_key(const process_info_t *proc, fleet_sort_t sort) {
+    return (sort == FLEET_SORT_CPU) ? proc->cpu_percent : (float)proc->memory_kb;
+}
+
+/**
+ * @brief Élément courant d'un curseur
+ */
+static const process_info_t *cursor_proc(poller_t *poller, const fleet_cursor_t *cursor,
+                                         fleet_sort_t sort) {
+    const poller_snapshot_t *snapshot = poller->slots[cursor->host].snapshot;
+    const int *order = (sort == FLEET_SORT_CPU) ? snapshot->by_cpu : snapshot->by_mem;
+    return &snapshot->list[order[cursor->position]];
+}
+
+/**
+ * @brief Rétablit la propriété de tas (maximum en tête) à partir d'un nœud
+ */
+static void heap_sift_down(fleet_cursor_t *heap, int size, int index) {
+    for (;;) {
+        int largest = index;
+        int left = 2 * index + 1;
+        int right = left + 1;
+        if (left < size && heap[left].key > heap[largest].key) largest = left;
+        if (right < size && heap[right].key > heap[largest].key) largest = right;
+        if (largest == index) return;
+
+        fleet_cursor_t tmp = heap[index];
+        heap[index] = heap[largest];
+        heap[largest] = tmp;
+        index = largest;
+    }
+}
+
+/**
+ * @brief Construit le top K de la flotte par fusion k-voies
+ *
+ * Chaque hôte fournit sa liste déjà triée (par le thread de collecte, une
+ * fois par instantané) ; un tas de curseurs, un par hôte, donne l'élément
+ * suivant en O(log H). Le coût est donc O(H + K log H), indépendant du
+ * nombre total de processus de la flotte.
+ *
+ * @param poller Poller dont on fusionne les derniers instantanés
+ * @param sort Critère de tri (CPU ou mémoire, décroissant)
+ * @param rows Tableau de sortie d'au moins k lignes
+ * @param k Nombre maximum de lignes
+ * @return Nombre de lignes écrites, -1 en cas d'erreur
+ */
+int fleet_build(poller_t *poller, fleet_sort_t sort, fleet_row_t *rows, int k) {
+    if (!poller || !rows || k <= 0) return -1;
+
+    pthread_mutex_lock(&poller->lock);
+
+    fleet_cursor_t *heap = malloc(sizeof(fleet_cursor_t) * (poller->slot_count > 0 ? poller->slot_count : 1));
+    if (!heap) {
+        pthread_mutex_unlock(&poller->lock);
+        return -1;
+    }
+
+    int size = 0;
+    for (int i = 0; i < poller->slot_count; i++) {
+        const poller_snapshot_t *snapshot = poller->slots[i].snapshot;
+        if (!snapshot || snapshot->count == 0) continue;
+
+        heap[size].host = i;
+        heap[size].position = 0;
+        heap[size].key = fleet_key(cursor_proc(poller, &heap[size], sort), sort);
+        size++;
+    }
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        heap_sift_down(heap, size, i);
+    }
+
+    int n = 0;
+    while (n < k && size > 0) {
+        fleet_cursor_t *top = &heap[0];
+        rows[n].host = top->host;
+        rows[n].proc = *cursor_proc(poller, top, sort);
+        n++;
+
+        top->position++;
+        if (top->position < poller->slots[top->host].snapshot->count) {
+            top->key = fleet_key(cursor_proc(poller, top, sort), sort);
+        } else {
+            heap[0] = heap[--size];
+        }
+        heap_sift_down(heap, size, 0);
+    }
+
+    pthread_mutex_unlock(&poller->lock);
+    free(heap);
+    return n;
+}
@@ -0,0 +1,102 @@
+#include "line_parser.h"
+#include <stdlib.h>
+#include <string.h>
+
+void line_parser_init(line_parser_t *parser, line_handler_t handler, void *context) {
+    memset(parser, 0, sizeof(line_parser_t));
+    parser->handler = handler;
+    parser->context = context;
+}
+
+/**
+ * @brief Ajoute des octets au début de ligne en attente
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int partial_append(line_parser_t *parser, const char *data, size_t len) {
+    if (parser->partial_len + len + 1 > parser->partial_capacity) {
+        size_t capacity = parser->partial_capacity ? parser->partial_capacity : 256;
+        while (capacity < parser->partial_len + len + 1) capacity *= 2;
+
+        char *tmp = realloc(parser->partial, capacity);
+        if (!tmp) return -1;
+        parser->partial = tmp;
+        parser->partial_capacity = capacity;
+    }
+
+    memcpy(parser->partial + parser->partial_len, data, len);
+    parser->partial_len += len;
+    parser->partial[parser->partial_len] = '\0';
+    return 0;
+}
+
+/**
+ * @brief Transmet une ligne au handler (en retirant un éventuel '\r' final)
+ */
+static int emit_line(line_parser_t *parser, char *line, size_t len) {
+    if (len > 0 && line[len - 1] == '\r') line[--len] = '\0';
+    parser->line_count++;
+    return parser->handler(line, len, parser->context);
+}
+
+/**
+ * @brief Découpe un bloc reçu en lignes
+ *
+ * Le bloc est modifié sur place (les '\n' deviennent des '\0'). Chaque
+ * octet n'est parcouru qu'une fois : le coût est linéaire en la taille
+ * totale de la sortie, quel que soit le découpage en blocs.
+ *
+ * @param parser Le découpeur
+ * @param data Bloc reçu (modifiable)
+ * @param len Taille du bloc
+ * @return 0 en cas de succès, sinon la valeur non nulle renvoyée par le handler (ou -1)
+ */
+int line_parser_feed(line_parser_t *parser, char *data, size_t len) {
+    char *cursor = data;
+    char *end = data + len;
+
+    while (cursor < end) {
+        char *newline = memchr(cursor, '\n', end - cursor);
+        if (!newline) {
+            // Fin de bloc au milieu d'une ligne : la garder pour le prochain bloc
+            return partial_append(parser, cursor, end - cursor);
+        }
+
+        *newline = '\0';
+        int result;
+        if (parser->partial_len > 0) {
+            if (partial_append(parser, cursor, newline - cursor) != 0) return -1;
+            result = emit_line(parser, parser->partial, parser->partial_len);
+            parser->partial_len = 0;
+        } else {
+            result = emit_line(parser, cursor, newline - cursor);
+        }
+        if (result != 0) return result;
+
+        cursor = newline + 1;
+    }
+    return 0;
+}
+
+int line_parser_finish(line_parser_t *parser) {
+    if (parser->partial_len == 0) return 0;
+    size_t len = parser->partial_len;
+    parser->partial_len = 0;
+    return emit_line(parser, parser->partial, len);
+}
+
+void line_parser_reset(line_parser_t *parser) {
+    parser->partial_len = 0;
+    parser->line_count = 0;
+}
+
+void line_parser_free(line_parser_t *parser) {
+    free(parser->partial);
+    parser->partial = NULL;
+    parser->partial_len = 0;
+    parser->partial_capacity = 0;
+}
+
+int line_parser_sink(char *data, size_t len, void *context) {
+    return line_parser_feed((line_parser_t *)context, data, len);
+}
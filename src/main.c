@@ -6,6 +6,11 @@
 
 #include "../header/manager.h"
 #include "../header/ui.h"
+#include "../header/agent.h"
+#include "../header/bench.h"
+#include "../header/shm.h"
+#include "../header/watch.h"
+#include "../header/filter.h"
 
 typedef struct program_options {
     int show_help;
@@ -18,6 +23,25 @@ typedef struct program_options {
     char *username;
     char *password;
     int all;
+    int agent;
+    int agent_interval;
+    int agent_compress;
+    int bench;
+    char *bench_spec;
+    char *alerts_file;
+    char *exporter_address;
+    int publish;
+    char *publish_name;
+    int attach;
+    char *attach_name;
+    int top_k;
+    process_rank_t top_by;
+    int bench_parsers;
+    char *corpus_dir;
+    int schedstat;
+    int watch_interval;
+    char *filter;
+    int sockets;
 } program_options_t;
 
 
@@ -33,6 +57,8 @@ int main(int argc, char **argv) {
     program_options_t options;
     memset(&options, 0, sizeof(options));
     options.port = -1;
+    options.agent_interval = AGENT_DEFAULT_INTERVAL_MS;
+    options.watch_interval = WATCH_DEFAULT_INTERVAL_MS;
 
     struct option long_options[] = {
         {"help", no_argument, 0, 'h'},
@@ -45,6 +71,21 @@ int main(int argc, char **argv) {
         {"username", required_argument, 0, 'u'},
         {"password", required_argument, 0, 'p'},
         {"all", no_argument, 0, 'a'},
+        {"agent", no_argument, 0, 2},
+        {"interval", required_argument, 0, 3},
+        {"compress", no_argument, 0, 4},
+        {"bench", optional_argument, 0, 5},
+        {"alerts", required_argument, 0, 6},
+        {"exporter", required_argument, 0, 7},
+        {"publish", optional_argument, 0, 8},
+        {"attach", optional_argument, 0, 9},
+        {"top-k", required_argument, 0, 10},
+        {"top-by", required_argument, 0, 11},
+        {"bench-parsers", optional_argument, 0, 12},
+        {"schedstat", no_argument, 0, 13},
+        {"watch-interval", required_argument, 0, 14},
+        {"filter", required_argument, 0, 15},
+        {"sockets", no_argument, 0, 16},
         {0, 0, 0, 0}
     };
 
@@ -83,19 +124,120 @@ int main(int argc, char **argv) {
             case 'a':
                 options.all = 1;
                 break;
+            case 2:
+                options.agent = 1;
+                break;
+            case 3:
+                options.agent_interval = atoi(optarg);
+                break;
+            case 4:
+                options.agent_compress = 1;
+                break;
+            case 5:
+                options.bench = 1;
+                options.bench_spec = optarg;
+                break;
+            case 6:
+                options.alerts_file = optarg;
+                break;
+            case 7:
+                options.exporter_address = optarg;
+                break;
+            case 8:
+                options.publish = 1;
+                options.publish_name = optarg;
+                break;
+            case 9:
+                options.attach = 1;
+                options.attach_name = optarg;
+                break;
+            case 10:
+                options.top_k = atoi(optarg);
+                break;
+            case 11:
+                if (strcmp(optarg, "cpu") != 0 && strcmp(optarg, "mem") != 0) {
+                    printf("--top-by : cpu ou mem.\n");
+                    return 1;
+                }
+                options.top_by = (strcmp(optarg, "mem") == 0) ? PROCESS_RANK_MEM : PROCESS_RANK_CPU;
+                break;
+            case 12:
+                options.bench_parsers = 1;
+                options.corpus_dir = optarg;
+                break;
+            case 13:
+                options.schedstat = 1;
+                break;
+            case 14:
+                options.watch_interval = atoi(optarg);
+                if (options.watch_interval < WATCH_MIN_INTERVAL_MS || options.watch_interval > WATCH_MAX_INTERVAL_MS) {
+                    printf("--watch-interval : entre %d et %d ms.\n", WATCH_MIN_INTERVAL_MS, WATCH_MAX_INTERVAL_MS);
+                    return 1;
+                }
+                break;
+            case 15:
+                options.filter = optarg;
+                break;
+            case 16:
+                options.sockets = 1;
+                break;
             default:
                 printf("Option inconnue. Utilisez --help.\n");
                 return 1;
         }
     }
 
+    // Collecte locale limitée aux K processus les plus consommateurs (--top-k)
+    process_set_top_k(options.top_k, options.top_by);
+    // CPU% local en nanosecondes et attente en file d'exécution (--schedstat)
+    if (options.schedstat) process_set_sampling(PROCESS_SAMPLING_SCHEDSTAT);
+    // Sockets TCP et UDP de chaque processus local (--sockets)
+    if (options.sockets) process_set_sockets(1);
+    // Filtre évalué pendant la collecte locale, transmis aux agents et appliqué aux autres hôtes (--filter)
+    static filter_t filter;
+    if (options.filter) {
+        if (filter_compile(&filter, options.filter) != 0) {
+            printf("%s\n", filter.error);
+            return 1;
+        }
+        process_set_filter(&filter);
+    }
+
+    if (options.agent) { // Mode agent : collecte sans interface, instantanés binaires sur stdout
+        return agent_run(options.agent_interval, options.agent_compress);
+    }
+
+    if (options.publish) { // Collecte locale publiée en mémoire partagée, sans interface
+        return shm_publish_run(options.publish_name, options.agent_interval);
+    }
+
+    if (options.bench_parsers) { // Corpus, débit et fuzzing des analyseurs de /proc et de ps
+        return bench_parsers(options.corpus_dir);
+    }
+
+    if (options.bench) { // Benchmark de collecte sur des hôtes simulés, sans interface
+        return bench_run(options.bench_spec);
+    }
+
     if (options.dry_run) { // Si l'option dry_run a été donné en options
         manager_run(); // Lance un dry_run
         printf("Mode test activé\n");
         return 0; //Met fin au code
     }
-    manager(options.show_help); // Si il n'y a pas d'erreur lors de la lecture des options ou qu'on est pas
-                                // en dry_run, alors on lance la fonction manager et on lui transmet si il
-                                // doit afficher l'aide ou non
+    manager_options_t manager_options;
+    memset(&manager_options, 0, sizeof(manager_options));
+    manager_options.show_help = options.show_help;
+    manager_options.all = options.all;
+    manager_options.config_file = options.remote_config ? options.remote_config : ".config";
+    manager_options.alerts_file = options.alerts_file;
+    manager_options.exporter_address = options.exporter_address;
+    manager_options.watch_interval_ms = options.watch_interval;
+    if (options.attach) {
+        manager_options.attach_name = options.attach_name ? options.attach_name : SHM_DEFAULT_NAME;
+    }
+
+    manager(&manager_options); // Si il n'y a pas d'erreur lors de la lecture des options ou qu'on est pas
+                               // en dry_run, alors on lance la fonction manager et on lui transmet les
+                               // options d'affichage (aide, vue fusionnée, configuration)
     return 0;
 }
\ No newline at end of file
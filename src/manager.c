@@ -6,24 +6,47 @@
 #include "../header/ui.h"
 #include "../header/process.h"
 #include "../header/network.h"
+#include "../header/poller.h"
+#include "../header/collector.h"
+#include "../header/fleet.h"
+#include "../header/action_queue.h"
+#include "../header/cgroup.h"
+#include "../header/alert.h"
+#include "../header/exporter.h"
+#include "../header/watch.h"
+#include "../header/filter.h"
+#include "../header/sockets.h"
 #include "ncurses.h"
 
 // Ajouter ces variables globales
 static network_manager_t network_manager;
+static poller_t poller;
+static action_queue_t action_queue;
+static alert_engine_t alert_engine;
+static exporter_t exporter;
+static watch_t watch;
 static int use_network = 0;
 
+// Vue par cgroup (touche g, localhost uniquement)
+typedef enum {
+    CGROUP_VIEW_OFF,
+    CGROUP_VIEW_LIST,       // Un cgroup par ligne
+    CGROUP_VIEW_PROCESSES   // Processus du cgroup choisi (Entrée)
+} cgroup_view_t;
+
 void manager_run() {
     printf("[DRY RUN] Mode test activé - Aucune action ne sera exécutée\n");
     printf("[DRY RUN] Simulation de l'accès aux processus...\n");
 
     // Tester la configuration réseau
-    host_config_t test_hosts[MAX_HOSTS];
-    int host_count = parse_config_file(".config", test_hosts, MAX_HOSTS);
+    host_config_t *test_hosts = NULL;
+    int host_count = parse_config_file(".config", &test_hosts);
     if (host_count > 0) {
         printf("[DRY RUN] Configuration réseau détectée: %d hôte(s)\n", host_count);
         for (int i = 0; i < host_count; i++) {
             printf("[DRY RUN] Hôte %d: %s (%s)\n", i, test_hosts[i].name, test_hosts[i].address);
         }
+        free(test_hosts);
     }
 
     printf("[DRY RUN] Connexion aux services distants simulée\n");
@@ -39,24 +62,178 @@ int get_selected_pid(process_info_t *list, int count) {
     return -1;
 }
 
-void manager(int options) {
+/**
+ * @brief Hôte et PID de la ligne sélectionnée dans la vue fusionnée
+ *
+ * @return 0 si une ligne est sélectionnée, -1 sinon
+ */
+static int get_selected_fleet_target(const fleet_row_t *rows, int count, int *host, int *pid) {
+    int selected_index = ui_get_selected_index();
+    if (rows == NULL || selected_index < 0 || selected_index >= count) return -1;
+    *host = rows[selected_index].host;
+    *pid = rows[selected_index].proc.pid;
+    return 0;
+}
+
+/**
+ * @brief Action sur processus correspondant à une touche
+ *
+ * @return 0 si la touche est une action sur processus, -1 sinon
+ */
+static int get_process_action(ui_action_t action, process_action_t *process_action) {
+    switch (action) {
+        case UI_ACTION_KILL:    *process_action = PROCESS_ACTION_KILL;    return 0;
+        case UI_ACTION_PAUSE:   *process_action = PROCESS_ACTION_PAUSE;   return 0;
+        case UI_ACTION_RESUME:  *process_action = PROCESS_ACTION_RESUME;  return 0;
+        case UI_ACTION_RESTART: *process_action = PROCESS_ACTION_RESTART; return 0;
+        default:                return -1;
+    }
+}
+
+static const char *process_action_name(process_action_t action) {
+    switch (action) {
+        case PROCESS_ACTION_KILL:    return "kill";
+        case PROCESS_ACTION_PAUSE:   return "pause";
+        case PROCESS_ACTION_RESUME:  return "reprise";
+        case PROCESS_ACTION_RESTART: return "redémarrage";
+    }
+    return "?";
+}
+
+/**
+ * @brief Résume la santé d'un hôte pour l'en-tête
+ *
+ * "up, 23 ms", puis pour un hôte en échec la cause et le délai avant la
+ * prochaine tentative.
+ */
+static void format_host_health(char *buffer, size_t size, const host_health_t *health) {
+    int used = snprintf(buffer, size, "%s", host_status_name(health->status));
+    if (health->rtt_ms >= 0 && used < (int)size) {
+        used += snprintf(buffer + used, size - used, ", %d ms", health->rtt_ms);
+    }
+    if (health->consecutive_failures > 0 && used < (int)size) {
+        long long wait_ms = health->retry_ms - network_now_ms();
+        used += snprintf(buffer + used, size - used, " : %s", health->last_error);
+        if (wait_ms > 0 && used < (int)size) {
+            snprintf(buffer + used, size - used, ", retry %llds", (wait_ms + 999) / 1000);
+        }
+    }
+}
+
+/**
+ * @brief Abandonne la liste affichée
+ *
+ * Rend l'instantané tenu sur le poller, ou libère la liste allouée par le
+ * repli local.
+ */
+static void release_process_list(poller_snapshot_t **held, process_info_t **list, int *count) {
+    if (*held) {
+        poller_release_snapshot(&poller, *held);
+    } else {
+        free(*list);
+    }
+    *held = NULL;
+    *list = NULL;
+    *count = 0;
+}
+
+void manager(const manager_options_t *manager_options) {
     ui_init();
 
+    int options = manager_options->show_help;
+    if (process_get_top_k() > 0) {
+        char status[128];
+        snprintf(status, sizeof(status), " localhost : %d processus les plus consommateurs seulement (--top-k)",
+                 process_get_top_k());
+        ui_set_status(status);
+    }
+    if (process_get_filter()) {
+        char status[320];
+        snprintf(status, sizeof(status), " Filtre : %s", process_get_filter()->source);
+        ui_set_status(status);
+    }
+
     // Initialiser le réseau si config fournie
     use_network = 0;
-    const char *config_file = ".config"; // À récupérer des options
-    if (network_init(&network_manager, config_file) == 0 && network_manager.count > 1) {
+    const char *config_file = manager_options->config_file ? manager_options->config_file : ".config";
+    int network_ready = (network_init(&network_manager, config_file) == 0);
+    if (network_ready && network_manager.count > 1) {
         use_network = 1;
     }
 
+    // Mode --attach : localhost lu dans le segment d'un publieur, sans collecte
+    if (network_ready && manager_options->attach_name) {
+        host_config_t *local = &network_manager.hosts[0];
+        local->type = CONNECTION_SHM;
+        snprintf(local->address, sizeof(local->address), "%s", manager_options->attach_name);
+    }
+
+    // Collecte en arrière-plan de tous les hôtes (localhost compris) :
+    // la boucle d'affichage ne fait que lire le dernier instantané
+    int polling = network_ready && poller_start(&poller, &network_manager) == 0;
+
+    // Actions sur processus exécutées en arrière-plan, résultats sur la ligne d'état
+    int async_actions = network_ready && action_queue_start(&action_queue, &network_manager) == 0;
+
+    // Règles d'alerte évaluées par le poller à chaque instantané (fichier absent : aucune alerte)
+    const char *alerts_file = manager_options->alerts_file ? manager_options->alerts_file : ALERTS_DEFAULT_FILE;
+    int alerting = polling && alert_engine_load(&alert_engine, alerts_file, &network_manager) >= 0;
+    unsigned long alert_seen = 0;
+    if (alerting) {
+        poller_set_alerts(&poller, &alert_engine);
+    } else if (alert_engine.message[0]) {
+        ui_set_status(alert_engine.message);
+    }
+
+    // Export Prometheus (--exporter), servi depuis les instantanés du poller
+    int exporting = 0;
+    if (polling && manager_options->exporter_address) {
+        exporting = exporter_start(&exporter, manager_options->exporter_address, &poller, &network_manager,
+                                   alerting ? &alert_engine : NULL) == 0;
+        if (!exporting) {
+            char status[256];
+            snprintf(status, sizeof(status), " Exporter : impossible d'écouter sur %.200s",
+                     manager_options->exporter_address);
+            ui_set_status(status);
+        }
+    }
+
+    // Vue fusionnée (--all) : top K de tous les hôtes, reconstruit à chaque nouvel instantané
+    int fleet_view = manager_options->all && polling;
+    fleet_sort_t fleet_sort = FLEET_SORT_CPU;
+    fleet_row_t *fleet_rows = NULL;
+    int fleet_count = 0;
+    unsigned long fleet_generation = 0;
+    if (fleet_view) {
+        fleet_rows = malloc(sizeof(fleet_row_t) * FLEET_TOP_K);
+        if (!fleet_rows) fleet_view = 0;
+    }
+
+    // Suivi rapproché des processus épinglés (touche w), dans son propre thread
+    int watching = watch_start(&watch, manager_options->watch_interval_ms > 0
+                                       ? manager_options->watch_interval_ms : WATCH_DEFAULT_INTERVAL_MS) == 0;
+    unsigned long watch_exit_seen = 0;
+    watch_entry_t watch_entries[WATCH_MAX_PIDS];
+
     if (options != 0) {
         ui_draw_help();
     }
 
     process_info_t *process_list = NULL;
     int process_count = 0;
+    poller_snapshot_t *held_snapshot = NULL;  // Instantané affiché, tenu sans copie
     int running = 1;
     int refresh_counter = 0;
+    unsigned long snapshot_generation = 0;
+
+    cgroup_view_t cgroup_view = CGROUP_VIEW_OFF;
+    cgroup_info_t *cgroup_list = NULL;
+    int cgroup_count = 0;
+    char cgroup_selected[256] = "";            // Cgroup ouvert en vue processus
+    process_info_t *cgroup_processes = NULL;   // Processus de ce cgroup
+    int cgroup_process_count = 0;
+    unsigned long cgroup_generation = 0;       // Instantané déjà rattaché aux cgroups
+    int cgroup_dirty = 0;                      // Rattachement à refaire (vue ouverte ou changée)
 
     while (running) {
         while (options != 0) {
@@ -67,75 +244,200 @@ void manager(int options) {
             }
         }
 
-        // Rafraîchir la liste toutes les 10 itérations
-        if (refresh_counter % 10 == 0) {
+        if (fleet_view) {
+            unsigned long generation = poller_generation(&poller);
+            if (generation != fleet_generation) {
+                int n = fleet_build(&poller, fleet_sort, fleet_rows, FLEET_TOP_K);
+                fleet_count = (n > 0) ? n : 0;
+                fleet_generation = generation;
+            }
+        } else if (polling) {
+            // Dernier instantané de l'hôte courant, sans jamais attendre une collecte
+            poller_snapshot_t *snapshot = poller_acquire_snapshot(&poller, network_manager.current_host,
+                                                                  &snapshot_generation);
+            if (snapshot) {
+                release_process_list(&held_snapshot, &process_list, &process_count);
+                held_snapshot = snapshot;
+                process_list = snapshot->list;
+                process_count = snapshot->count;
+            }
+        } else if (refresh_counter % 10 == 0) {
+            // Repli synchrone (mode local uniquement) si le poller n'a pas pu démarrer
             process_info_t *new_list = NULL;
             int new_count = 0;
+            if (get_process_list(&new_list, &new_count) == 0) {
+                release_process_list(&held_snapshot, &process_list, &process_count);
+                process_list = new_list;
+                process_count = new_count;
+            }
+        }
 
-            if (use_network) {
-                // Récupérer les processus de l'hôte courant
-                get_remote_process_list(&network_manager.hosts[network_manager.current_host],
-                                      &new_list, &new_count);
-            } else {
-                // Mode local uniquement
-                get_process_list(&new_list, &new_count);
+        // Vue cgroup : totaux relus toutes les 500 ms, processus rattachés
+        // (depuis le cache) à chaque nouvel instantané
+        if (cgroup_view != CGROUP_VIEW_OFF) {
+            int reload = refresh_counter % 10 == 0;
+            if (reload) {
+                cgroup_info_t *new_cgroups = NULL;
+                int new_cgroup_count = 0;
+                if (get_cgroup_list(&new_cgroups, &new_cgroup_count) == 0) {
+                    free(cgroup_list);
+                    cgroup_list = new_cgroups;
+                    cgroup_count = new_cgroup_count;
+                }
+            }
+
+            if (reload || cgroup_dirty || cgroup_generation != snapshot_generation) {
+                cgroup_count_processes(cgroup_list, cgroup_count, process_list, process_count);
+                if (cgroup_view == CGROUP_VIEW_PROCESSES) {
+                    process_info_t *filtered = NULL;
+                    int filtered_count = 0;
+                    if (cgroup_filter_processes(cgroup_selected, process_list, process_count,
+                                                &filtered, &filtered_count) == 0) {
+                        free(cgroup_processes);
+                        cgroup_processes = filtered;
+                        cgroup_process_count = filtered_count;
+                    }
+                }
+                cgroup_generation = snapshot_generation;
+                cgroup_dirty = 0;
             }
+        }
 
-            if (process_list) free(process_list);
-            process_list = new_list;
-            process_count = new_count;
+        // Liste affichée, cible des actions sur processus
+        process_info_t *shown_list = process_list;
+        int shown_count = process_count;
+        if (cgroup_view == CGROUP_VIEW_LIST) {
+            shown_list = NULL;
+            shown_count = 0;
+        } else if (cgroup_view == CGROUP_VIEW_PROCESSES) {
+            shown_list = cgroup_processes;
+            shown_count = cgroup_process_count;
         }
 
-        // Afficher l'en-tête avec le nom de l'hôte
-        char header[256];
-        if (use_network) {
-            snprintf(header, sizeof(header), " %s | F1 Help | F2 Next | F3 Prev | F4 Search | F5 Pause | F6 Stop | F7 Kill | F8 Restart | Q Quit ",
-                    network_manager.hosts[network_manager.current_host].name);
+        // Afficher l'en-tête avec le nom de l'hôte et son état
+        char header[512];
+        if (fleet_view) {
+            int status_counts[HOST_STATUS_DOWN + 1] = {0};
+            for (int i = 0; i < network_manager.count; i++) {
+                host_health_t health;
+                if (poller_get_health(&poller, i, &health) == 0) status_counts[health.status]++;
+            }
+            snprintf(header, sizeof(header), " Tous les hôtes (%d : %d up, %d degraded, %d down) | Tri %s | c CPU | m Mem | F4 Search | F5 Pause | F6 Stop | F7 Kill | F8 Restart | Q Quit ",
+                    network_manager.count, status_counts[HOST_STATUS_UP], status_counts[HOST_STATUS_DEGRADED],
+                    status_counts[HOST_STATUS_DOWN], fleet_sort == FLEET_SORT_CPU ? "CPU" : "Mem");
+        } else if (use_network) {
+            char health_text[200] = "";
+            host_health_t health;
+            if (polling && poller_get_health(&poller, network_manager.current_host, &health) == 0) {
+                format_host_health(health_text, sizeof(health_text), &health);
+            }
+            snprintf(header, sizeof(header), " %s [%s] | F1 Help | F2 Next | F3 Prev | F4 Search | F5 Pause | F6 Stop | F7 Kill | F8 Restart | Q Quit ",
+                    network_manager.hosts[network_manager.current_host].name, health_text);
         } else {
             strcpy(header, " Localhost | F1 Help | F2 Next | F3 Prev | F4 Search | F5 Pause | F6 Stop | F7 Kill | F8 Restart | Q Quit ");
         }
 
-        attron(A_REVERSE);
-        mvprintw(0, 0, "%-*s", COLS, header);
-        attroff(A_REVERSE);
+        if (cgroup_view == CGROUP_VIEW_LIST) {
+            snprintf(header, sizeof(header), " %s : %d cgroups | Entrée Processus du cgroup | g Retour | Q Quit ",
+                     use_network ? network_manager.hosts[network_manager.current_host].name : "Localhost", cgroup_count);
+        } else if (cgroup_view == CGROUP_VIEW_PROCESSES) {
+            snprintf(header, sizeof(header), " cgroup %s : %d processus | g Retour | F5 Pause | F6 Stop | F7 Kill | F8 Restart | Q Quit ",
+                     cgroup_selected, cgroup_process_count);
+        }
+
+        ui_set_header(header);
+
+        // Processus épinglés : relus à chaque tour, la table garde son propre rythme
+        int watch_count = 0;
+        if (watching && cgroup_view != CGROUP_VIEW_LIST) {
+            watch_count = watch_snapshot(&watch, watch_entries, WATCH_MAX_PIDS);
+        }
+        ui_set_watch(watch_entries, watch_count, watching ? watch.interval_ms : 0);
 
         // Afficher les processus
-        ui_draw_processes(process_list, process_count);
+        if (fleet_view) {
+            ui_draw_fleet(fleet_rows, fleet_count, network_manager.hosts);
+        } else if (cgroup_view == CGROUP_VIEW_LIST) {
+            ui_draw_cgroups(cgroup_list, cgroup_count);
+        } else {
+            // Taux et colonnes schedstat : seulement pour /proc lu par ce processus
+            const host_config_t *shown_host = use_network ? &network_manager.hosts[network_manager.current_host] : NULL;
+            int local_proc = !shown_host || (shown_host->is_local && shown_host->type != CONNECTION_SHM);
+            int columns = 0;
+            if (local_proc) columns |= UI_COLUMNS_RATES;
+            if (local_proc && process_get_sampling() == PROCESS_SAMPLING_SCHEDSTAT) columns |= UI_COLUMNS_SCHED;
+            if (local_proc && process_get_sockets()) columns |= UI_COLUMNS_SOCKETS;
+            ui_set_extra_columns(columns);
+            ui_draw_processes(shown_list, shown_count);
+        }
 
         // Gestion des touches
         ui_action_t action = ui_get_action();
+
+        // Actions sur processus : déposées dans la file, jamais attendues
+        process_action_t process_action;
+        if (cgroup_view == CGROUP_VIEW_LIST && get_process_action(action, &process_action) == 0) {
+            action = UI_ACTION_NONE;  // Aucun processus sélectionné dans la liste des cgroups
+        }
+        if (async_actions && get_process_action(action, &process_action) == 0) {
+            int host = network_manager.current_host;
+            int pid = -1;
+            if (fleet_view) {
+                if (get_selected_fleet_target(fleet_rows, fleet_count, &host, &pid) != 0) pid = -1;
+            } else {
+                pid = get_selected_pid(shown_list, shown_count);
+            }
+
+            const collector_backend_t *backend = collector_backend_for(&network_manager.hosts[host]);
+            if (pid > 0 && (!backend || !(backend->capabilities & COLLECTOR_CAP_ACTIONS))) {
+                // Source en lecture seule (rejeu) : aucune action possible
+                char status[256];
+                snprintf(status, sizeof(status), " %s %d impossible sur %s : source en lecture seule",
+                         process_action_name(process_action), pid, network_manager.hosts[host].name);
+                ui_set_status(status);
+            } else if (pid > 0 && action_queue_submit(&action_queue, host, pid, process_action) == 0) {
+                char status[256];
+                snprintf(status, sizeof(status), " %s %d sur %s : envoyé...",
+                         process_action_name(process_action), pid, network_manager.hosts[host].name);
+                ui_set_status(status);
+            }
+            action = UI_ACTION_NONE;
+        }
+
+        // Vue fusionnée : tri et navigation
+        if (fleet_view) {
+            switch (action) {
+                case UI_ACTION_SORT_CPU:
+                case UI_ACTION_SORT_MEM:
+                    fleet_sort = (action == UI_ACTION_SORT_CPU) ? FLEET_SORT_CPU : FLEET_SORT_MEM;
+                    fleet_generation = 0;  // Reconstruire avec le nouveau tri
+                    action = UI_ACTION_NONE;
+                    break;
+                case UI_ACTION_NEXT_HOST:
+                case UI_ACTION_PREV_HOST:
+                    action = UI_ACTION_NONE;  // Tous les hôtes sont déjà affichés
+                    break;
+                default:
+                    break;
+            }
+        }
+
         switch (action) {
+            // Repli synchrone (local) si la file d'actions n'a pas pu démarrer
             case UI_ACTION_PAUSE:
-                if (use_network) {
-                    // Implémenter remote_pause_process
-                } else {
-                    pause_process(get_selected_pid(process_list, process_count));
-                }
+                pause_process(get_selected_pid(shown_list, shown_count));
                 break;
 
             case UI_ACTION_RESTART:
-                if (use_network) {
-                    // Implémenter remote_restart_process
-                } else {
-                    restart_process(get_selected_pid(process_list, process_count));
-                }
+                restart_process(get_selected_pid(shown_list, shown_count));
                 break;
 
             case UI_ACTION_RESUME:
-                if (use_network) {
-                    // Implémenter remote_resume_process
-                } else {
-                    resume_process(get_selected_pid(process_list, process_count));
-                }
+                resume_process(get_selected_pid(shown_list, shown_count));
                 break;
 
             case UI_ACTION_KILL:
-                if (use_network) {
-                    remote_kill_process(&network_manager.hosts[network_manager.current_host],
-                                      get_selected_pid(process_list, process_count));
-                } else {
-                    kill_process(get_selected_pid(process_list, process_count));
-                }
+                kill_process(get_selected_pid(shown_list, shown_count));
                 break;
 
             case UI_ACTION_QUIT:
@@ -148,6 +450,71 @@ void manager(int options) {
                 options = 1;
                 break;
 
+            // Vue cgroup : g ouvre la liste des cgroups, puis revient en arrière
+            case UI_ACTION_CGROUPS:
+                if (cgroup_view == CGROUP_VIEW_PROCESSES) {
+                    cgroup_view = CGROUP_VIEW_LIST;
+                } else if (cgroup_view == CGROUP_VIEW_LIST) {
+                    cgroup_view = CGROUP_VIEW_OFF;
+                } else if (fleet_view || (network_ready && !network_manager.hosts[network_manager.current_host].is_local)) {
+                    ui_set_status(" Vue cgroups : localhost uniquement");
+                } else {
+                    cgroup_info_t *new_cgroups = NULL;
+                    int new_cgroup_count = 0;
+                    if (get_cgroup_list(&new_cgroups, &new_cgroup_count) == 0) {
+                        free(cgroup_list);
+                        cgroup_list = new_cgroups;
+                        cgroup_count = new_cgroup_count;
+                        cgroup_view = CGROUP_VIEW_LIST;
+                        cgroup_dirty = 1;
+                    } else {
+                        ui_set_status(" Vue cgroups : cgroup v2 indisponible (" CGROUP_ROOT ")");
+                    }
+                }
+                ui_reset_selection();
+                break;
+
+            case UI_ACTION_SELECT:
+                if (cgroup_view == CGROUP_VIEW_LIST) {
+                    int index = ui_get_selected_index();
+                    if (index >= 0 && index < cgroup_count) {
+                        snprintf(cgroup_selected, sizeof(cgroup_selected), "%s", cgroup_list[index].path);
+                        cgroup_view = CGROUP_VIEW_PROCESSES;
+                        cgroup_dirty = 1;
+                        ui_reset_selection();
+                    }
+                }
+                break;
+
+            // Épingle ou retire le processus sélectionné (processus locaux uniquement)
+            case UI_ACTION_WATCH: {
+                int host = network_manager.current_host;
+                int pid = -1;
+                if (fleet_view) {
+                    if (get_selected_fleet_target(fleet_rows, fleet_count, &host, &pid) != 0) pid = -1;
+                } else {
+                    pid = get_selected_pid(shown_list, shown_count);
+                }
+                char status[256];
+                if (!watching || pid <= 0) {
+                    break;
+                } else if (network_ready && !network_manager.hosts[host].is_local) {
+                    ui_set_status(" Suivi : processus locaux uniquement");
+                } else {
+                    int pinned = watch_toggle(&watch, pid);
+                    if (pinned > 0) {
+                        snprintf(status, sizeof(status), " Suivi : %d épinglé", pid);
+                    } else if (pinned == 0) {
+                        snprintf(status, sizeof(status), " Suivi : %d retiré", pid);
+                    } else {
+                        snprintf(status, sizeof(status), " Suivi : impossible d'épingler %d (terminé, ou %d déjà suivis)",
+                                 pid, WATCH_MAX_PIDS);
+                    }
+                    ui_set_status(status);
+                }
+                break;
+            }
+
             case UI_ACTION_SEARCH: {
                 char buffer[256];
                 ui_show_search(buffer, sizeof(buffer));
@@ -157,16 +524,22 @@ void manager(int options) {
             // Navigation entre hôtes (F2/F3)
             case UI_ACTION_NEXT_HOST:
                 if (use_network) {
+                    cgroup_view = CGROUP_VIEW_OFF;
                     network_manager.current_host = (network_manager.current_host + 1) % network_manager.count;
-                    // Forcer le rafraîchissement
-                    refresh_counter = 9;
+                    if (polling) poller_set_focus(&poller, network_manager.current_host);
+                    // Afficher le dernier instantané du nouvel hôte (déjà collecté en arrière-plan)
+                    snapshot_generation = 0;
+                    release_process_list(&held_snapshot, &process_list, &process_count);
                 }
                 break;
 
             case UI_ACTION_PREV_HOST:
                 if (use_network) {
+                    cgroup_view = CGROUP_VIEW_OFF;
                     network_manager.current_host = (network_manager.current_host - 1 + network_manager.count) % network_manager.count;
-                    refresh_counter = 9;
+                    if (polling) poller_set_focus(&poller, network_manager.current_host);
+                    snapshot_generation = 0;
+                    release_process_list(&held_snapshot, &process_list, &process_count);
                 }
                 break;
 
@@ -174,13 +547,56 @@ void manager(int options) {
                 break;
         }
 
+        // Résultats des actions terminées
+        action_request_t done;
+        while (async_actions && action_queue_poll_result(&action_queue, &done)) {
+            char status[256];
+            snprintf(status, sizeof(status), " %s %d sur %s : %s",
+                     process_action_name(done.action), done.pid, network_manager.hosts[done.host].name,
+                     done.result == 0 ? "OK" : "échec");
+            ui_set_status(status);
+            if (polling) poller_refresh_now(&poller, done.host);
+        }
+
+        // Dernier début ou fin d'alerte
+        char alert_message[256];
+        if (alerting && alert_poll_message(&alert_engine, &alert_seen, alert_message, sizeof(alert_message))) {
+            ui_set_status(alert_message);
+        }
+
+        // Fin d'un processus épinglé, signalée par son pidfd
+        char watch_message[256];
+        if (watching && watch_poll_exit(&watch, &watch_exit_seen, watch_message, sizeof(watch_message))) {
+            ui_set_status(watch_message);
+        }
+
         refresh_counter++;
         usleep(50000);
     }
 
     // Nettoyage
-    if (process_list) free(process_list);
-    if (use_network) {
+    release_process_list(&held_snapshot, &process_list, &process_count);
+    free(fleet_rows);
+    free(cgroup_list);
+    free(cgroup_processes);
+    cgroup_cleanup();
+    if (watching) {
+        watch_stop(&watch);
+    }
+    if (async_actions) {
+        action_queue_stop(&action_queue);
+    }
+    if (exporting) {
+        exporter_stop(&exporter);
+    }
+    if (polling) {
+        poller_stop(&poller);
+    }
+    sockets_cleanup();  // Après l'arrêt des collectes
+    if (alerting) {
+        alert_engine_free(&alert_engine);
+    }
+    if (network_ready) {
         network_cleanup(&network_manager);
     }
     ui_cleanup();
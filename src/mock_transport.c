@@ -0,0 +1,298 @@
+#include "mock_transport.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+#define MOCK_CLK_TCK 100
+#define MOCK_PAGE_SIZE 4096
+#define MOCK_CPU_COUNT 4
+#define MOCK_BOOT_UPTIME_S 3600.0  // Uptime simulé au démarrage du visualiseur
+
+// Générateur pseudo-aléatoire propre à chaque thread de collecte
+static __thread unsigned int mock_seed = 0;
+
+static double mock_random(void) {
+    if (mock_seed == 0) {
+        mock_seed = (unsigned int)time(NULL) ^ (unsigned int)(uintptr_t)&mock_seed;
+    }
+    return (double)rand_r(&mock_seed) / ((double)RAND_MAX + 1.0);
+}
+
+/**
+ * @brief Hachage stable (FNV-1a) : chaque hôte simulé garde ses processus d'une collecte à l'autre
+ */
+static unsigned int mock_hash(const char *text, unsigned int value) {
+    unsigned int hash = 2166136261u;
+    for (const char *p = text; *p; p++) {
+        hash = (hash ^ (unsigned char)*p) * 16777619u;
+    }
+    for (int i = 0; i < 4; i++) {
+        hash = (hash ^ ((value >> (i * 8)) & 0xFF)) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Lit les paramètres d'un hôte simulé (voir mock_transport.h)
+ *
+ * Les clés inconnues sont ignorées, les valeurs absentes gardent leur défaut.
+ *
+ * @param text Champ adresse de la configuration
+ * @param spec Structure qui recevra les paramètres
+ */
+void mock_spec_parse(const char *text, mock_spec_t *spec) {
+    memset(spec, 0, sizeof(mock_spec_t));
+    spec->latency_ms = MOCK_DEFAULT_LATENCY_MS;
+    spec->process_count = MOCK_DEFAULT_PROCESSES;
+
+    char copy[128];
+    snprintf(copy, sizeof(copy), "%s", text ? text : "");
+
+    char *saveptr = NULL;
+    for (char *item = strtok_r(copy, ",", &saveptr); item; item = strtok_r(NULL, ",", &saveptr)) {
+        char *value = strchr(item, '=');
+        if (!value) continue;
+        *value++ = '\0';
+
+        if (strcmp(item, "latency") == 0) {
+            spec->latency_ms = atoi(value) > 0 ? atoi(value) : 0;
+        } else if (strcmp(item, "jitter") == 0) {
+            spec->jitter_ms = atoi(value) > 0 ? atoi(value) : 0;
+        } else if (strcmp(item, "fail") == 0) {
+            spec->failure_rate = atof(value);
+        } else if (strcmp(item, "procs") == 0) {
+            spec->process_count = atoi(value) > 0 ? atoi(value) : 0;
+        } else if (strcmp(item, "file") == 0) {
+            snprintf(spec->file, sizeof(spec->file), "%s", value);
+        }
+    }
+}
+
+/**
+ * @brief Simule l'aller-retour réseau d'une commande
+ *
+ * Respecte l'échéance du thread : si la latence tirée la dépasse, attend
+ * jusqu'à l'échéance et échoue, comme un hôte réel trop lent.
+ *
+ * @return 0 si la commande aboutit, -1 en cas d'échec simulé ou d'échéance dépassée
+ */
+static int mock_round_trip(const mock_spec_t *spec) {
+    int delay = spec->latency_ms;
+    if (spec->jitter_ms > 0) {
+        delay += (int)(mock_random() * (2 * spec->jitter_ms + 1)) - spec->jitter_ms;
+    }
+    if (delay < 0) delay = 0;
+
+    int remaining = network_remaining_ms();
+    if (remaining >= 0 && delay > remaining) {
+        usleep((useconds_t)remaining * 1000);
+        network_set_error("échéance dépassée");
+        return -1;
+    }
+    usleep((useconds_t)delay * 1000);
+
+    if (mock_random() < spec->failure_rate) {
+        network_set_error("échec simulé");
+        return -1;
+    }
+    return 0;
+}
+
+// Sortie en cours, transmise au puits par blocs comme un vrai flux
+typedef struct {
+    char data[4096];
+    size_t len;
+    output_sink_t sink;
+    void *context;
+    int stopped;        // Le puits a interrompu la lecture
+} mock_output_t;
+
+static void mock_flush(mock_output_t *out) {
+    if (out->len > 0 && !out->stopped && out->sink(out->data, out->len, out->context) != 0) {
+        out->stopped = 1;
+    }
+    out->len = 0;
+}
+
+static void mock_printf(mock_output_t *out, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+static void mock_printf(mock_output_t *out, const char *format, ...) {
+    char line[512];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (n <= 0) return;
+    if ((size_t)n >= sizeof(line)) n = sizeof(line) - 1;
+
+    if (out->len + (size_t)n > sizeof(out->data)) mock_flush(out);
+    memcpy(out->data + out->len, line, (size_t)n);
+    out->len += (size_t)n;
+}
+
+// Processus synthétique d'un hôte simulé
+typedef struct {
+    int pid;
+    int ppid;
+    char state;
+    int is_kernel;
+    double load;        // Part d'un cœur utilisée, constante
+    int memory_kb;
+    double start_s;     // Date de démarrage en secondes d'uptime
+    char name[32];
+} mock_process_t;
+
+/**
+ * @brief Décrit le processus synthétique numéro index d'un hôte
+ *
+ * Environ un processus sur dix est un thread noyau ; la charge suit une
+ * loi à queue lourde (quelques processus actifs, la plupart au repos).
+ */
+static void mock_process(const host_config_t *host, int index, mock_process_t *proc) {
+    unsigned int h = mock_hash(host->name, (unsigned int)index);
+    double fraction = (h % 1000) / 1000.0;
+
+    proc->pid = index + 1;
+    proc->is_kernel = (index > 0 && index % 10 == 1);
+    proc->ppid = index == 0 ? 0 : (proc->is_kernel ? 2 : 1);
+    proc->load = proc->is_kernel ? 0.0 : fraction * fraction * fraction;
+    proc->state = proc->load > 0.5 ? 'R' : 'S';
+    proc->memory_kb = proc->is_kernel ? 0 : (int)((h >> 10) % 200000);
+    proc->start_s = (double)index;
+    if (proc->is_kernel) {
+        snprintf(proc->name, sizeof(proc->name), "kworker/%d", index);
+    } else {
+        snprintf(proc->name, sizeof(proc->name), "mock_%d", index);
+    }
+}
+
+/**
+ * @brief Uptime simulé : avance avec l'horloge monotone du visualiseur
+ */
+static double mock_uptime(void) {
+    static long long epoch_ms = 0;
+    long long now = network_now_ms();
+    if (epoch_ms == 0) __sync_bool_compare_and_swap(&epoch_ms, 0, now);
+    return MOCK_BOOT_UPTIME_S + (now - epoch_ms) / 1000.0;
+}
+
+/**
+ * @brief Sortie de "ps -eo pid,ppid,stat,pcpu,rss,etimes,comm --no-headers"
+ */
+static void mock_serve_ps(const host_config_t *host, const mock_spec_t *spec, mock_output_t *out) {
+    double uptime = mock_uptime();
+    for (int i = 0; i < spec->process_count && !out->stopped; i++) {
+        mock_process_t proc;
+        mock_process(host, i, &proc);
+        double pcpu = proc.load * 100.0 * (0.9 + 0.2 * mock_random());
+        mock_printf(out, "%d %d %c %.1f %d %ld %s\n", proc.pid, proc.ppid, proc.state, pcpu,
+                    proc.memory_kb, (long)(uptime - proc.start_s), proc.name);
+    }
+}
+
+/**
+ * @brief Sortie du script /proc de remote_proc.c (lignes H, U, T, P, N)
+ *
+ * Les ticks sont calculés depuis l'uptime : le CPU% obtenu par différence
+ * entre deux collectes retrouve la charge de chaque processus.
+ */
+static void mock_serve_proc(const host_config_t *host, const mock_spec_t *spec, mock_output_t *out) {
+    double uptime = mock_uptime();
+    mock_printf(out, "H|%d|%d\n", MOCK_CLK_TCK, MOCK_PAGE_SIZE);
+    mock_printf(out, "U|%.2f\n", uptime);
+    mock_printf(out, "T|%llu\n", (unsigned long long)(uptime * MOCK_CLK_TCK * MOCK_CPU_COUNT));
+
+    for (int i = 0; i < spec->process_count && !out->stopped; i++) {
+        mock_process_t proc;
+        mock_process(host, i, &proc);
+        unsigned long long ticks = (unsigned long long)((uptime - proc.start_s) * proc.load * MOCK_CLK_TCK);
+        mock_printf(out, "P|%d|%d|%c|%llu|%llu|%d|%d|%s\n", proc.pid, proc.ppid, proc.state, ticks,
+                    (unsigned long long)(proc.start_s * MOCK_CLK_TCK), proc.is_kernel,
+                    proc.memory_kb * 1024 / MOCK_PAGE_SIZE, proc.name);
+    }
+    mock_printf(out, "N|%d\n", MOCK_CPU_COUNT);
+}
+
+/**
+ * @brief Réponse à un lot d'actions : chaque 'echo "index $?"' réussit
+ */
+static void mock_serve_actions(const char *command, mock_output_t *out) {
+    const char *p = command;
+    while ((p = strstr(p, "echo \"")) != NULL) {
+        p += 6;
+        int index;
+        if (sscanf(p, "%d $?", &index) == 1) mock_printf(out, "%d 0\n", index);
+    }
+}
+
+/**
+ * @brief Sert le contenu d'un fichier de sortie ps enregistré
+ *
+ * @return 0 en cas de succès, -1 si le fichier est illisible
+ */
+static int mock_serve_file(const char *path, mock_output_t *out) {
+    FILE *file = fopen(path, "r");
+    if (!file) return -1;
+
+    size_t n;
+    while (!out->stopped && (n = fread(out->data + out->len, 1, sizeof(out->data) - out->len, file)) > 0) {
+        out->len += n;
+        if (out->len == sizeof(out->data)) mock_flush(out);
+    }
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Exécute une commande sur un hôte simulé
+ *
+ * Reconnaît les commandes ps, le script /proc et les lots d'actions ; les
+ * autres commandes réussissent sans sortie.
+ *
+ * @return 0 en cas de succès, -1 en cas d'échec simulé ou si le puits interrompt la lecture
+ */
+static int mock_execute_stream(const host_config_t *host, const char *command,
+                               output_sink_t sink, void *context) {
+    mock_spec_t spec;
+    mock_spec_parse(host->address, &spec);
+    if (mock_round_trip(&spec) != 0) return -1;
+
+    mock_output_t out;
+    out.len = 0;
+    out.sink = sink;
+    out.context = context;
+    out.stopped = 0;
+
+    if (strncmp(command, "ps ", 3) == 0) {
+        if (spec.file[0]) {
+            if (mock_serve_file(spec.file, &out) != 0) return -1;
+        } else {
+            mock_serve_ps(host, &spec, &out);
+        }
+    } else if (strncmp(command, "cd /proc", 8) == 0) {
+        mock_serve_proc(host, &spec, &out);
+    } else {
+        mock_serve_actions(command, &out);
+    }
+    mock_flush(&out);
+
+    return out.stopped ? -1 : 0;
+}
+
+static int mock_connect(const host_config_t *host) {
+    mock_spec_t spec;
+    mock_spec_parse(host->address, &spec);
+    return mock_round_trip(&spec);
+}
+
+static void mock_disconnect(const host_config_t *host) {
+    (void)host;
+}
+
+const transport_ops_t mock_transport = {
+    "mock", CONNECTION_MOCK, mock_connect, mock_disconnect, mock_execute_stream
+};
@@ -1,18 +1,216 @@
+#define _GNU_SOURCE
 #include "network.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/types.h>
-#include <sys/stat.h>
 #include <sys/wait.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include "ssh_pool.h"
+#include "telnet_pool.h"
+#include "agent_client.h"
+#include "remote_proc.h"
+#include "mock_transport.h"
+#include "collector.h"
+#include "arena.h"
+#include "proc_parse.h"
+
+// Multiplexage OpenSSH : une connexion maître par hôte, gardée 60 s après la dernière commande.
+// Les sockets maîtres vont dans un répertoire 0700 créé par mkdtemp() : un chemin fixe
+// dans /tmp pourrait être créé d'avance par un autre utilisateur, qui recevrait alors
+// les commandes envoyées aux hôtes. %C est l'empreinte de l'utilisateur, de l'hôte et du port.
+#define SSH_CONTROL_TEMPLATE "/tmp/gestion-ssh-XXXXXX"
+static pthread_once_t ssh_control_once = PTHREAD_ONCE_INIT;
+static char ssh_control_dir[sizeof(SSH_CONTROL_TEMPLATE)];   // Vide : pas de multiplexage
+static char ssh_multiplex_options[128];
+
+// Échéance des opérations réseau du thread courant (0 = aucune)
+static __thread long long network_deadline_ms = 0;
+
+// Dernière erreur et dernier RTT mesuré du thread courant
+static __thread char network_error[128];
+static __thread int network_rtt_ms = -1;
 
 /**
- * @brief Exécute une commande shell et capture sa sortie
+ * @brief Retourne l'horloge monotone en millisecondes
+ */
+long long network_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Fixe l'échéance des opérations réseau du thread courant
+ *
+ * Chaque thread de collecte fixe l'échéance de l'hôte qu'il interroge :
+ * les commandes qui la dépassent sont interrompues et échouent, pour
+ * qu'un hôte lent ne bloque jamais plus longtemps que prévu.
+ *
+ * @param deadline_ms Échéance absolue (horloge de network_now_ms()), 0 pour aucune
+ */
+void network_set_deadline(long long deadline_ms) {
+    network_deadline_ms = deadline_ms;
+}
+
+long long network_get_deadline(void) {
+    return network_deadline_ms;
+}
+
+/**
+ * @brief Temps restant avant l'échéance du thread courant
+ *
+ * @return Millisecondes restantes (0 si dépassée), -1 si aucune échéance
+ */
+int network_remaining_ms(void) {
+    if (network_deadline_ms <= 0) return -1;
+    long long remaining = network_deadline_ms - network_now_ms();
+    return (remaining > 0) ? (int)remaining : 0;
+}
+
+/**
+ * @brief Efface la dernière erreur et le dernier RTT du thread courant
+ */
+void network_clear_error(void) {
+    network_error[0] = '\0';
+    network_rtt_ms = -1;
+}
+
+/**
+ * @brief Enregistre la cause d'un échec réseau pour le thread courant
  *
- * Cette fonction utilise popen() pour exécuter une commande système
- * et récupérer sa sortie standard dans un buffer.
+ * La première erreur d'une opération est conservée : c'est la plus précise
+ * (les couches supérieures n'ajoutent qu'un message générique).
+ */
+void network_set_error(const char *format, ...) {
+    if (network_error[0] != '\0') return;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(network_error, sizeof(network_error), format, args);
+    va_end(args);
+}
+
+const char *network_get_error(void) {
+    return network_error;
+}
+
+int network_last_rtt_ms(void) {
+    return network_rtt_ms;
+}
+
+// Sortie d'une commande capturée dans un buffer de taille fixe
+typedef struct {
+    char *output;
+    size_t size;
+    size_t len;
+} output_buffer_t;
+
+/**
+ * @brief Puits qui recopie la sortie dans un buffer de taille fixe
+ *
+ * Au-delà de la taille du buffer, la sortie est lue puis ignorée.
+ */
+static int output_buffer_sink(char *data, size_t len, void *context) {
+    output_buffer_t *buffer = context;
+    if (buffer->len + 1 >= buffer->size) return 0;
+
+    size_t copy = len;
+    if (buffer->len + copy > buffer->size - 1) copy = buffer->size - 1 - buffer->len;
+    memcpy(buffer->output + buffer->len, data, copy);
+    buffer->len += copy;
+    buffer->output[buffer->len] = '\0';
+    return 0;
+}
+
+/**
+ * @brief Exécute une commande shell et transmet sa sortie au fil de l'eau
+ *
+ * La commande est lancée par /bin/sh dans son propre groupe de processus,
+ * entrée standard sur /dev/null (pour ne pas voler les touches de
+ * l'interface). Si l'échéance du thread est dépassée, tout le groupe
+ * (ssh, sshpass, expect...) est tué et la fonction échoue.
+ *
+ * @param cmd Commande shell à exécuter
+ * @param sink Puits recevant chaque bloc lu sur la sortie de la commande
+ * @param context Contexte du puits
+ * @return Code de retour de la commande (0 pour succès), -1 en cas d'erreur
+ */
+static int run_command_stream(const char *cmd, output_sink_t sink, void *context) {
+    int pipefd[2];
+    if (pipe2(pipefd, O_CLOEXEC) == -1) {
+        network_set_error("pipe : %s", strerror(errno));
+        return -1;
+    }
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        network_set_error("fork : %s", strerror(errno));
+        close(pipefd[0]);
+        close(pipefd[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        setpgid(0, 0);
+        int devnull = open("/dev/null", O_RDONLY);
+        if (devnull != -1) dup2(devnull, STDIN_FILENO);
+        dup2(pipefd[1], STDOUT_FILENO);
+        execl("/bin/sh", "sh", "-c", cmd, (char *)NULL);
+        _exit(127);
+    }
+
+    close(pipefd[1]);
+
+    int interrupted = 0;
+    char buffer[16384];
+
+    for (;;) {
+        struct pollfd pfd = { .fd = pipefd[0], .events = POLLIN, .revents = 0 };
+        int ready = poll(&pfd, 1, network_remaining_ms());
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (ready == 0) {
+            network_set_error("échéance dépassée");
+            interrupted = 1;
+            break;
+        }
+
+        ssize_t n = read(pipefd[0], buffer, sizeof(buffer));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (n == 0) break;
+
+        if (sink(buffer, (size_t)n, context) != 0) {
+            interrupted = 1;
+            break;
+        }
+    }
+
+    close(pipefd[0]);
+    if (interrupted) kill(-pid, SIGKILL);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {}
+
+    if (interrupted) return -1;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/**
+ * @brief Exécute une commande shell et capture sa sortie
  *
  * @param cmd Commande shell à exécuter
  * @param output Buffer pour stocker la sortie de la commande
@@ -20,395 +218,643 @@
  * @return Code de retour de la commande (0 pour succès), -1 en cas d'erreur
  */
 static int run_command(const char *cmd, char *output, int output_size) {
-    FILE *fp = popen(cmd, "r");
-    if (!fp) return -1;
-
+    if (!output || output_size <= 0) return -1;
     output[0] = '\0';
-    char buffer[256];
-    size_t total = 0;
-    size_t output_size_t = (size_t)output_size;  // Conversion pour comparaison
-
-    while (fgets(buffer, sizeof(buffer), fp) != NULL && total < output_size_t - 1) {
-        size_t len = strlen(buffer);
-        if (total + len < output_size_t) {
-            strcat(output, buffer);
-            total += len;
+    output_buffer_t buffer = { output, (size_t)output_size, 0 };
+    return run_command_stream(cmd, output_buffer_sink, &buffer);
+}
+
+/**
+ * @brief Protège une chaîne pour le shell local (entre apostrophes)
+ *
+ * Les apostrophes de la chaîne deviennent '\'' : la commande distante
+ * arrive intacte au client ssh, quel que soit son contenu.
+ *
+ * @param text Chaîne à protéger
+ * @return Chaîne allouée (à libérer), ou NULL en cas d'erreur d'allocation
+ */
+char *network_shell_quote(const char *text) {
+    size_t quotes = 0;
+    for (const char *p = text; *p; p++) {
+        if (*p == '\'') quotes++;
+    }
+
+    char *quoted = malloc(strlen(text) + quotes * 3 + 3);
+    if (!quoted) return NULL;
+
+    char *out = quoted;
+    *out++ = '\'';
+    for (const char *p = text; *p; p++) {
+        if (*p == '\'') {
+            memcpy(out, "'\\''", 4);
+            out += 4;
+        } else {
+            *out++ = *p;
         }
     }
+    *out++ = '\'';
+    *out = '\0';
+    return quoted;
+}
 
-    int status = pclose(fp);
-    return WEXITSTATUS(status);
+/**
+ * @brief Indique si sshpass est installé (vérifié une seule fois)
+ *
+ * @return 1 si sshpass est disponible, 0 sinon
+ */
+static int sshpass_available(void) {
+    static int cached = -1;
+    if (cached == -1) {
+        cached = (system("which sshpass > /dev/null 2>&1") == 0) ? 1 : 0;
+    }
+    return cached;
+}
+
+/**
+ * @brief Crée le répertoire privé des sockets maîtres (une fois par processus)
+ *
+ * Si mkdtemp() échoue, les commandes ssh sont lancées sans multiplexage.
+ */
+static void ssh_control_init(void) {
+    char directory[] = SSH_CONTROL_TEMPLATE;
+    if (!mkdtemp(directory)) return;
+    snprintf(ssh_control_dir, sizeof(ssh_control_dir), "%s", directory);
+    snprintf(ssh_multiplex_options, sizeof(ssh_multiplex_options),
+             "-o ControlMaster=auto -o ControlPath=%s/%%C -o ControlPersist=60 ", ssh_control_dir);
 }
 
 /**
  * @brief Exécute une commande sur une machine distante via SSH
  *
- * Utilise la commande ssh (ou sshpass si mot de passe fourni) pour
- * exécuter une commande sur un hôte distant.
+ * Utilise en priorité le pool de sessions libssh (une session authentifiée
+ * conservée par hôte, un canal par commande). Sans libssh, se rabat sur la
+ * commande ssh (ou sshpass si mot de passe fourni) avec le multiplexage
+ * OpenSSH (ControlMaster) pour ne payer la poignée de main qu'une fois.
+ * La sortie est transmise au puits au fil de sa réception, sans limite de taille.
  *
  * @param host Adresse de l'hôte distant
  * @param port Port SSH (généralement 22)
  * @param username Nom d'utilisateur pour la connexion
  * @param password Mot de passe (peut être NULL pour utiliser les clés SSH)
  * @param command Commande à exécuter sur l'hôte distant
- * @param output Buffer pour stocker la sortie de la commande
- * @param output_size Taille maximale du buffer de sortie
- * @return 0 en cas de succès, -1 en cas d'erreur
+ * @param sink Puits recevant la sortie de la commande
+ * @param context Contexte du puits
+ * @return Code de retour de la commande distante, -1 en cas d'erreur
  */
-int ssh_execute(const char *host, int port, const char *username, const char *password,
-                const char *command, char *output, int output_size) {
-    char cmd[1024];
+int ssh_execute_stream(const char *host, int port, const char *username, const char *password,
+                       const char *command, output_sink_t sink, void *context) {
+    if (ssh_pool_available()) {
+        return ssh_pool_execute(host, port, username, password, command, sink, context);
+    }
 
     // Si mot de passe fourni, utiliser sshpass
-    if (password != NULL && strlen(password) > 0) {
-        // Vérifier si sshpass est disponible
-        if (system("which sshpass > /dev/null 2>&1") != 0) {
-            fprintf(stderr, "Warning: sshpass non installé. Installation: sudo apt-get install sshpass\n");
-            return -1;
-        }
+    if (password != NULL && strlen(password) > 0 && !sshpass_available()) {
+        network_set_error("sshpass non installé");
+        return -1;
+    }
+
+    pthread_once(&ssh_control_once, ssh_control_init);
 
-        snprintf(cmd, sizeof(cmd),
-                 "sshpass -p '%s' ssh -o StrictHostKeyChecking=no -o ConnectTimeout=3 "
-                 "-p %d %s@%s '%s' 2>/dev/null",
-                 password, port, username, host, command);
+    char *quoted_command = network_shell_quote(command);
+    char *quoted_password = network_shell_quote(password ? password : "");
+    if (!quoted_command || !quoted_password) {
+        free(quoted_command);
+        free(quoted_password);
+        return -1;
+    }
+
+    char *cmd = NULL;
+    int length;
+    if (password != NULL && strlen(password) > 0) {
+        length = asprintf(&cmd,
+                          "sshpass -p %s ssh -o StrictHostKeyChecking=no -o ConnectTimeout=3 "
+                          "%s-p %d %s@%s %s 2>/dev/null",
+                          quoted_password, ssh_multiplex_options, port, username, host, quoted_command);
     } else {
         // Sans mot de passe (utilise les clés SSH par défaut)
-        snprintf(cmd, sizeof(cmd),
-                 "ssh -o StrictHostKeyChecking=no -o ConnectTimeout=3 "
-                 "-p %d %s@%s '%s' 2>/dev/null",
-                 port, username, host, command);
+        length = asprintf(&cmd,
+                          "ssh -o StrictHostKeyChecking=no -o ConnectTimeout=3 "
+                          "%s-p %d %s@%s %s 2>/dev/null",
+                          ssh_multiplex_options, port, username, host, quoted_command);
     }
+    free(quoted_command);
+    free(quoted_password);
+    if (length < 0) return -1;
+
+    int result = run_command_stream(cmd, sink, context);
+    free(cmd);
+    if (result == 255) network_set_error("ssh : connexion ou authentification impossible");
+    return result;
+}
 
-    return run_command(cmd, output, output_size);
+/**
+ * @brief Exécute une commande sur une machine distante via SSH
+ *
+ * Variante de ssh_execute_stream() qui capture la sortie dans un buffer.
+ *
+ * @param output Buffer pour stocker la sortie de la commande
+ * @param output_size Taille maximale du buffer de sortie
+ * @return Code de retour de la commande distante, -1 en cas d'erreur
+ */
+int ssh_execute(const char *host, int port, const char *username, const char *password,
+                const char *command, char *output, int output_size) {
+    if (!output || output_size <= 0) return -1;
+    output[0] = '\0';
+    output_buffer_t buffer = { output, (size_t)output_size, 0 };
+    return ssh_execute_stream(host, port, username, password, command, output_buffer_sink, &buffer);
 }
 
 /**
  * @brief Exécute une commande sur une machine distante via Telnet
  *
- * Utilise Telnet avec un script Expect pour automatiser la connexion
- * et l'exécution de commandes.
+ * Utilise le client telnet intégré (telnet_pool) : une session connectée
+ * et authentifiée par hôte, réutilisée d'une commande à l'autre. La sortie
+ * est transmise au puits au fil de sa réception.
  *
  * @param host Adresse de l'hôte distant
  * @param port Port Telnet (généralement 23)
  * @param username Nom d'utilisateur pour la connexion
  * @param password Mot de passe pour la connexion
  * @param command Commande à exécuter sur l'hôte distant
+ * @param sink Puits recevant la sortie de la commande
+ * @param context Contexte du puits
+ * @return Code de retour de la commande distante, -1 en cas d'erreur
+ */
+int telnet_execute_stream(const char *host, int port, const char *username, const char *password,
+                          const char *command, output_sink_t sink, void *context) {
+    return telnet_pool_execute(host, port, username, password, command, sink, context);
+}
+
+/**
+ * @brief Exécute une commande sur une machine distante via Telnet
+ *
+ * Variante de telnet_execute_stream() qui capture la sortie dans un buffer.
+ *
  * @param output Buffer pour stocker la sortie de la commande
  * @param output_size Taille maximale du buffer de sortie
  * @return 0 en cas de succès, -1 en cas d'erreur
  */
 int telnet_execute(const char *host, int port, const char *username, const char *password,
                    const char *command, char *output, int output_size) {
-    // Vérifier si expect est disponible
-    if (system("which expect > /dev/null 2>&1") != 0) {
-        fprintf(stderr, "Warning: expect non installé. Installation: sudo apt-get install expect\n");
+    if (!output || output_size <= 0) return -1;
+    output[0] = '\0';
+    output_buffer_t buffer = { output, (size_t)output_size, 0 };
+    return telnet_execute_stream(host, port, username, password, command, output_buffer_sink, &buffer);
+}
+
+// Puits intermédiaire mesurant le délai avant le premier octet reçu
+typedef struct {
+    output_sink_t sink;
+    void *context;
+    long long start_ms;
+    int received;
+} rtt_sink_t;
+
+static int rtt_sink(char *data, size_t len, void *context) {
+    rtt_sink_t *rtt = context;
+    if (!rtt->received) {
+        rtt->received = 1;
+        network_rtt_ms = (int)(network_now_ms() - rtt->start_ms);
+    }
+    return rtt->sink(data, len, rtt->context);
+}
+
+/**
+ * @brief Exécute une commande sur un hôte distant selon son type de connexion
+ *
+ * Le délai avant le premier octet de la réponse est retenu comme RTT de
+ * l'hôte (voir network_last_rtt_ms()) : il comprend l'aller-retour réseau
+ * et le lancement de la commande, ce que voit réellement l'utilisateur.
+ *
+ * @param host Configuration de l'hôte distant
+ * @param command Commande à exécuter
+ * @param sink Puits recevant la sortie de la commande
+ * @param context Contexte du puits
+ * @return Code de retour de la commande distante, -1 en cas d'erreur
+ */
+int execute_remote_command_stream(const host_config_t *host, const char *command,
+                                  output_sink_t sink, void *context) {
+    const transport_ops_t *transport = transport_for(host);
+    if (!transport) {
+        network_set_error("type de connexion inconnu");
         return -1;
     }
 
-    // Créer un script expect temporaire
-    char script_path[] = "/tmp/telnet_script_XXXXXX";
-    int fd = mkstemp(script_path);
-    if (fd == -1) return -1;
-
-    char script[1024];
-    snprintf(script, sizeof(script),
-             "#!/usr/bin/expect -f\n"
-             "set timeout 5\n"
-             "spawn telnet %s %d\n"
-             "expect \"login:\"\n"
-             "send \"%s\\r\"\n"
-             "expect \"Password:\"\n"
-             "send \"%s\\r\"\n"
-             "expect {\n"
-             "  \">\" {\n"
-             "    send \"%s\\r\"\n"
-             "    expect \">\"\n"
-             "    send \"exit\\r\"\n"
-             "    expect eof\n"
-             "  }\n"
-             "  timeout {\n"
-             "    exit 1\n"
-             "  }\n"
-             "}\n", host, port, username, password, command);
-
-    write(fd, script, strlen(script));
-    close(fd);
-    chmod(script_path, 0700);
-
-    char cmd[1024];
-    snprintf(cmd, sizeof(cmd), "%s 2>/dev/null | tail -n +3", script_path);
-
-    int result = run_command(cmd, output, output_size);
-
-    // Nettoyer le script temporaire
-    unlink(script_path);
+    rtt_sink_t rtt = { sink, context, network_now_ms(), 0 };
+    return transport->execute_stream(host, command, rtt_sink, &rtt);
+}
 
-    return result;
+/**
+ * @brief Exécute une commande sur un hôte distant et capture sa sortie
+ *
+ * @param host Configuration de l'hôte distant
+ * @param command Commande à exécuter
+ * @param output Buffer pour stocker la sortie de la commande
+ * @param output_size Taille maximale du buffer de sortie
+ * @return Code de retour de la commande distante, -1 en cas d'erreur
+ */
+int execute_remote_command(const host_config_t *host, const char *command, char *output, int output_size) {
+    if (!output || output_size <= 0) return -1;
+    output[0] = '\0';
+    output_buffer_t buffer = { output, (size_t)output_size, 0 };
+    return execute_remote_command_stream(host, command, output_buffer_sink, &buffer);
+}
+
+/**
+ * @brief Réserve une nouvelle entrée à la fin du registre des hôtes
+ *
+ * Le registre est agrandi par doublement : aucune limite sur le nombre d'hôtes.
+ *
+ * @return Pointeur vers l'entrée (remise à zéro, valeurs par défaut), ou NULL en cas d'erreur d'allocation
+ */
+static host_config_t *host_registry_push(host_config_t **hosts, int *count, int *capacity) {
+    if (*count >= *capacity) {
+        int new_capacity = *capacity ? *capacity * 2 : 16;
+        host_config_t *tmp = realloc(*hosts, sizeof(host_config_t) * new_capacity);
+        if (!tmp) return NULL;
+        *hosts = tmp;
+        *capacity = new_capacity;
+    }
+
+    host_config_t *host = &(*hosts)[(*count)++];
+    memset(host, 0, sizeof(host_config_t));
+    host->mode = COLLECT_PS;
+    host->interval_ms = DEFAULT_POLL_INTERVAL_MS;
+    host->deadline_ms = DEFAULT_DEADLINE_MS;
+    return host;
 }
 
 /**
  * @brief Parse un fichier de configuration réseau
  *
- * Lit un fichier texte au format "name:address:port:username:password:type"
- * pour configurer les connexions aux hôtes distants.
+ * Lit un fichier texte au format
+ * "name:address:port:username:password:type[:mode[:interval_ms[:deadline_ms]]]"
+ * pour configurer les connexions aux hôtes distants. Le mode optionnel
+ * "agent" utilise l'agent de collecte distant au lieu de ps, "proc" un script
+ * awk lisant /proc sur l'hôte distant ("ps" sinon). Le type "mock" simule
+ * un hôte en mémoire, l'adresse portant alors ses paramètres (voir
+ * mock_transport.h) ; le type "replay" rejoue un enregistrement de l'agent
+ * dont le chemin est donné à la place de l'adresse (voir collector.h).
+ * localhost est toujours le premier hôte, même sans fichier.
  *
  * @param filename Chemin vers le fichier de configuration
- * @param hosts Tableau pour stocker les configurations d'hôtes
- * @param max_hosts Nombre maximum d'hôtes pouvant être stockés
+ * @param hosts Pointeur qui recevra le tableau alloué des hôtes (à libérer)
  * @return Nombre d'hôtes configurés, ou -1 en cas d'erreur
  */
-int parse_config_file(const char *filename, host_config_t *hosts, int max_hosts) {
+int parse_config_file(const char *filename, host_config_t **hosts) {
+    host_config_t *registry = NULL;
+    int count = 0;
+    int capacity = 0;
+
+    // Ajouter localhost en premier
+    host_config_t *local = host_registry_push(&registry, &count, &capacity);
+    if (!local) return -1;
+    strcpy(local->name, "localhost");
+    strcpy(local->address, "127.0.0.1");
+    local->type = CONNECTION_LOCAL;
+    local->is_local = 1;
+
     FILE *file = fopen(filename, "r");
     if (!file) {
-        // Fichier non trouvé, créer localhost par défaut
-        strcpy(hosts[0].name, "localhost");
-        strcpy(hosts[0].address, "127.0.0.1");
-        hosts[0].port = 22;
-        hosts[0].type = CONNECTION_LOCAL;
-        hosts[0].is_local = 1;
-        hosts[0].username[0] = '\0';
-        hosts[0].password[0] = '\0';
-        return 1;
+        // Fichier non trouvé : localhost seul
+        *hosts = registry;
+        return count;
     }
 
     char line[512];
-    int count = 0;
-
-    // Ajouter localhost en premier
-    strcpy(hosts[count].name, "localhost");
-    strcpy(hosts[count].address, "127.0.0.1");
-    hosts[count].port = 0;
-    hosts[count].type = CONNECTION_LOCAL;
-    hosts[count].is_local = 1;
-    hosts[count].username[0] = '\0';
-    hosts[count].password[0] = '\0';
-    count++;
-
-    while (fgets(line, sizeof(line), file) && count < max_hosts) {
+    while (fgets(line, sizeof(line), file)) {
         // Ignorer lignes vides et commentaires
         if (line[0] == '\n' || line[0] == '#' || line[0] == '\r') continue;
 
         // Supprimer le retour à la ligne
         line[strcspn(line, "\n\r")] = '\0';
 
-        // Parser : name:address:port:username:password:type
-        char *tokens[6];
-        char *saveptr;
+        // Parser : name:address:port:username:password:type[:mode[:interval_ms[:deadline_ms]]]
+        // (strsep conserve les champs vides, ex. mot de passe absent)
+        char *tokens[9];
+        char *cursor = line;
         int token_count = 0;
 
-        char *token = strtok_r(line, ":", &saveptr);
-        while (token && token_count < 6) {
+        char *token;
+        while (token_count < 9 && (token = strsep(&cursor, ":")) != NULL) {
             tokens[token_count++] = token;
-            token = strtok_r(NULL, ":", &saveptr);
         }
 
         if (token_count < 6) continue;
 
+        host_config_t *host = host_registry_push(&registry, &count, &capacity);
+        if (!host) {
+            fclose(file);
+            free(registry);
+            return -1;
+        }
+
         // Remplir la structure
-        strncpy(hosts[count].name, tokens[0], sizeof(hosts[count].name) - 1);
-        strncpy(hosts[count].address, tokens[1], sizeof(hosts[count].address) - 1);
-        hosts[count].port = atoi(tokens[2]);
-        if (hosts[count].port <= 0) hosts[count].port = 22; // Port par défaut
-
-        strncpy(hosts[count].username, tokens[3], sizeof(hosts[count].username) - 1);
-        strncpy(hosts[count].password, tokens[4], sizeof(hosts[count].password) - 1);
-
-        if (strcmp(tokens[5], "ssh") == 0) {
-            hosts[count].type = CONNECTION_SSH;
-        } else if (strcmp(tokens[5], "telnet") == 0) {
-            hosts[count].type = CONNECTION_TELNET;
+        strncpy(host->name, tokens[0], sizeof(host->name) - 1);
+        strncpy(host->address, tokens[1], sizeof(host->address) - 1);
+        host->port = atoi(tokens[2]);
+        if (host->port <= 0) host->port = 22; // Port par défaut
+
+        strncpy(host->username, tokens[3], sizeof(host->username) - 1);
+        strncpy(host->password, tokens[4], sizeof(host->password) - 1);
+
+        const transport_ops_t *transport = transport_find(tokens[5]);
+        if (transport) {
+            host->type = transport->type;
+        } else if (strcmp(tokens[5], "replay") == 0) {
+            host->type = CONNECTION_REPLAY;
         } else {
-            hosts[count].type = CONNECTION_LOCAL;
+            host->type = CONNECTION_LOCAL;
         }
 
-        hosts[count].is_local = 0;
-        count++;
+        if (token_count >= 7 && strcmp(tokens[6], "agent") == 0) {
+            host->mode = COLLECT_AGENT;
+        } else if (token_count >= 7 && strcmp(tokens[6], "proc") == 0) {
+            host->mode = COLLECT_PROC;
+        }
+
+        if (token_count >= 8 && atoi(tokens[7]) > 0) {
+            host->interval_ms = atoi(tokens[7]);
+        }
+        if (token_count >= 9 && atoi(tokens[8]) > 0) {
+            host->deadline_ms = atoi(tokens[8]);
+        }
     }
 
     fclose(file);
+    *hosts = registry;
     return count;
 }
 
+// Liste de processus distants en cours de construction (agrandie à la demande)
+typedef struct {
+    process_info_t *list;
+    int count;
+    int capacity;
+    ps_format_t format;
+} remote_list_t;
+
+/**
+ * @brief Réserve une nouvelle entrée à la fin d'une liste distante
+ *
+ * @return Pointeur vers l'entrée (remise à zéro), ou NULL en cas d'erreur d'allocation
+ */
+static process_info_t *remote_list_push(remote_list_t *remote) {
+    if (remote->count >= remote->capacity) {
+        int capacity = remote->capacity ? remote->capacity * 2 : snapshot_capacity_hint(256);
+        process_info_t *tmp = snapshot_realloc(remote->list, sizeof(process_info_t) * remote->capacity,
+                                               sizeof(process_info_t) * capacity);
+        if (!tmp) return NULL;
+        remote->list = tmp;
+        remote->capacity = capacity;
+    }
+
+    process_info_t *proc = &remote->list[remote->count++];
+    memset(proc, 0, sizeof(process_info_t));
+    return proc;
+}
+
+/**
+ * @brief Analyse une ligne de sortie de ps (voir proc_parse_ps_line())
+ *
+ * Appelée par le découpeur de lignes au fur et à mesure de la réception.
+ *
+ * @param line Ligne reçue (sans '\n')
+ * @param len Longueur de la ligne
+ * @param context Liste distante en construction (remote_list_t)
+ * @return 0 pour continuer, -1 en cas d'erreur d'allocation
+ */
+static int ps_line_handler(char *line, size_t len, void *context) {
+    remote_list_t *remote = context;
+    process_info_t parsed;
+    if (proc_parse_ps_line(line, len, remote->format, &parsed) != 0) return 0;
+
+    process_info_t *proc = remote_list_push(remote);
+    if (!proc) return -1;
+    *proc = parsed;
+    return 0;
+}
+
+/**
+ * @brief Exécute une commande ps distante et analyse sa sortie en un seul passage
+ *
+ * La sortie est découpée en lignes au fil de sa réception depuis le
+ * transport : ni buffer de taille fixe, ni limite sur le nombre de processus.
+ *
+ * @return Code de retour de la commande, -1 en cas d'erreur
+ */
+static int fetch_ps_output(const host_config_t *host, const char *command, ps_format_t format,
+                           remote_list_t *remote) {
+    line_parser_t parser;
+    line_parser_init(&parser, ps_line_handler, remote);
+    remote->count = 0;
+    remote->format = format;
+
+    int result = execute_remote_command_stream(host, command, line_parser_sink, &parser);
+    if (result == 0 && line_parser_finish(&parser) != 0) result = -1;
+
+    line_parser_free(&parser);
+    return result;
+}
+
 /**
- * @brief Récupère la liste des processus d'un hôte distant
+ * @brief Récupère la liste des processus d'un hôte distant avec ps
  *
  * Exécute la commande 'ps' sur l'hôte distant et parse sa sortie
- * pour construire une liste de processus.
+ * pour construire une liste de processus (format procps, puis "ps aux"
+ * en repli).
  *
  * @param host Configuration de l'hôte distant
  * @param list Pointeur vers un tableau qui contiendra la liste des processus
  * @param count Pointeur vers un entier qui contiendra le nombre de processus
  * @return 0 en cas de succès, -1 en cas d'erreur
  */
-int get_remote_process_list(const host_config_t *host, process_info_t **list, int *count) {
-    if (host->is_local) {
-        // Utiliser la fonction locale
-        extern int get_process_list(process_info_t **list, int *count);
-        return get_process_list(list, count);
-    }
+int remote_ps_fetch(const host_config_t *host, process_info_t **list, int *count) {
+    remote_list_t remote = { NULL, 0, 0, PS_FORMAT_COLUMNS };
 
-    // Commande pour récupérer les processus (compatible Linux)
-    // Format simple: PID, CPU%, MEM%, COMMAND
-    const char *cmd = "ps -eo pid,pcpu,pmem,comm --no-headers --sort=-pcpu | head -50";
-    char output[8192];
-
-    int result;
-    if (host->type == CONNECTION_SSH) {
-        result = ssh_execute(host->address, host->port, host->username,
-                           host->password, cmd, output, sizeof(output));
-    } else {
-        result = telnet_execute(host->address, host->port, host->username,
-                              host->password, cmd, output, sizeof(output));
-    }
+    // Commande pour récupérer les processus (procps)
+    // Note : pcpu est la moyenne sur la vie du processus, pas une valeur instantanée
+    int result = fetch_ps_output(host, "ps -eo pid,ppid,stat,pcpu,rss,etimes,comm --no-headers",
+                                 PS_FORMAT_COLUMNS, &remote);
 
     if (result != 0) {
         // Fallback: commande plus simple
-        const char *simple_cmd = "ps aux --no-headers | head -50";
-        if (host->type == CONNECTION_SSH) {
-            result = ssh_execute(host->address, host->port, host->username,
-                               host->password, simple_cmd, output, sizeof(output));
-        } else {
-            result = telnet_execute(host->address, host->port, host->username,
-                                  host->password, simple_cmd, output, sizeof(output));
-        }
+        result = fetch_ps_output(host, "ps aux", PS_FORMAT_AUX, &remote);
+    }
 
-        if (result != 0) return -1;
-    }
-
-    // Parser la sortie
-    char *lines[100];  // Max 100 processus
-    int line_count = 0;
-    char *saveptr;
-
-    char *line = strtok_r(output, "\n", &saveptr);
-    while (line && line_count < 100) {
-        lines[line_count] = line;
-        line_count++;
-        line = strtok_r(NULL, "\n", &saveptr);
-    }
-
-    // Allouer mémoire pour les processus
-    *list = malloc(sizeof(process_info_t) * line_count);
-    if (!*list) return -1;
-
-    for (int i = 0; i < line_count; i++) {
-        process_info_t *proc = &(*list)[i];
-        memset(proc, 0, sizeof(process_info_t));
-
-        // Initialiser avec des valeurs par défaut
-        proc->pid = i + 1;
-        proc->cpu_percent = 0.0f;
-        proc->memory_kb = 0;
-        proc->time = 0.0f;
-        proc->state = 'R';
-        proc->ppid = 1;
-        proc->is_kernel = 0;
-
-        // Tenter différents formats de parsing
-        char name_buf[256] = {0};
-        float cpu_temp = 0.0f;
-        float mem_temp = 0.0f;
-        int pid_temp = 0;
-
-        // Format 1: ps -eo pid,pcpu,pmem,comm
-        if (sscanf(lines[i], "%d %f %f %255s",
-                   &pid_temp, &cpu_temp, &mem_temp, name_buf) >= 4) {
-            proc->pid = pid_temp;
-            proc->cpu_percent = cpu_temp;
-            // Convertir % de mémoire en kB (approximation)
-            proc->memory_kb = (int)(mem_temp * 1024);
-            strncpy(proc->name, name_buf, sizeof(proc->name) - 1);
-        }
-        // Format 2: ps aux (plus courant)
-        else if (sscanf(lines[i], "%*s %d %*f %f %f %*s %*s %*s %*s %*s %255s",
-                       &pid_temp, &cpu_temp, &mem_temp, name_buf) >= 4) {
-            proc->pid = pid_temp;
-            proc->cpu_percent = cpu_temp;
-            proc->memory_kb = (int)(mem_temp * 1024);
-            strncpy(proc->name, name_buf, sizeof(proc->name) - 1);
-        }
-        // Format 3: juste le nom
-        else {
-            sscanf(lines[i], "%255s", name_buf);
-            strncpy(proc->name, name_buf, sizeof(proc->name) - 1);
-        }
+    if (result != 0) {
+        network_set_error("ps : code de retour %d", result);
+        snapshot_free(remote.list);
+        return -1;
+    }
 
-        // Nettoyer le nom si nécessaire
-        char *newline = strchr(proc->name, '\n');
-        if (newline) *newline = '\0';
+    if (!remote.list) {
+        remote.list = snapshot_alloc(sizeof(process_info_t));
+        if (!remote.list) return -1;
     }
 
-    *count = line_count;
+    *list = remote.list;
+    *count = remote.count;
     return 0;
 }
 
 /**
- * @brief Tue un processus sur un hôte distant
+ * @brief Récupère la liste des processus d'un hôte en une collecte ponctuelle
  *
- * @param host Configuration de l'hôte distant
- * @param pid PID du processus à tuer
+ * Passe par le backend de collecte de l'hôte (voir collector.h) : ps ou
+ * script /proc selon le mode, instantané de l'agent distant, ou /proc local.
+ * Les sources avec état propre (rejeu) demandent un collecteur ouvert par
+ * collector_open().
+ *
+ * @param host Configuration de l'hôte
+ * @param list Pointeur vers un tableau qui contiendra la liste des processus
+ * @param count Pointeur vers un entier qui contiendra le nombre de processus
  * @return 0 en cas de succès, -1 en cas d'erreur
  */
-int remote_kill_process(const host_config_t *host, int pid) {
-    if (host->is_local) {
-        extern int kill_process(int pid);
-        return kill_process(pid);
+int get_remote_process_list(const host_config_t *host, process_info_t **list, int *count) {
+    const collector_backend_t *backend = collector_backend_for(host);
+    if (!backend || backend->init) {
+        network_set_error("source sans collecte ponctuelle");
+        return -1;
     }
+    return backend->sample((void *)host, list, count);
+}
 
-    if (pid <= 0) return -1;
-
-    char command[64];
-    snprintf(command, sizeof(command), "kill -9 %d 2>/dev/null; echo $?", pid);
-    char output[256];
+// Résultats d'un lot d'actions en cours de lecture
+typedef struct {
+    int *results;
+    int count;
+} action_results_t;
 
-    int result;
-    if (host->type == CONNECTION_SSH) {
-        result = ssh_execute(host->address, host->port, host->username,
-                           host->password, command, output, sizeof(output));
-    } else {
-        result = telnet_execute(host->address, host->port, host->username,
-                              host->password, command, output, sizeof(output));
+/**
+ * @brief Analyse une ligne "index code" renvoyée par le lot d'actions
+ */
+static int action_line_handler(char *line, size_t len, void *context) {
+    action_results_t *batch = context;
+    int index = -1, status = -1;
+    if (len > 0 && sscanf(line, "%d %d", &index, &status) == 2 &&
+        index >= 0 && index < batch->count) {
+        batch->results[index] = (status == 0) ? 0 : -1;
     }
+    return 0;
+}
 
-    if (result != 0) return -1;
-
-    // Vérifier le code de retour
-    int exit_code = atoi(output);
-    return (exit_code == 0) ? 0 : -1;
+/**
+ * @brief Applique une action à un processus local
+ */
+static int local_process_action(int pid, process_action_t action) {
+    switch (action) {
+        case PROCESS_ACTION_KILL:    return kill_process(pid);
+        case PROCESS_ACTION_PAUSE:   return pause_process(pid);
+        case PROCESS_ACTION_RESUME:  return resume_process(pid);
+        case PROCESS_ACTION_RESTART: return restart_process(pid);
+    }
+    return -1;
 }
 
 /**
- * @brief Met en pause un processus sur un hôte distant
+ * @brief Applique un lot d'actions aux processus d'un hôte
  *
- * @param host Configuration de l'hôte distant
- * @param pid PID du processus à mettre en pause
- * @return 0 en cas de succès, -1 en cas d'erreur
+ * Sur un hôte distant, toutes les actions partent dans une seule commande
+ * shell ; chacune écrit "index code_retour" sur sa propre ligne, ce qui
+ * donne un résultat par action pour un seul aller-retour. Le redémarrage
+ * envoie SIGTERM puis SIGCONT, comme restart_process() en local.
+ *
+ * @param host Configuration de l'hôte
+ * @param pids PID visés
+ * @param actions Action à appliquer à chaque PID
+ * @param results Résultat de chaque action (0 succès, -1 échec)
+ * @param count Nombre d'actions
+ * @return 0 si la commande a pu être exécutée, -1 sinon (toutes les actions en échec)
  */
-int remote_pause_process(const host_config_t *host, int pid) {
+int remote_process_actions(const host_config_t *host, const int *pids, const process_action_t *actions,
+                           int *results, int count) {
+    for (int i = 0; i < count; i++) results[i] = -1;
+    if (count <= 0) return 0;
+
     if (host->is_local) {
-        extern int pause_process(int pid);
-        return pause_process(pid);
+        for (int i = 0; i < count; i++) {
+            if (pids[i] > 0) results[i] = local_process_action(pids[i], actions[i]);
+        }
+        return 0;
     }
 
-    if (pid <= 0) return -1;
-
-    char command[64];
-    snprintf(command, sizeof(command), "kill -STOP %d 2>/dev/null; echo $?", pid);
-    char output[256];
+    // Environ 80 caractères par action au plus
+    size_t size = (size_t)count * 96 + 1;
+    char *command = malloc(size);
+    if (!command) return -1;
+
+    size_t used = 0;
+    command[0] = '\0';
+    for (int i = 0; i < count; i++) {
+        int pid = pids[i];
+        if (pid <= 0) continue;
+
+        switch (actions[i]) {
+            case PROCESS_ACTION_KILL:
+                used += snprintf(command + used, size - used, "kill -9 %d 2>/dev/null; echo \"%d $?\"; ", pid, i);
+                break;
+            case PROCESS_ACTION_PAUSE:
+                used += snprintf(command + used, size - used, "kill -STOP %d 2>/dev/null; echo \"%d $?\"; ", pid, i);
+                break;
+            case PROCESS_ACTION_RESUME:
+                used += snprintf(command + used, size - used, "kill -CONT %d 2>/dev/null; echo \"%d $?\"; ", pid, i);
+                break;
+            case PROCESS_ACTION_RESTART:
+                used += snprintf(command + used, size - used,
+                                 "kill -TERM %d 2>/dev/null && kill -CONT %d 2>/dev/null; echo \"%d $?\"; ",
+                                 pid, pid, i);
+                break;
+        }
+    }
 
-    int result;
-    if (host->type == CONNECTION_SSH) {
-        result = ssh_execute(host->address, host->port, host->username,
-                           host->password, command, output, sizeof(output));
-    } else {
-        result = telnet_execute(host->address, host->port, host->username,
-                              host->password, command, output, sizeof(output));
+    if (used == 0) {
+        free(command);
+        return 0;
     }
 
-    if (result != 0) return -1;
+    action_results_t batch = { results, count };
+    line_parser_t parser;
+    line_parser_init(&parser, action_line_handler, &batch);
+    int result = execute_remote_command_stream(host, command, line_parser_sink, &parser);
+    if (result == 0) line_parser_finish(&parser);
+    line_parser_free(&parser);
+    free(command);
 
-    int exit_code = atoi(output);
-    return (exit_code == 0) ? 0 : -1;
+    return (result == 0) ? 0 : -1;
+}
+
+/**
+ * @brief Applique une seule action à un processus d'un hôte
+ */
+static int remote_process_action(const host_config_t *host, int pid, process_action_t action) {
+    if (pid <= 0) return -1;
+
+    int result = -1;
+    if (remote_process_actions(host, &pid, &action, &result, 1) != 0) return -1;
+    return result;
+}
+
+/**
+ * @brief Tue un processus sur un hôte distant
+ *
+ * @param host Configuration de l'hôte distant
+ * @param pid PID du processus à tuer
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int remote_kill_process(const host_config_t *host, int pid) {
+    return remote_process_action(host, pid, PROCESS_ACTION_KILL);
+}
+
+/**
+ * @brief Met en pause un processus sur un hôte distant
+ *
+ * @param host Configuration de l'hôte distant
+ * @param pid PID du processus à mettre en pause
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int remote_pause_process(const host_config_t *host, int pid) {
+    return remote_process_action(host, pid, PROCESS_ACTION_PAUSE);
 }
 
 /**
@@ -419,30 +865,7 @@ int remote_pause_process(const host_config_t *host, int pid) {
  * @return 0 en cas de succès, -1 en cas d'erreur
  */
 int remote_resume_process(const host_config_t *host, int pid) {
-    if (host->is_local) {
-        extern int resume_process(int pid);
-        return resume_process(pid);
-    }
-
-    if (pid <= 0) return -1;
-
-    char command[64];
-    snprintf(command, sizeof(command), "kill -CONT %d 2>/dev/null; echo $?", pid);
-    char output[256];
-
-    int result;
-    if (host->type == CONNECTION_SSH) {
-        result = ssh_execute(host->address, host->port, host->username,
-                           host->password, command, output, sizeof(output));
-    } else {
-        result = telnet_execute(host->address, host->port, host->username,
-                              host->password, command, output, sizeof(output));
-    }
-
-    if (result != 0) return -1;
-
-    int exit_code = atoi(output);
-    return (exit_code == 0) ? 0 : -1;
+    return remote_process_action(host, pid, PROCESS_ACTION_RESUME);
 }
 
 /**
@@ -455,32 +878,135 @@ int remote_resume_process(const host_config_t *host, int pid) {
  * @return 0 en cas de succès, -1 en cas d'erreur
  */
 int remote_restart_process(const host_config_t *host, int pid) {
-    if (host->is_local) {
-        extern int restart_process(int pid);
-        return restart_process(pid);
+    return remote_process_action(host, pid, PROCESS_ACTION_RESTART);
+}
+
+/**
+ * @brief Ouvre la session SSH persistante d'un hôte
+ *
+ * Session du pool libssh, ou à défaut connexion maître OpenSSH.
+ */
+static int ssh_transport_connect(const host_config_t *host) {
+    if (ssh_pool_available()) {
+        return ssh_pool_connect(host->address, host->port, host->username, host->password);
     }
 
-    if (pid <= 0) return -1;
+    char output[64];
+    return (ssh_execute(host->address, host->port, host->username, host->password,
+                        "true", output, sizeof(output)) == 0) ? 0 : -1;
+}
 
-    char command[128];
-    snprintf(command, sizeof(command),
-             "kill -TERM %d 2>/dev/null; sleep 0.5; kill -CONT %d 2>/dev/null; echo $?",
-             pid, pid);
-    char output[256];
+/**
+ * @brief Ferme le flux de l'agent et la session SSH persistante d'un hôte
+ */
+static void ssh_transport_disconnect(const host_config_t *host) {
+    agent_client_close(host);
 
-    int result;
-    if (host->type == CONNECTION_SSH) {
-        result = ssh_execute(host->address, host->port, host->username,
-                           host->password, command, output, sizeof(output));
-    } else {
-        result = telnet_execute(host->address, host->port, host->username,
-                              host->password, command, output, sizeof(output));
+    if (ssh_pool_available()) {
+        ssh_pool_disconnect(host->address, host->port, host->username);
+        return;
     }
 
-    if (result != 0) return -1;
+    // Arrêter la connexion maître OpenSSH (aucune si aucune commande ssh n'a été lancée)
+    if (!ssh_control_dir[0]) return;
+    char cmd[512];
+    char output[64];
+    snprintf(cmd, sizeof(cmd),
+             "ssh -o ControlPath=%s/%%C -O exit -p %d %s@%s 2>/dev/null",
+             ssh_control_dir, host->port, host->username, host->address);
+    run_command(cmd, output, sizeof(output));
+}
+
+static int ssh_transport_execute(const host_config_t *host, const char *command,
+                                 output_sink_t sink, void *context) {
+    return ssh_execute_stream(host->address, host->port, host->username,
+                              host->password, command, sink, context);
+}
+
+static int telnet_transport_connect(const host_config_t *host) {
+    return telnet_pool_connect(host->address, host->port, host->username, host->password);
+}
 
-    int exit_code = atoi(output);
-    return (exit_code == 0) ? 0 : -1;
+static void telnet_transport_disconnect(const host_config_t *host) {
+    telnet_pool_disconnect(host->address, host->port, host->username);
+}
+
+static int telnet_transport_execute(const host_config_t *host, const char *command,
+                                    output_sink_t sink, void *context) {
+    return telnet_execute_stream(host->address, host->port, host->username,
+                                 host->password, command, sink, context);
+}
+
+static const transport_ops_t ssh_transport = {
+    "ssh", CONNECTION_SSH, ssh_transport_connect, ssh_transport_disconnect, ssh_transport_execute
+};
+
+static const transport_ops_t telnet_transport = {
+    "telnet", CONNECTION_TELNET, telnet_transport_connect, telnet_transport_disconnect, telnet_transport_execute
+};
+
+static const transport_ops_t *const transports[] = { &ssh_transport, &telnet_transport, &mock_transport };
+#define TRANSPORT_COUNT ((int)(sizeof(transports) / sizeof(transports[0])))
+
+/**
+ * @brief Recherche un transport par son nom dans le fichier de configuration
+ *
+ * @param name Type de connexion ("ssh", "telnet", "mock")
+ * @return Le transport, ou NULL si le type est inconnu
+ */
+const transport_ops_t *transport_find(const char *name) {
+    for (int i = 0; i < TRANSPORT_COUNT; i++) {
+        if (strcmp(transports[i]->name, name) == 0) return transports[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Retourne le transport d'un hôte
+ *
+ * @param host Configuration de l'hôte
+ * @return Le transport, ou NULL pour localhost ou un type inconnu
+ */
+const transport_ops_t *transport_for(const host_config_t *host) {
+    if (!host || host->is_local) return NULL;
+    for (int i = 0; i < TRANSPORT_COUNT; i++) {
+        if (transports[i]->type == host->type) return transports[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Établit (ou réutilise) la connexion persistante vers un hôte
+ *
+ * Délègue au transport de l'hôte (session libssh ou maître OpenSSH pour
+ * SSH, session telnet authentifiée, rien pour un hôte simulé).
+ *
+ * @param host Configuration de l'hôte distant
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int connect_to_host(const host_config_t *host) {
+    if (!host) return -1;
+    if (host->is_local) return 0;
+
+    const transport_ops_t *transport = transport_for(host);
+    return transport ? transport->connect(host) : -1;
+}
+
+/**
+ * @brief Ferme la connexion persistante vers un hôte
+ *
+ * @param host Configuration de l'hôte distant
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int disconnect_from_host(const host_config_t *host) {
+    if (!host) return -1;
+    if (host->is_local) return 0;
+
+    remote_proc_forget(host);
+
+    const transport_ops_t *transport = transport_for(host);
+    if (transport) transport->disconnect(host);
+    return 0;
 }
 
 /**
@@ -498,15 +1024,11 @@ int network_init(network_manager_t *manager, const char *config_file) {
 
     memset(manager, 0, sizeof(network_manager_t));
 
-    manager->hosts = malloc(sizeof(host_config_t) * MAX_HOSTS);
-    if (!manager->hosts) return -1;
+    // Une écriture vers un flux fermé (agent, client ssh) doit échouer sans tuer l'interface
+    signal(SIGPIPE, SIG_IGN);
 
-    int count = parse_config_file(config_file, manager->hosts, MAX_HOSTS);
-    if (count <= 0) {
-        free(manager->hosts);
-        manager->hosts = NULL;
-        return -1;
-    }
+    int count = parse_config_file(config_file, &manager->hosts);
+    if (count <= 0) return -1;
 
     manager->count = count;
     manager->current_host = 0;
@@ -516,12 +1038,16 @@ int network_init(network_manager_t *manager, const char *config_file) {
 /**
  * @brief Nettoie les ressources du gestionnaire réseau
  *
- * Libère la mémoire allouée pour les configurations d'hôtes.
+ * Ferme les sessions persistantes et libère la mémoire allouée pour
+ * les configurations d'hôtes.
  *
  * @param manager Pointeur vers la structure network_manager_t à nettoyer
  */
 void network_cleanup(network_manager_t *manager) {
     if (manager && manager->hosts) {
+        for (int i = 0; i < manager->count; i++) {
+            disconnect_from_host(&manager->hosts[i]);
+        }
         free(manager->hosts);
         manager->hosts = NULL;
     }
@@ -529,4 +1055,10 @@ void network_cleanup(network_manager_t *manager) {
         manager->count = 0;
         manager->current_host = 0;
     }
+    agent_client_cleanup();
+    remote_proc_cleanup();
+    ssh_pool_cleanup();
+    telnet_pool_cleanup();
+    // Vide une fois les connexions maîtres arrêtées (sinon laissé, toujours privé)
+    if (ssh_control_dir[0]) rmdir(ssh_control_dir);
 }
\ No newline at end of file
@@ -0,0 +1,592 @@
+#define _GNU_SOURCE
+#include "poller.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <stdint.h>
+
+static int compare_cpu_desc(const void *a, const void *b, void *context) {
+    const process_info_t *list = context;
+    float cpu_a = list[*(const int *)a].cpu_percent;
+    float cpu_b = list[*(const int *)b].cpu_percent;
+    return (cpu_a < cpu_b) - (cpu_a > cpu_b);
+}
+
+static int compare_mem_desc(const void *a, const void *b, void *context) {
+    const process_info_t *list = context;
+    int mem_a = list[*(const int *)a].memory_kb;
+    int mem_b = list[*(const int *)b].memory_kb;
+    return (mem_a < mem_b) - (mem_a > mem_b);
+}
+
+/**
+ * @brief Trie les index d'un instantané par CPU et par mémoire
+ *
+ * Fait une fois par instantané, dans le thread de collecte, pour que la vue
+ * fusionnée n'ait plus qu'à fusionner des listes déjà triées.
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int poller_sort_snapshot(const process_info_t *list, int count, int **by_cpu, int **by_mem) {
+    *by_cpu = snapshot_alloc(sizeof(int) * (count > 0 ? count : 1));
+    *by_mem = snapshot_alloc(sizeof(int) * (count > 0 ? count : 1));
+    if (!*by_cpu || !*by_mem) {
+        snapshot_free(*by_cpu);
+        snapshot_free(*by_mem);
+        *by_cpu = NULL;
+        *by_mem = NULL;
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        (*by_cpu)[i] = i;
+        (*by_mem)[i] = i;
+    }
+    qsort_r(*by_cpu, count, sizeof(int), compare_cpu_desc, (void *)list);
+    qsort_r(*by_mem, count, sizeof(int), compare_mem_desc, (void *)list);
+    return 0;
+}
+
+/**
+ * @brief Prend un instantané libre pour une collecte (sous poller->lock)
+ *
+ * Réutilise de préférence un instantané recyclé, dont l'arène a déjà la
+ * taille d'une collecte ; la liste précédente sert d'indication de taille.
+ *
+ * @return L'instantané, NULL en cas d'erreur d'allocation
+ */
+static poller_snapshot_t *snapshot_take(poller_slot_t *slot, int host) {
+    poller_snapshot_t *snapshot = slot->spare;
+    if (snapshot) {
+        slot->spare = snapshot->next;
+    } else {
+        snapshot = calloc(1, sizeof(poller_snapshot_t));
+        if (!snapshot) return NULL;
+        arena_init(&snapshot->arena);
+    }
+
+    snapshot->next = NULL;
+    snapshot->host = host;
+    snapshot->arena.count_hint = slot->snapshot ? slot->snapshot->count : 0;
+    return snapshot;
+}
+
+/**
+ * @brief Vide l'arène d'un instantané et le range parmi les libres (sous poller->lock)
+ */
+static void snapshot_recycle(poller_slot_t *slot, poller_snapshot_t *snapshot) {
+    arena_reset(&snapshot->arena);
+    snapshot->list = NULL;
+    snapshot->count = 0;
+    snapshot->by_cpu = NULL;
+    snapshot->by_mem = NULL;
+    snapshot->references = 0;
+    snapshot->next = slot->spare;
+    slot->spare = snapshot;
+}
+
+/**
+ * @brief Rend une référence sur un instantané (sous poller->lock)
+ */
+static void snapshot_unref(poller_slot_t *slot, poller_snapshot_t *snapshot) {
+    if (--snapshot->references == 0) snapshot_recycle(slot, snapshot);
+}
+
+static int heap_before(const poller_t *poller, int a, int b) {
+    return poller->slots[poller->heap[a]].next_due_ms < poller->slots[poller->heap[b]].next_due_ms;
+}
+
+static void heap_swap(poller_t *poller, int a, int b) {
+    int tmp = poller->heap[a];
+    poller->heap[a] = poller->heap[b];
+    poller->heap[b] = tmp;
+    poller->slots[poller->heap[a]].heap_index = a;
+    poller->slots[poller->heap[b]].heap_index = b;
+}
+
+/**
+ * @brief Rétablit l'ordre du tas autour d'une position (montée puis descente)
+ */
+static void heap_fix(poller_t *poller, int position) {
+    while (position > 0 && heap_before(poller, position, (position - 1) / 2)) {
+        heap_swap(poller, position, (position - 1) / 2);
+        position = (position - 1) / 2;
+    }
+    for (;;) {
+        int smallest = position;
+        int left = 2 * position + 1;
+        int right = left + 1;
+        if (left < poller->heap_count && heap_before(poller, left, smallest)) smallest = left;
+        if (right < poller->heap_count && heap_before(poller, right, smallest)) smallest = right;
+        if (smallest == position) break;
+        heap_swap(poller, position, smallest);
+        position = smallest;
+    }
+}
+
+/**
+ * @brief Remet un hôte dans le tas des hôtes en attente (sous poller->lock)
+ */
+static void heap_push(poller_t *poller, int index) {
+    int position = poller->heap_count++;
+    poller->heap[position] = index;
+    poller->slots[index].heap_index = position;
+    heap_fix(poller, position);
+}
+
+/**
+ * @brief Retire un hôte du tas des hôtes en attente (sous poller->lock)
+ */
+static void heap_remove(poller_t *poller, int index) {
+    int position = poller->slots[index].heap_index;
+    if (position < 0) return;
+
+    poller->slots[index].heap_index = -1;
+    int last = --poller->heap_count;
+    if (position != last) {
+        poller->heap[position] = poller->heap[last];
+        poller->slots[poller->heap[position]].heap_index = position;
+        heap_fix(poller, position);
+    }
+}
+
+/**
+ * @brief Choisit le prochain hôte à collecter
+ *
+ * L'hôte affiché passe en premier dès qu'il est dû, sinon l'hôte le plus
+ * en retard (sommet du tas). Doit être appelée sous poller->lock.
+ *
+ * @param poller Le poller
+ * @param now Date courante (network_now_ms())
+ * @param due_ms Pointeur qui recevra l'échéance de l'hôte choisi
+ * @return Index de l'hôte, ou -1 si tous les hôtes sont déjà en cours de collecte
+ */
+static int poller_pick(poller_t *poller, long long now, long long *due_ms) {
+    if (poller->heap_count == 0) return -1;
+
+    int best = poller->heap[0];
+    int focus = poller->focus;
+    if (focus >= 0 && focus < poller->slot_count && poller->slots[focus].heap_index >= 0 &&
+        poller->slots[focus].next_due_ms <= now) {
+        best = focus;
+    }
+    *due_ms = poller->slots[best].next_due_ms;
+    return best;
+}
+
+/**
+ * @brief Attend sur la condition du poller jusqu'à une date donnée
+ *
+ * La condition utilise CLOCK_MONOTONIC, comme network_now_ms().
+ */
+static void poller_wait_until(poller_t *poller, long long until_ms) {
+    struct timespec ts;
+    ts.tv_sec = until_ms / 1000;
+    ts.tv_nsec = (until_ms % 1000) * 1000000;
+    pthread_cond_timedwait(&poller->wake, &poller->lock, &ts);
+}
+
+/**
+ * @brief Attente avant de retenter un hôte en échec
+ *
+ * Intervalle de l'hôte doublé à chaque échec consécutif, plafonné à
+ * POLLER_BACKOFF_MAX_MS, puis tiré entre la moitié et la totalité de
+ * cette valeur : des hôtes tombés ensemble ne sont pas retentés ensemble.
+ */
+static long long backoff_delay(int interval_ms, int failures, unsigned int *seed) {
+    long long delay = interval_ms > 0 ? interval_ms : DEFAULT_POLL_INTERVAL_MS;
+    for (int i = 1; i < failures && delay < POLLER_BACKOFF_MAX_MS; i++) delay *= 2;
+    if (delay > POLLER_BACKOFF_MAX_MS) delay = POLLER_BACKOFF_MAX_MS;
+
+    long long half = delay / 2;
+    return half + (long long)(rand_r(seed) % (half + 1));
+}
+
+/**
+ * @brief Met à jour la santé d'un hôte après une collecte (sous poller->lock)
+ *
+ * @param health Santé de l'hôte
+ * @param host Configuration de l'hôte (échéance)
+ * @param result Résultat de la collecte
+ * @param fetch_ms Durée de la collecte
+ * @param rtt_ms Délai avant le premier octet reçu, -1 si inconnu
+ * @param error Cause de l'échec donnée par la couche réseau (peut être vide)
+ */
+static void health_update(host_health_t *health, const host_config_t *host, int result,
+                          int fetch_ms, int rtt_ms, const char *error) {
+    health->fetch_ms = fetch_ms;
+
+    // Lissage comme le SRTT de TCP : 7/8 de l'ancienne valeur
+    if (rtt_ms >= 0) {
+        health->rtt_ms = (health->rtt_ms < 0) ? rtt_ms : (7 * health->rtt_ms + rtt_ms) / 8;
+    }
+
+    if (result == 0) {
+        int recovered = health->consecutive_failures > 0;
+        health->success_count++;
+        health->consecutive_failures = 0;
+        health->status = (recovered || fetch_ms * 2 > host->deadline_ms) ? HOST_STATUS_DEGRADED : HOST_STATUS_UP;
+        return;
+    }
+
+    health->failure_count++;
+    health->consecutive_failures++;
+    snprintf(health->last_error, sizeof(health->last_error), "%s",
+             (error && error[0]) ? error : "collecte impossible");
+    health->status = (health->success_count == 0 || health->consecutive_failures >= POLLER_DOWN_AFTER)
+                   ? HOST_STATUS_DOWN : HOST_STATUS_DEGRADED;
+}
+
+/**
+ * @brief Boucle d'un thread de collecte
+ *
+ * Prend l'hôte le plus en retard, le collecte hors verrou (collecteur de
+ * l'hôte) avec l'échéance de l'hôte, publie le résultat puis replanifie l'hôte à son intervalle,
+ * ou après une attente exponentielle s'il est en échec.
+ */
+static void *poller_worker(void *arg) {
+    poller_t *poller = arg;
+    unsigned int seed = (unsigned int)network_now_ms() ^ (unsigned int)(uintptr_t)&seed;  // Gigue du backoff
+
+    pthread_mutex_lock(&poller->lock);
+    while (poller->running) {
+        long long due_ms = 0;
+        long long now = network_now_ms();
+        int index = poller_pick(poller, now, &due_ms);
+        if (index == -1) {
+            pthread_cond_wait(&poller->wake, &poller->lock);
+            continue;
+        }
+
+        if (due_ms > now) {
+            poller_wait_until(poller, due_ms);
+            continue;
+        }
+
+        poller_slot_t *slot = &poller->slots[index];
+        const host_config_t *host = &poller->network->hosts[index];
+        heap_remove(poller, index);
+        slot->in_flight = 1;
+        poller_snapshot_t *snapshot = snapshot_take(slot, index);
+        pthread_mutex_unlock(&poller->lock);
+
+        // Liste et index triés sont pris dans l'arène de l'instantané
+        network_set_deadline(now + host->deadline_ms);
+        network_clear_error();
+        int result = -1;
+        if (snapshot) {
+            arena_bind(&snapshot->arena);
+            result = collector_sample(&slot->collector, &snapshot->list, &snapshot->count);
+            if (result == 0 && poller_sort_snapshot(snapshot->list, snapshot->count,
+                                                    &snapshot->by_cpu, &snapshot->by_mem) != 0) {
+                result = -1;
+            }
+            arena_bind(NULL);
+        } else {
+            network_set_error("mémoire insuffisante");
+        }
+        network_set_deadline(0);
+        long long finished = network_now_ms();
+        int rtt_ms = network_last_rtt_ms();
+
+        pthread_mutex_lock(&poller->lock);
+        slot->in_flight = 0;
+        slot->last_result = result;
+        health_update(&slot->health, host, result, (int)(finished - now), rtt_ms, network_get_error());
+        if (result == 0) {
+            poller_snapshot_t *previous = slot->snapshot;
+            snapshot->generation = ++slot->generation;
+            snapshot->references = 1;
+            slot->snapshot = snapshot;
+            if (previous) snapshot_unref(slot, previous);
+            slot->last_success_ms = finished;
+            poller->generation++;
+        } else if (snapshot) {
+            snapshot_recycle(slot, snapshot);
+        }
+
+        if (result == 0) {
+            // Intervalle compté depuis le début de la collecte, sans jamais
+            // enchaîner deux collectes d'un hôte plus lent que son intervalle
+            long long next = now + host->interval_ms;
+            long long min_next = finished + host->interval_ms / 4;
+            slot->next_due_ms = (next > min_next) ? next : min_next;
+            slot->health.retry_ms = 0;
+        } else {
+            slot->next_due_ms = finished + backoff_delay(host->interval_ms, slot->health.consecutive_failures, &seed);
+            slot->health.retry_ms = slot->next_due_ms;
+        }
+        heap_push(poller, index);
+        pthread_cond_broadcast(&poller->wake);
+
+        if (result == 0 && poller->alerts) {
+            // Règles évaluées hors du verrou, sur l'instantané tenu le temps de l'évaluation
+            alert_engine_t *alerts = poller->alerts;
+            snapshot->references++;
+            pthread_mutex_unlock(&poller->lock);
+            alert_evaluate(alerts, index, snapshot->list, snapshot->count, finished);
+            pthread_mutex_lock(&poller->lock);
+            snapshot_unref(slot, snapshot);
+        }
+    }
+    pthread_mutex_unlock(&poller->lock);
+    return NULL;
+}
+
+/**
+ * @brief Démarre la collecte concurrente de tous les hôtes
+ *
+ * Lance min(nombre d'hôtes, POLLER_MAX_WORKERS) threads de collecte.
+ * L'hôte affiché est dû immédiatement ; les premières collectes des autres
+ * sont étalées sur leur intervalle pour ne pas ouvrir toutes les
+ * connexions au même instant.
+ *
+ * @param poller Structure à initialiser
+ * @param network Gestionnaire réseau (doit rester valide jusqu'à poller_stop())
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int poller_start(poller_t *poller, network_manager_t *network) {
+    if (!poller || !network || network->count <= 0) return -1;
+
+    memset(poller, 0, sizeof(poller_t));
+    poller->network = network;
+    poller->slot_count = network->count;
+    poller->slots = calloc(network->count, sizeof(poller_slot_t));
+    poller->heap = malloc(sizeof(int) * network->count);
+    if (!poller->slots || !poller->heap) {
+        free(poller->slots);
+        free(poller->heap);
+        poller->slots = NULL;
+        poller->heap = NULL;
+        return -1;
+    }
+    poller->focus = network->current_host;
+
+    long long now = network_now_ms();
+    for (int i = 0; i < poller->slot_count; i++) {
+        long long offset = (long long)network->hosts[i].interval_ms * i / poller->slot_count;
+        poller->slots[i].next_due_ms = now + ((i == network->current_host) ? 0 : 1 + offset);
+        poller->slots[i].last_result = -1;
+        poller->slots[i].health.rtt_ms = -1;
+        // Un hôte sans source reste planifié : ses échecs apparaissent dans sa santé
+        collector_open(&poller->slots[i].collector, &network->hosts[i]);
+        heap_push(poller, i);
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&poller->wake, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&poller->lock, NULL);
+    poller->running = 1;
+
+    int workers = network->count < POLLER_MAX_WORKERS ? network->count : POLLER_MAX_WORKERS;
+    for (int i = 0; i < workers; i++) {
+        if (pthread_create(&poller->workers[i], NULL, poller_worker, poller) != 0) break;
+        poller->worker_count++;
+    }
+
+    if (poller->worker_count == 0) {
+        poller_stop(poller);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Arrête les threads de collecte et libère les instantanés
+ *
+ * Attend la fin des collectes en cours (bornées par l'échéance de chaque hôte),
+ * puis ferme le collecteur de chaque hôte. Les instantanés obtenus par
+ * poller_acquire_snapshot() doivent avoir été rendus.
+ */
+void poller_stop(poller_t *poller) {
+    if (!poller || !poller->slots) return;
+
+    pthread_mutex_lock(&poller->lock);
+    poller->running = 0;
+    pthread_cond_broadcast(&poller->wake);
+    pthread_mutex_unlock(&poller->lock);
+
+    for (int i = 0; i < poller->worker_count; i++) {
+        pthread_join(poller->workers[i], NULL);
+    }
+
+    for (int i = 0; i < poller->slot_count; i++) {
+        poller_slot_t *slot = &poller->slots[i];
+        if (slot->snapshot) snapshot_unref(slot, slot->snapshot);
+        while (slot->spare) {
+            poller_snapshot_t *next = slot->spare->next;
+            arena_destroy(&slot->spare->arena);
+            free(slot->spare);
+            slot->spare = next;
+        }
+        collector_close(&slot->collector);
+    }
+    free(poller->slots);
+    free(poller->heap);
+    poller->slots = NULL;
+    poller->heap = NULL;
+    poller->heap_count = 0;
+    poller->slot_count = 0;
+    poller->worker_count = 0;
+
+    pthread_cond_destroy(&poller->wake);
+    pthread_mutex_destroy(&poller->lock);
+}
+
+/**
+ * @brief Copie le dernier instantané d'un hôte s'il a changé
+ *
+ * Ne bloque jamais sur une collecte : seule la copie de la liste se fait
+ * sous le verrou.
+ *
+ * @param poller Le poller
+ * @param host Index de l'hôte
+ * @param generation Dernière génération connue de l'appelant (mise à jour)
+ * @param list Pointeur qui recevra la copie (à libérer par l'appelant)
+ * @param count Pointeur qui recevra le nombre de processus
+ * @return 1 si une nouvelle liste a été copiée, 0 si rien de nouveau, -1 en cas d'erreur
+ */
+int poller_get_snapshot(poller_t *poller, int host, unsigned long *generation,
+                        process_info_t **list, int *count) {
+    if (!poller || host < 0 || host >= poller->slot_count) return -1;
+
+    pthread_mutex_lock(&poller->lock);
+    const poller_snapshot_t *snapshot = poller->slots[host].snapshot;
+    if (!snapshot || snapshot->generation == *generation) {
+        pthread_mutex_unlock(&poller->lock);
+        return 0;
+    }
+
+    process_info_t *copy = malloc(sizeof(process_info_t) * (snapshot->count > 0 ? snapshot->count : 1));
+    if (!copy) {
+        pthread_mutex_unlock(&poller->lock);
+        return -1;
+    }
+    memcpy(copy, snapshot->list, sizeof(process_info_t) * snapshot->count);
+    *list = copy;
+    *count = snapshot->count;
+    *generation = snapshot->generation;
+    pthread_mutex_unlock(&poller->lock);
+    return 1;
+}
+
+/**
+ * @brief Prend le dernier instantané d'un hôte s'il a changé, sans le copier
+ *
+ * L'instantané reste valide (et son arène n'est pas recyclée) jusqu'à
+ * poller_release_snapshot(), même si un instantané plus récent est publié
+ * entre-temps.
+ *
+ * @param poller Le poller
+ * @param host Index de l'hôte
+ * @param generation Dernière génération connue de l'appelant (mise à jour)
+ * @return L'instantané, NULL si rien de nouveau ou si l'index est invalide
+ */
+poller_snapshot_t *poller_acquire_snapshot(poller_t *poller, int host, unsigned long *generation) {
+    if (!poller || host < 0 || host >= poller->slot_count) return NULL;
+
+    pthread_mutex_lock(&poller->lock);
+    poller_snapshot_t *snapshot = poller->slots[host].snapshot;
+    if (!snapshot || snapshot->generation == *generation) {
+        pthread_mutex_unlock(&poller->lock);
+        return NULL;
+    }
+    snapshot->references++;
+    *generation = snapshot->generation;
+    pthread_mutex_unlock(&poller->lock);
+    return snapshot;
+}
+
+/**
+ * @brief Rend un instantané obtenu par poller_acquire_snapshot()
+ */
+void poller_release_snapshot(poller_t *poller, poller_snapshot_t *snapshot) {
+    if (!poller || !snapshot) return;
+
+    pthread_mutex_lock(&poller->lock);
+    snapshot_unref(&poller->slots[snapshot->host], snapshot);
+    pthread_mutex_unlock(&poller->lock);
+}
+
+/**
+ * @brief Rend un hôte dû immédiatement (ex. après changement d'hôte affiché)
+ */
+void poller_refresh_now(poller_t *poller, int host) {
+    if (!poller || host < 0 || host >= poller->slot_count) return;
+
+    pthread_mutex_lock(&poller->lock);
+    poller->slots[host].next_due_ms = 0;
+    if (poller->slots[host].heap_index >= 0) heap_fix(poller, poller->slots[host].heap_index);
+    pthread_cond_broadcast(&poller->wake);
+    pthread_mutex_unlock(&poller->lock);
+}
+
+/**
+ * @brief Change l'hôte affiché
+ *
+ * L'hôte affiché est collecté avant les autres hôtes dus : avec des
+ * centaines d'hôtes, l'écran courant ne dépend pas de la longueur de la file.
+ */
+void poller_set_focus(poller_t *poller, int host) {
+    if (!poller || host < 0 || host >= poller->slot_count) return;
+
+    pthread_mutex_lock(&poller->lock);
+    poller->focus = host;
+    pthread_mutex_unlock(&poller->lock);
+    poller_refresh_now(poller, host);
+}
+
+/**
+ * @brief Branche un moteur d'alertes sur les collectes
+ *
+ * Chaque nouvel instantané est évalué par le thread qui l'a collecté, sans
+ * attendre que l'interface le lise.
+ */
+void poller_set_alerts(poller_t *poller, alert_engine_t *alerts) {
+    if (!poller) return;
+
+    pthread_mutex_lock(&poller->lock);
+    poller->alerts = alerts;
+    pthread_mutex_unlock(&poller->lock);
+}
+
+/**
+ * @brief Génération globale des instantanés (tous hôtes confondus)
+ *
+ * Permet de savoir si au moins un hôte a reçu un nouvel instantané.
+ */
+unsigned long poller_generation(poller_t *poller) {
+    pthread_mutex_lock(&poller->lock);
+    unsigned long generation = poller->generation;
+    pthread_mutex_unlock(&poller->lock);
+    return generation;
+}
+
+/**
+ * @brief Copie la santé d'un hôte (état, RTT, compteurs, dernière erreur)
+ *
+ * @return 0 en cas de succès, -1 si l'index est invalide
+ */
+int poller_get_health(poller_t *poller, int host, host_health_t *health) {
+    if (!poller || host < 0 || host >= poller->slot_count) return -1;
+
+    pthread_mutex_lock(&poller->lock);
+    *health = poller->slots[host].health;
+    pthread_mutex_unlock(&poller->lock);
+    return 0;
+}
+
+const char *host_status_name(host_status_t status) {
+    switch (status) {
+        case HOST_STATUS_UP:       return "up";
+        case HOST_STATUS_DEGRADED: return "degraded";
+        case HOST_STATUS_DOWN:     return "down";
+        case HOST_STATUS_UNKNOWN:  break;
+    }
+    return "...";
+}
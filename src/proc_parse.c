@@ -0,0 +1,445 @@
+#include "proc_parse.h"
+#include <string.h>
+#include <float.h>
+
+static int is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static void skip_blanks(const char **cursor, const char *end) {
+    while (*cursor < end && is_blank(**cursor)) (*cursor)++;
+}
+
+/**
+ * @brief Vérifie qu'un champ se termine bien ici (blanc, fin de ligne ou fin du tampon)
+ */
+static int at_separator(const char *cursor, const char *end) {
+    return cursor >= end || is_blank(*cursor) || *cursor == '\n';
+}
+
+/**
+ * @brief Lit un entier décimal précédé de blancs et avance le curseur
+ *
+ * Un signe '-' est accepté (champs signés comme nice) : la valeur est alors
+ * ramenée modulo 2^64. Les chiffres en excès bouclent sans comportement
+ * indéfini.
+ *
+ * @return 0 en cas de succès, -1 s'il n'y a pas de nombre complet
+ */
+static int parse_number(const char **cursor, const char *end, unsigned long long *value) {
+    skip_blanks(cursor, end);
+    const char *p = *cursor;
+    int negative = 0;
+    if (p < end && *p == '-') {
+        negative = 1;
+        p++;
+    }
+    if (p >= end || *p < '0' || *p > '9') return -1;
+
+    unsigned long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (unsigned long long)(*p++ - '0');
+    if (!at_separator(p, end)) return -1;
+
+    *value = negative ? 0 - v : v;
+    *cursor = p;
+    return 0;
+}
+
+static int parse_int(const char **cursor, const char *end, int *value) {
+    unsigned long long v;
+    if (parse_number(cursor, end, &v) != 0) return -1;
+    *value = (int)(long long)v;
+    return 0;
+}
+
+/**
+ * @brief Lit un nombre décimal à virgule ("12.5", "-0.1") précédé de blancs
+ *
+ * @return 0 en cas de succès, -1 s'il n'y a pas de nombre complet
+ */
+static int parse_decimal(const char **cursor, const char *end, float *value) {
+    skip_blanks(cursor, end);
+    const char *p = *cursor;
+    int negative = 0;
+    if (p < end && *p == '-') {
+        negative = 1;
+        p++;
+    }
+
+    double v = 0.0;
+    int digits = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10.0 + (*p++ - '0');
+        digits++;
+    }
+    if (p < end && *p == '.') {
+        double scale = 0.1;
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, scale /= 10.0) {
+            v += (*p - '0') * scale;
+            digits++;
+        }
+    }
+    if (digits == 0 || !at_separator(p, end)) return -1;
+    if (v > FLT_MAX) v = FLT_MAX;
+
+    *value = (float)(negative ? -v : v);
+    *cursor = p;
+    return 0;
+}
+
+/**
+ * @brief Saute un champ quelconque (suite de caractères non blancs)
+ *
+ * @return Début du champ, NULL s'il n'y en a plus
+ */
+static const char *skip_token(const char **cursor, const char *end) {
+    skip_blanks(cursor, end);
+    const char *token = *cursor;
+    while (*cursor < end && !is_blank(**cursor) && **cursor != '\n') (*cursor)++;
+    return *cursor > token ? token : NULL;
+}
+
+/**
+ * @brief Copie au plus size - 1 caractères (arrêt sur un '\0') et termine par '\0'
+ */
+static void copy_name(char *name, size_t size, const char *start, const char *end) {
+    const char *nul = memchr(start, '\0', (size_t)(end - start));
+    size_t len = (size_t)((nul ? nul : end) - start);
+    if (len > size - 1) len = size - 1;
+    memcpy(name, start, len);
+    name[len] = '\0';
+}
+
+/**
+ * @brief Analyse /proc/[pid]/stat
+ *
+ * Le nom (comm) peut contenir des espaces, des parenthèses et des chiffres :
+ * il s'étend jusqu'à la dernière ')' du tampon, les champs numériques ne
+ * pouvant pas en contenir. Les champs suivants sont comptés à partir de là.
+ *
+ * @param buffer Contenu du fichier
+ * @param len Longueur du contenu
+ * @param stat Champs lus
+ * @return 0 en cas de succès, -1 si le contenu est incomplet ou mal formé
+ */
+int proc_parse_stat(const char *buffer, size_t len, proc_stat_t *stat) {
+    const char *end = buffer + len;
+    const char *cursor = buffer;
+    memset(stat, 0, sizeof(proc_stat_t));
+
+    if (parse_int(&cursor, end, &stat->pid) != 0) return -1;
+    skip_blanks(&cursor, end);
+    if (cursor >= end || *cursor != '(') return -1;
+
+    const char *open = cursor + 1;
+    const char *close = end;
+    while (close > open && close[-1] != ')') close--;
+    if (close == open) return -1;
+    close--;
+    copy_name(stat->name, sizeof(stat->name), open, close);
+
+    cursor = close + 1;
+    skip_blanks(&cursor, end);
+    if (cursor >= end) return -1;
+    stat->state = *cursor++;
+    if (!at_separator(cursor, end)) return -1;
+
+    // Champs 4 (PPid) à 24 (RSS)
+    for (int field = 4; field <= 24; field++) {
+        unsigned long long value;
+        if (parse_number(&cursor, end, &value) != 0) return -1;
+        switch (field) {
+            case 4: stat->ppid = (int)(long long)value; break;
+            case 10: stat->minflt = value; break;
+            case 12: stat->majflt = value; break;
+            case 14: stat->utime = value; break;
+            case 15: stat->stime = value; break;
+            case 20: stat->num_threads = (int)(long long)value; break;
+            case 22: stat->starttime = value; break;
+            case 24: stat->rss_pages = value; break;
+            default: break;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Vérifie la clé d'une ligne "Clé:\tvaleur"
+ */
+static int key_is(const char *line, size_t key_len, const char *key) {
+    return strlen(key) == key_len && memcmp(line, key, key_len) == 0;
+}
+
+/**
+ * @brief Analyse /proc/[pid]/status
+ *
+ * Seules les lignes Name, State, Pid, PPid, VmRSS, Kthread et les deux
+ * compteurs de changements de contexte sont lues ; un champ absent vaut -1
+ * (ou '?' pour l'état).
+ *
+ * @param buffer Contenu du fichier
+ * @param len Longueur du contenu
+ * @param status Champs lus
+ * @return 0 en cas de succès, -1 sans ligne Pid valide
+ */
+int proc_parse_status(const char *buffer, size_t len, proc_status_t *status) {
+    const char *end = buffer + len;
+    status->name[0] = '\0';
+    status->state = '?';
+    status->pid = -1;
+    status->ppid = -1;
+    status->vmrss_kb = -1;
+    status->kthread = -1;
+    status->voluntary_switches = -1;
+    status->nonvoluntary_switches = -1;
+
+    const char *line = buffer;
+    while (line < end) {
+        const char *eol = memchr(line, '\n', (size_t)(end - line));
+        if (!eol) eol = end;
+
+        const char *colon = memchr(line, ':', (size_t)(eol - line));
+        if (colon) {
+            size_t key_len = (size_t)(colon - line);
+            const char *value = colon + 1;
+            skip_blanks(&value, eol);
+
+            if (key_is(line, key_len, "Name")) {
+                copy_name(status->name, sizeof(status->name), value, eol);
+            } else if (key_is(line, key_len, "State")) {
+                if (value < eol) status->state = *value;
+            } else if (key_is(line, key_len, "Pid")) {
+                if (parse_int(&value, eol, &status->pid) != 0) status->pid = -1;
+            } else if (key_is(line, key_len, "PPid")) {
+                if (parse_int(&value, eol, &status->ppid) != 0) status->ppid = -1;
+            } else if (key_is(line, key_len, "VmRSS")) {
+                if (parse_int(&value, eol, &status->vmrss_kb) != 0) status->vmrss_kb = -1;
+            } else if (key_is(line, key_len, "Kthread")) {
+                if (parse_int(&value, eol, &status->kthread) != 0) status->kthread = -1;
+            } else if (key_is(line, key_len, "voluntary_ctxt_switches")) {
+                unsigned long long switches;
+                if (parse_number(&value, eol, &switches) == 0) status->voluntary_switches = (long long)switches;
+            } else if (key_is(line, key_len, "nonvoluntary_ctxt_switches")) {
+                unsigned long long switches;
+                if (parse_number(&value, eol, &switches) == 0) status->nonvoluntary_switches = (long long)switches;
+            }
+        }
+        line = eol + 1;
+    }
+
+    return status->pid > 0 ? 0 : -1;
+}
+
+/**
+ * @brief Analyse /proc/[pid]/statm (taille et pages résidentes)
+ *
+ * @return 0 en cas de succès, -1 si les deux premiers champs manquent
+ */
+int proc_parse_statm(const char *buffer, size_t len, unsigned long long *size_pages,
+                     unsigned long long *resident_pages) {
+    const char *end = buffer + len;
+    const char *cursor = buffer;
+    if (parse_number(&cursor, end, size_pages) != 0) return -1;
+    if (parse_number(&cursor, end, resident_pages) != 0) return -1;
+    return 0;
+}
+
+/**
+ * @brief Analyse /proc/[pid]/schedstat ("run_ns wait_ns slices")
+ *
+ * @return 0 en cas de succès, -1 si un des trois champs manque
+ */
+int proc_parse_schedstat(const char *buffer, size_t len, proc_schedstat_t *schedstat) {
+    const char *end = buffer + len;
+    const char *cursor = buffer;
+    if (parse_number(&cursor, end, &schedstat->run_ns) != 0 ||
+        parse_number(&cursor, end, &schedstat->wait_ns) != 0 ||
+        parse_number(&cursor, end, &schedstat->slices) != 0) return -1;
+    return 0;
+}
+
+/**
+ * @brief Analyse la ligne "cpu" (première ligne) de /proc/stat
+ *
+ * Même somme que le script distant : user, nice, system, idle, iowait,
+ * irq et softirq.
+ *
+ * @return 0 en cas de succès, -1 si la ligne est absente ou incomplète
+ */
+int proc_parse_cpu_total(const char *buffer, size_t len, unsigned long long *total) {
+    const char *end = buffer + len;
+    const char *cursor = buffer + 3;
+    if (len < 4 || memcmp(buffer, "cpu", 3) != 0 || !is_blank(buffer[3])) return -1;
+
+    unsigned long long sum = 0;
+    for (int field = 0; field < 7; field++) {
+        unsigned long long value;
+        if (parse_number(&cursor, end, &value) != 0) return -1;
+        sum += value;
+    }
+    *total = sum;
+    return 0;
+}
+
+/**
+ * @brief Analyse une ligne de sortie de ps
+ *
+ * L'état, le PPID et la mémoire résidente (kB) sont conservés ; le nom est
+ * le reste de la ligne (il peut contenir des espaces). ps aux ne donne pas
+ * le PPID (0).
+ *
+ * @param line Ligne (sans '\n')
+ * @param len Longueur de la ligne
+ * @param format Colonnes demandées à ps
+ * @param proc Processus rempli (remis à zéro)
+ * @return 0 en cas de succès, -1 pour une ligne à ignorer (en-tête, ligne tronquée)
+ */
+int proc_parse_ps_line(const char *line, size_t len, ps_format_t format, process_info_t *proc) {
+    const char *end = line + len;
+    const char *cursor = line;
+    const char *state = NULL;
+    unsigned long long elapsed = 0;
+    memset(proc, 0, sizeof(process_info_t));
+
+    if (format == PS_FORMAT_COLUMNS) {
+        if (parse_int(&cursor, end, &proc->pid) != 0 ||
+            parse_int(&cursor, end, &proc->ppid) != 0 ||
+            !(state = skip_token(&cursor, end)) ||
+            parse_decimal(&cursor, end, &proc->cpu_percent) != 0 ||
+            parse_int(&cursor, end, &proc->memory_kb) != 0 ||
+            parse_number(&cursor, end, &elapsed) != 0) return -1;
+    } else {
+        // USER PID %CPU %MEM VSZ RSS TTY STAT START TIME COMMAND
+        float mem;
+        if (!skip_token(&cursor, end) ||
+            parse_int(&cursor, end, &proc->pid) != 0 ||
+            parse_decimal(&cursor, end, &proc->cpu_percent) != 0 ||
+            parse_decimal(&cursor, end, &mem) != 0 ||
+            !skip_token(&cursor, end) ||
+            parse_int(&cursor, end, &proc->memory_kb) != 0 ||
+            !skip_token(&cursor, end) ||
+            !(state = skip_token(&cursor, end)) ||
+            !skip_token(&cursor, end) ||
+            !skip_token(&cursor, end)) return -1;
+    }
+
+    skip_blanks(&cursor, end);
+    if (proc->pid <= 0 || cursor >= end) return -1;
+    copy_name(proc->name, sizeof(proc->name), cursor, end);
+    if (!proc->name[0]) return -1;
+
+    proc->time = (float)elapsed;
+    proc->state = *state;
+    // Threads noyau : enfants de kthreadd, affichés entre crochets par ps aux
+    proc->is_kernel = (proc->ppid == 2 || *cursor == '[');
+    return 0;
+}
+
+/**
+ * @brief Analyse une ligne de /proc/net/tcp, tcp6, udp ou udp6
+ *
+ * "sl: adresse_locale adresse_distante st tx:rx tr:when retrnsmt uid
+ * timeout inode ..." : seuls l'état (hexadécimal) et l'inode sont gardés.
+ * La ligne d'en-tête ("sl local_address ...") est refusée.
+ *
+ * @return 0 en cas de succès, -1 si la ligne est incomplète ou mal formée
+ */
+int proc_parse_net_socket(const char *line, size_t len, proc_net_socket_t *entry) {
+    const char *end = line + len;
+    const char *cursor = line;
+
+    skip_blanks(&cursor, end);
+    if (cursor >= end || *cursor < '0' || *cursor > '9') return -1;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9') cursor++;
+    if (cursor >= end || *cursor != ':') return -1;
+    cursor++;
+
+    if (!skip_token(&cursor, end) || !skip_token(&cursor, end)) return -1;
+
+    skip_blanks(&cursor, end);
+    unsigned int state = 0;
+    int digits = 0;
+    for (; cursor < end && digits < 8; cursor++, digits++) {
+        char c = *cursor;
+        if (c >= '0' && c <= '9') state = state * 16 + (unsigned int)(c - '0');
+        else if (c >= 'A' && c <= 'F') state = state * 16 + (unsigned int)(c - 'A' + 10);
+        else if (c >= 'a' && c <= 'f') state = state * 16 + (unsigned int)(c - 'a' + 10);
+        else break;
+    }
+    if (digits == 0 || !at_separator(cursor, end)) return -1;
+
+    // tx_queue:rx_queue, tr:tm->when, retrnsmt, uid, timeout
+    for (int field = 0; field < 5; field++) {
+        if (!skip_token(&cursor, end)) return -1;
+    }
+    if (parse_number(&cursor, end, &entry->inode) != 0) return -1;
+    entry->state = state;
+    return 0;
+}
+
+/**
+ * @brief Vérifie qu'un nom rempli par un analyseur est bien terminé
+ */
+static int name_terminated(const char *name, size_t size, size_t input_len) {
+    const char *nul = memchr(name, '\0', size);
+    return nul && (size_t)(nul - name) <= input_len;
+}
+
+/**
+ * @brief Exécute un analyseur sur une entrée arbitraire et vérifie le résultat
+ *
+ * Le premier octet choisit l'analyseur (stat, status, statm, /proc/stat,
+ * ps en colonnes, ps aux, schedstat, /proc/net), le reste est l'entrée. Partagé par la boucle de
+ * fuzzing de --bench-parsers et par la cible libFuzzer.
+ *
+ * @param data Entrée (premier octet : analyseur)
+ * @param len Longueur de l'entrée
+ * @return 0 si les invariants sont respectés, -1 sinon
+ */
+int proc_parse_fuzz_one(const char *data, size_t len) {
+    if (len == 0) return 0;
+    const char *input = data + 1;
+    size_t input_len = len - 1;
+
+    switch ((unsigned char)data[0] % 8) {
+        case 0: {
+            proc_stat_t stat;
+            if (proc_parse_stat(input, input_len, &stat) != 0) return 0;
+            if (!name_terminated(stat.name, sizeof(stat.name), input_len)) return -1;
+            return is_blank(stat.state) ? -1 : 0;
+        }
+        case 1: {
+            proc_status_t status;
+            int result = proc_parse_status(input, input_len, &status);
+            if (!name_terminated(status.name, sizeof(status.name), input_len)) return -1;
+            return (result == 0 && status.pid <= 0) ? -1 : 0;
+        }
+        case 2: {
+            unsigned long long size_pages, resident_pages;
+            proc_parse_statm(input, input_len, &size_pages, &resident_pages);
+            return 0;
+        }
+        case 3: {
+            unsigned long long total;
+            proc_parse_cpu_total(input, input_len, &total);
+            return 0;
+        }
+        case 6: {
+            proc_schedstat_t schedstat;
+            proc_parse_schedstat(input, input_len, &schedstat);
+            return 0;
+        }
+        case 7: {
+            proc_net_socket_t entry;
+            proc_parse_net_socket(input, input_len, &entry);
+            return 0;
+        }
+        default: {
+            process_info_t proc;
+            ps_format_t format = ((unsigned char)data[0] % 8 == 4) ? PS_FORMAT_COLUMNS : PS_FORMAT_AUX;
+            if (proc_parse_ps_line(input, input_len, format, &proc) != 0) return 0;
+            if (!name_terminated(proc.name, sizeof(proc.name), input_len)) return -1;
+            return (proc.pid <= 0 || proc.name[0] == '\0') ? -1 : 0;
+        }
+    }
+}
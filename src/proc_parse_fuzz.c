@@ -0,0 +1,15 @@
+#ifdef PROJETLP_FUZZ
+#include <stdint.h>
+#include <stdlib.h>
+#include "proc_parse.h"
+
+// Cible libFuzzer des analyseurs de proc_parse.h (make fuzz) :
+//   ./GestionRessources --bench-parsers=corpus   (graines du corpus intégré)
+//   ./GestionRessources-fuzz corpus
+// Le premier octet de chaque entrée choisit l'analyseur.
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (proc_parse_fuzz_one((const char *)data, size) != 0) abort();
+    return 0;
+}
+#endif // PROJETLP_FUZZ
@@ -6,23 +6,79 @@
 #include <signal.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <time.h>
 
 #include "process.h"
+#include "arena.h"
+#include "proc_parse.h"
+#include "filter.h"
+#include "sockets.h"
 
 // Structure pour stocker les échantillons CPU
 typedef struct {
     int pid;
+    unsigned long long starttime;    // Champ 22 de stat : un PID réutilisé repart d'un échantillon vide
     unsigned long long last_cpu_time;
-    struct timespec last_sample_time;
+    int has_cpu;
+    proc_schedstat_t sched;          // Dernière lecture de schedstat (mode schedstat)
+    struct timespec sched_time;
+    int has_sched;
+    unsigned long long minflt;       // Derniers compteurs de défauts de page et de changements de contexte
+    unsigned long long majflt;
+    long long voluntary_switches;
+    long long nonvoluntary_switches;
+    struct timespec counters_time;
+    int has_counters;
 } cpu_sample_t;
 
-cpu_sample_t *cpu_samples = NULL;
-int cpu_sample_count = 0;
+// Échantillons du passage précédent, triés par PID, et ceux du passage en
+// cours, reconstruits à partir des seuls PID vus puis échangés
+static cpu_sample_t *cpu_samples = NULL;
+static int cpu_sample_count = 0;
+static int cpu_sample_capacity = 0;
+static cpu_sample_t *next_samples = NULL;
+static int next_sample_count = 0;
+static int next_sample_capacity = 0;
+static int next_samples_sorted = 1;
 unsigned long long previous_total_cpu = 0;
 struct timespec previous_sample_time;
 long total_system_memory_kb = 0;
 
+// Source du CPU% (process_set_sampling)
+static process_sampling_t sampling = PROCESS_SAMPLING_TICKS;
+
+// Comptage des sockets par processus (process_set_sockets)
+static int socket_counts = 0;
+
+// Filtre de la collecte (process_set_filter), NULL pour tout garder
+static const filter_t *process_filter = NULL;
+
+// Mode top K (process_set_top_k) : 0 pour la liste complète
+static int top_k = 0;
+static process_rank_t top_rank = PROCESS_RANK_CPU;
+
+// Temps CPU de chaque PID au passage précédent du mode top K, triés par PID
+typedef struct {
+    int pid;
+    unsigned long long ticks;
+} hot_sample_t;
+
+static hot_sample_t *hot_previous = NULL;
+static int hot_previous_count = 0;
+static int hot_previous_capacity = 0;
+static hot_sample_t *hot_current = NULL;  // Tampon du passage en cours, échangé avec hot_previous
+static int hot_current_capacity = 0;
+
+// Candidat du tas des K premiers
+typedef struct {
+    int pid;
+    unsigned long long key;    // Ticks sur l'intervalle ou pages résidentes selon le classement
+    unsigned long long delta;  // Ticks sur l'intervalle (0 sans passage précédent)
+    int threads;
+} top_entry_t;
+
 /**
 * @brief Lit et retourne la mémoire totale du système
 *
@@ -51,51 +107,156 @@ long get_total_system_memory(void) {
     return cached_total_memory;
 }
 
+static int compare_cpu_sample_pid(const void *a, const void *b) {
+    int pid_a = ((const cpu_sample_t *)a)->pid;
+    int pid_b = ((const cpu_sample_t *)b)->pid;
+    return (pid_a > pid_b) - (pid_a < pid_b);
+}
+
 /**
-* @brief Recherche un échantillon CPU pour un PID donné
+* @brief Commence la table des échantillons d'un passage
+*/
+static void cpu_samples_begin(void) {
+    next_sample_count = 0;
+    next_samples_sorted = 1;
+}
+
+/**
+* @brief Échantillon d'un PID pour le passage en cours
 *
-* Parcourt le tableau des échantillons CPU pour trouver celui correspondant
-* au PID spécifié.
+* L'échantillon du passage précédent est recopié (recherche dichotomique)
+* s'il décrit le même processus, sinon un échantillon vide est créé. Le
+* pointeur reste valide jusqu'à l'appel suivant.
 *
-* @param pid Le PID du processus à rechercher
-* @return Pointeur vers l'échantillon CPU, ou NULL si non trouvé
+* @param pid Le PID du processus
+* @param starttime Date de démarrage (champ 22 de stat)
+* @return L'échantillon, ou NULL en cas d'erreur d'allocation
 */
-cpu_sample_t* find_cpu_sample(int pid) {
-    for (int i = 0; i < cpu_sample_count; i++) {
-        if (cpu_samples[i].pid == pid) {
-            return &cpu_samples[i];
-        }
+static cpu_sample_t *cpu_sample_take(int pid, unsigned long long starttime) {
+    if (next_sample_count >= next_sample_capacity) {
+        int capacity = next_sample_capacity ? next_sample_capacity * 2 : 512;
+        cpu_sample_t *tmp = realloc(next_samples, sizeof(cpu_sample_t) * capacity);
+        if (!tmp) return NULL;
+        next_samples = tmp;
+        next_sample_capacity = capacity;
     }
-    return NULL;
+
+    cpu_sample_t *sample = &next_samples[next_sample_count];
+    cpu_sample_t key = { .pid = pid };
+    const cpu_sample_t *previous = cpu_sample_count > 0 ?
+        bsearch(&key, cpu_samples, cpu_sample_count, sizeof(cpu_sample_t), compare_cpu_sample_pid) : NULL;
+    if (previous && previous->starttime == starttime) {
+        *sample = *previous;
+    } else {
+        memset(sample, 0, sizeof(cpu_sample_t));
+        sample->pid = pid;
+        sample->starttime = starttime;
+    }
+
+    if (next_sample_count > 0 && next_samples[next_sample_count - 1].pid > pid) next_samples_sorted = 0;
+    next_sample_count++;
+    return sample;
 }
 
 /**
-* @brief Met à jour ou crée un échantillon CPU pour un processus
+* @brief Termine le passage : sa table devient la base du suivant
 *
-* Si un échantillon existe déjà pour le PID, il est mis à jour avec les
-* nouvelles valeurs. Sinon, un nouvel échantillon est créé.
+* Les échantillons des processus disparus sont abandonnés. En mode top K,
+* seuls les K retenus ont été relus : ceux des autres processus encore
+* présents (alive, trié par PID) sont gardés tels quels.
 *
-* @param pid Le PID du processus
-* @param cpu_time Le temps CPU total du processus
-*/
-void update_cpu_sample(int pid, unsigned long long cpu_time) {
-    for (int i = 0; i < cpu_sample_count; i++) {
-        if (cpu_samples[i].pid == pid) {
-            cpu_samples[i].last_cpu_time = cpu_time;
-            clock_gettime(CLOCK_MONOTONIC, &cpu_samples[i].last_sample_time);
-            return;
+* @param alive PID vus pendant le passage, triés (NULL : aucun à garder en plus)
+* @param alive_count Nombre de PID
+*/
+static void cpu_samples_commit(const hot_sample_t *alive, int alive_count) {
+    if (!next_samples_sorted) qsort(next_samples, next_sample_count, sizeof(cpu_sample_t), compare_cpu_sample_pid);
+
+    if (alive) {
+        int taken = next_sample_count;
+        int a = 0;
+        int t = 0;
+        for (int i = 0; i < cpu_sample_count; i++) {
+            int pid = cpu_samples[i].pid;
+            while (t < taken && next_samples[t].pid < pid) t++;
+            if (t < taken && next_samples[t].pid == pid) continue;  // Déjà relu
+            while (a < alive_count && alive[a].pid < pid) a++;
+            if (a >= alive_count || alive[a].pid != pid) continue;  // Disparu
+
+            if (next_sample_count >= next_sample_capacity) {
+                int capacity = next_sample_capacity ? next_sample_capacity * 2 : 512;
+                cpu_sample_t *tmp = realloc(next_samples, sizeof(cpu_sample_t) * capacity);
+                if (!tmp) break;
+                next_samples = tmp;
+                next_sample_capacity = capacity;
+            }
+            next_samples[next_sample_count++] = cpu_samples[i];
+        }
+        if (next_sample_count > taken) {
+            qsort(next_samples, next_sample_count, sizeof(cpu_sample_t), compare_cpu_sample_pid);
         }
     }
 
-    // Nouvel échantillon
-    cpu_sample_t *tmp = realloc(cpu_samples, (cpu_sample_count + 1) * sizeof(cpu_sample_t));
-    if (!tmp) return;
+    cpu_sample_t *swap = cpu_samples;
+    int swap_capacity = cpu_sample_capacity;
+    cpu_samples = next_samples;
+    cpu_sample_count = next_sample_count;
+    cpu_sample_capacity = next_sample_capacity;
+    next_samples = swap;
+    next_sample_capacity = swap_capacity;
+    next_sample_count = 0;
+}
 
-    cpu_samples = tmp;
-    cpu_samples[cpu_sample_count].pid = pid;
-    cpu_samples[cpu_sample_count].last_cpu_time = cpu_time;
-    clock_gettime(CLOCK_MONOTONIC, &cpu_samples[cpu_sample_count].last_sample_time);
-    cpu_sample_count++;
+/**
+* @brief Lit un fichier de /proc en une seule lecture, sans stdio
+*
+* Le contenu est terminé par '\0' et tronqué à size - 1 octets.
+*
+* @param path Chemin du fichier
+* @param buffer Tampon de lecture
+* @param size Taille du tampon
+* @return Nombre d'octets lus, -1 en cas d'erreur
+*/
+static int read_proc_file(const char *path, char *buffer, size_t size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    ssize_t n = read(fd, buffer, size - 1);
+    close(fd);
+    if (n <= 0) return -1;
+    buffer[n] = '\0';
+    return (int)n;
+}
+
+/**
+* @brief Lit et analyse /proc/[pid]/stat
+*
+* @param pid Le PID du processus
+* @param stat Champs lus (voir proc_parse_stat())
+* @return 0 en cas de succès, -1 en cas d'erreur
+*/
+static int read_process_stat(int pid, proc_stat_t *stat) {
+    char path[64];
+    char buffer[1024];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    int len = read_proc_file(path, buffer, sizeof(buffer));
+    if (len < 0) return -1;
+    return proc_parse_stat(buffer, (size_t)len, stat);
+}
+
+/**
+* @brief Lit et analyse /proc/[pid]/status
+*
+* @param pid Le PID du processus
+* @param status Champs lus (voir proc_parse_status())
+* @return 0 en cas de succès, -1 en cas d'erreur
+*/
+static int read_process_status(int pid, proc_status_t *status) {
+    char path[64];
+    char buffer[4096];
+    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    int len = read_proc_file(path, buffer, sizeof(buffer));
+    if (len < 0) return -1;
+    return proc_parse_status(buffer, (size_t)len, status);
 }
 
 /**
@@ -107,15 +268,11 @@ void update_cpu_sample(int pid, unsigned long long cpu_time) {
 * @return Le temps CPU total du système en ticks
 */
 unsigned long long read_total_cpu_time(void) {
-    FILE *f = fopen("/proc/stat", "r");
-    if (!f) return 0;
-
-    unsigned long long user, nice, system, idle, iowait, irq, softirq;
-    fscanf(f, "cpu %llu %llu %llu %llu %llu %llu %llu",
-           &user, &nice, &system, &idle, &iowait, &irq, &softirq);
-    fclose(f);
-
-    return user + nice + system + idle + iowait + irq + softirq;
+    char buffer[1024];  // La ligne "cpu" est la première
+    int len = read_proc_file("/proc/stat", buffer, sizeof(buffer));
+    unsigned long long total;
+    if (len < 0 || proc_parse_cpu_total(buffer, (size_t)len, &total) != 0) return 0;
+    return total;
 }
 
 /**
@@ -130,51 +287,11 @@ unsigned long long read_total_cpu_time(void) {
 * @return 0 en cas de succès, -1 en cas d'erreur
 */
 int read_process_cpu_ticks(int pid, unsigned long *utime, unsigned long *stime) {
-    char path[256];
-    FILE *f;
-
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
-    f = fopen(path, "r");
-    if (!f) return -1;
-
-    char line[1024];
-    if (!fgets(line, sizeof(line), f)) {
-        fclose(f);
-        return -1;
-    }
-    fclose(f);
-
-    // Parse manuel
-    int field = 1;
-    char *ptr = line;
-    char *start = line;
-    *utime = 0;
-    *stime = 0;
-
-    while (*ptr && field <= 15) {
-        if (*ptr == ' ') {
-            if (field == 14) {
-                char buf[32];
-                int len = ptr - start;
-                if (len > 31) len = 31;
-                strncpy(buf, start, len);
-                buf[len] = '\0';
-                *utime = strtoul(buf, NULL, 10);
-            } else if (field == 15) {
-                char buf[32];
-                int len = ptr - start;
-                if (len > 31) len = 31;
-                strncpy(buf, start, len);
-                buf[len] = '\0';
-                *stime = strtoul(buf, NULL, 10);
-                break;
-            }
-            field++;
-            start = ptr + 1;
-        }
-        ptr++;
-    }
+    proc_stat_t stat;
+    if (read_process_stat(pid, &stat) != 0) return -1;
 
+    *utime = stat.utime;
+    *stime = stat.stime;
     return 0;
 }
 
@@ -188,32 +305,9 @@ int read_process_cpu_ticks(int pid, unsigned long *utime, unsigned long *stime)
 * @return La mémoire utilisée en kilo-octets, ou 0 en cas d'erreur
 */
 int read_process_memory_kb(int pid) {
-    char path[256];
-    FILE *f;
-    char line[256];
-    int memory_kb = 0;
-
-    snprintf(path, sizeof(path), "/proc/%d/status", pid);
-    f = fopen(path, "r");
-    if (!f) return 0;
-
-    while (fgets(line, sizeof(line), f)) {
-        if (strstr(line, "VmRSS:")) {
-            // Format: "VmRSS:     kB"
-            char *num_start = strchr(line, ':');
-            if (num_start) {
-                num_start++; // Passer le ':'
-                // Sauter les espaces
-                while (*num_start == ' ' || *num_start == '\t') num_start++;
-                // Lire le nombre
-                sscanf(num_start, "%d", &memory_kb);
-            }
-            break;
-        }
-    }
-
-    fclose(f);
-    return memory_kb;
+    proc_status_t status;
+    if (read_process_status(pid, &status) != 0 || status.vmrss_kb < 0) return 0;
+    return status.vmrss_kb;
 }
 
 /**
@@ -240,16 +334,12 @@ void read_process_name(int pid, char *name) {
         return;
     }
 
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
-    f = fopen(path, "r");
-    if (!f) {
+    proc_stat_t stat;
+    if (read_process_stat(pid, &stat) != 0) {
         strcpy(name, "?");
         return;
     }
-
-    int tmp_pid;
-    fscanf(f, "%d (%255[^)])", &tmp_pid, name);
-    fclose(f);
+    strcpy(name, stat.name);
 }
 
 /**
@@ -262,44 +352,13 @@ void read_process_name(int pid, char *name) {
 * @return Le temps d'exécution en secondes, ou 0.0 en cas d'erreur
 */
 float read_process_uptime(int pid) {
-    char path[256];
     FILE *f;
-    unsigned long starttime = 0;
     double system_uptime;
 
-    // Lire starttime
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
-    f = fopen(path, "r");
-    if (!f) return 0.0f;
-
-    char line[1024];
-    if (!fgets(line, sizeof(line), f)) {
-        fclose(f);
-        return 0.0f;
-    }
-    fclose(f);
-
-    // Parse champ 22
-    int field = 1;
-    char *ptr = line;
-    char *start = line;
-
-    while (*ptr && field <= 22) {
-        if (*ptr == ' ') {
-            if (field == 22) {
-                char buf[32];
-                int len = ptr - start;
-                if (len > 31) len = 31;
-                strncpy(buf, start, len);
-                buf[len] = '\0';
-                starttime = strtoul(buf, NULL, 10);
-                break;
-            }
-            field++;
-            start = ptr + 1;
-        }
-        ptr++;
-    }
+    // Lire starttime (champ 22)
+    proc_stat_t stat;
+    if (read_process_stat(pid, &stat) != 0) return 0.0f;
+    unsigned long long starttime = stat.starttime;
 
     if (starttime == 0) return 0.0f;
 
@@ -327,20 +386,561 @@ float read_process_uptime(int pid) {
 * @return Le caractère représentant l'état du processus, ou '?' en cas d'erreur
 */
 char read_process_state(int pid) {
-    char path[256];
-    FILE *f;
-    char state = '?';
+    proc_stat_t stat;
+    if (read_process_stat(pid, &stat) != 0) return '?';
+    return stat.state;
+}
 
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
-    f = fopen(path, "r");
-    if (!f) return state;
+/**
+* @brief Propriétaire d'un processus (celui de son répertoire dans /proc)
+*
+* @param pid Le PID du processus
+* @return L'uid, ou -1 si le processus a disparu
+*/
+static int read_process_uid(int pid) {
+    char path[32];
+    struct stat info;
+    snprintf(path, sizeof(path), "/proc/%d", pid);
+    return stat(path, &info) == 0 ? (int)info.st_uid : -1;
+}
 
-    int tmp_pid;
-    char name[256];
-    fscanf(f, "%d (%[^)]) %c", &tmp_pid, name, &state);
-    fclose(f);
+/**
+* @brief Thread noyau : pas d'exécutable
+*/
+static int is_kernel_thread(int pid) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/exe", pid);
+    return access(path, F_OK) == -1 ? 1 : 0;
+}
 
-    return state;
+/**
+* @brief Remplit les champs tirés de /proc/[pid]/stat
+*
+* État, nom, PPid, uptime et mémoire résidente (pages de stat, remplacées
+* par VmRSS quand status est lu ensuite).
+*
+* @param proc Processus à remplir
+* @param stat Contenu de /proc/[pid]/stat
+* @param system_uptime Uptime du système en secondes
+*/
+static void apply_stat_fields(process_info_t *proc, const proc_stat_t *stat, double system_uptime) {
+    proc->state = stat->state;
+    strcpy(proc->name, stat->name);
+    proc->ppid = stat->ppid;
+    proc->memory_kb = (int)(stat->rss_pages * (unsigned long long)sysconf(_SC_PAGESIZE) / 1024);
+
+    // Uptime : starttime est en ticks depuis le démarrage
+    if (stat->starttime > 0) {
+        double uptime = system_uptime - stat->starttime / (double)sysconf(_SC_CLK_TCK);
+        proc->time = (uptime > 0) ? uptime : 0.0f;
+    }
+}
+
+/**
+* @brief Lit tout ce que le filtre examine, avec /proc/[pid]/stat pour seul fichier
+*
+* Champs de stat et, seulement si le filtre porte dessus, thread noyau et
+* propriétaire : de quoi écarter un processus avant la lecture de status.
+* Sinon is_kernel est lu après le filtre (read_process_kernel), pour ne
+* pas payer l'accès à /proc/[pid]/exe des processus écartés.
+*
+* @param pid Le PID du processus
+* @param proc Structure à remplir (remise à zéro par l'appelant)
+* @param stat Contenu de /proc/[pid]/stat, réutilisé par l'appelant (ticks, défauts de page)
+* @param system_uptime Uptime du système en secondes (/proc/uptime, lu une fois par passage)
+* @return 0 en cas de succès, -1 si le processus a disparu (état '?')
+*/
+static int read_process_identity(int pid, process_info_t *proc, proc_stat_t *stat, double system_uptime) {
+    proc->pid = pid;
+    if (read_process_stat(pid, stat) != 0) {
+        proc->state = '?';
+        strcpy(proc->name, "?");
+        return -1;
+    }
+    apply_stat_fields(proc, stat, system_uptime);
+    if (process_filter && (process_filter->fields & FILTER_FIELD_KERNEL)) proc->is_kernel = is_kernel_thread(pid);
+    if (process_filter && (process_filter->fields & FILTER_FIELD_UID)) proc->uid = read_process_uid(pid);
+    return 0;
+}
+
+/**
+* @brief Complète is_kernel s'il n'a pas déjà été lu pour le filtre
+*
+* @param pid Le PID du processus
+* @param proc Processus ayant passé read_process_identity()
+*/
+static void read_process_kernel(int pid, process_info_t *proc) {
+    if (!process_filter || !(process_filter->fields & FILTER_FIELD_KERNEL)) proc->is_kernel = is_kernel_thread(pid);
+}
+
+/**
+* @brief Lit /proc/[pid]/status : mémoire résidente exacte et changements de contexte
+*
+* @param pid Le PID du processus
+* @param proc Processus à compléter
+* @param status Contenu de /proc/[pid]/status (champs à -1 s'il est illisible)
+*/
+static void read_process_memory(int pid, process_info_t *proc, proc_status_t *status) {
+    if (read_process_status(pid, status) != 0) {
+        status->voluntary_switches = -1;
+        status->nonvoluntary_switches = -1;
+    } else {
+        if (status->vmrss_kb > 0) proc->memory_kb = status->vmrss_kb;
+        if (status->ppid >= 0) proc->ppid = status->ppid;
+    }
+}
+
+/**
+* @brief Lit les champs d'un processus autres que le CPU
+*
+* État, nom, mémoire, uptime, PPid et thread noyau : tout ce qui ne
+* dépend pas d'un échantillon précédent. stat et status ne sont lus qu'une
+* fois ; l'appelant réutilise leur contenu (ticks, défauts de page,
+* changements de contexte) pour les taux.
+*
+* @param pid Le PID du processus
+* @param proc Structure à remplir (remise à zéro par l'appelant)
+* @param stat Contenu de /proc/[pid]/stat
+* @param status Contenu de /proc/[pid]/status (champs à -1 s'il est illisible)
+* @param system_uptime Uptime du système en secondes (/proc/uptime, lu une fois par passage)
+* @return 0 en cas de succès, -1 si le processus a disparu (état '?')
+*/
+static int read_process_details(int pid, process_info_t *proc, proc_stat_t *stat, proc_status_t *status,
+                                double system_uptime) {
+    if (read_process_identity(pid, proc, stat, system_uptime) != 0) return -1;
+    read_process_kernel(pid, proc);
+    read_process_memory(pid, proc, status);
+    return 0;
+}
+
+/**
+* @brief Lit l'uptime du système en secondes
+*
+* @return L'uptime, ou 0.0 en cas d'erreur
+*/
+static double read_system_uptime(void) {
+    char buffer[128];
+    int len = read_proc_file("/proc/uptime", buffer, sizeof(buffer));
+    return len > 0 ? strtod(buffer, NULL) : 0.0;
+}
+
+/**
+* @brief Remplit les taux de défauts de page et de changements de contexte
+*
+* Différences avec les compteurs de la lecture précédente de ce PID,
+* ramenées à la seconde. Un compteur qui diminue (PID réutilisé) ne donne
+* pas de taux pour ce passage.
+*
+* @param proc Processus à compléter
+* @param stat Contenu de /proc/[pid]/stat (défauts de page)
+* @param status Contenu de /proc/[pid]/status (changements de contexte, -1 si absents)
+* @param sample Échantillon du PID (lecture précédente, mis à jour)
+*/
+static void apply_counter_rates(process_info_t *proc, const proc_stat_t *stat, const proc_status_t *status,
+                                cpu_sample_t *sample) {
+    if (!sample) return;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if (sample->has_counters && stat->minflt >= sample->minflt && stat->majflt >= sample->majflt) {
+        double elapsed = (now.tv_sec - sample->counters_time.tv_sec) +
+                         (now.tv_nsec - sample->counters_time.tv_nsec) / 1e9;
+        if (elapsed > 0.1) {
+            proc->minflt_per_s = (stat->minflt - sample->minflt) / elapsed;
+            proc->majflt_per_s = (stat->majflt - sample->majflt) / elapsed;
+            if (status->voluntary_switches >= sample->voluntary_switches && sample->voluntary_switches >= 0) {
+                proc->voluntary_switches_per_s = (status->voluntary_switches - sample->voluntary_switches) / elapsed;
+            }
+            if (status->nonvoluntary_switches >= sample->nonvoluntary_switches && sample->nonvoluntary_switches >= 0) {
+                proc->nonvoluntary_switches_per_s = (status->nonvoluntary_switches - sample->nonvoluntary_switches) / elapsed;
+            }
+        }
+    }
+
+    sample->minflt = stat->minflt;
+    sample->majflt = stat->majflt;
+    sample->voluntary_switches = status->voluntary_switches;
+    sample->nonvoluntary_switches = status->nonvoluntary_switches;
+    sample->counters_time = now;
+    sample->has_counters = 1;
+}
+
+/**
+* @brief Choisit la source du CPU% local
+*
+* En mode schedstat, le CPU% vient du temps passé sur un CPU en
+* nanosecondes (/proc/[pid]/schedstat) au lieu des ticks, et l'attente en
+* file d'exécution et les passages sur un CPU sont remplis. Un processus
+* sans lecture précédente (ou sans schedstat) garde le CPU% en ticks.
+*
+* @param mode PROCESS_SAMPLING_TICKS ou PROCESS_SAMPLING_SCHEDSTAT
+*/
+void process_set_sampling(process_sampling_t mode) {
+    sampling = mode;
+}
+
+process_sampling_t process_get_sampling(void) {
+    return sampling;
+}
+
+/**
+* @brief Active le comptage des sockets TCP et UDP de chaque processus
+*
+* get_process_list() appelle alors sockets_annotate() sur la liste
+* finale : processus écartés par le filtre ou hors du top K compris, aucun
+* /proc/[pid]/fd n'est lu pour rien.
+*
+* @param enabled 1 pour compter, 0 pour laisser les champs à 0
+*/
+void process_set_sockets(int enabled) {
+    socket_counts = enabled;
+}
+
+int process_get_sockets(void) {
+    return socket_counts;
+}
+
+/**
+* @brief Installe le filtre de la collecte
+*
+* get_process_list() l'évalue dès le PID lu (clauses sur le PID), puis
+* après /proc/[pid]/stat : un processus écarté n'est lu qu'une fois, et
+* status, schedstat et les taux ne sont calculés que pour les processus
+* gardés. Les collecteurs distants l'appliquent aux listes reçues et le
+* transmettent à l'agent.
+*
+* @param filter Filtre compilé (filter_compile()), NULL pour tout garder
+*/
+void process_set_filter(const filter_t *filter) {
+    process_filter = (filter && filter->length > 0) ? filter : NULL;
+}
+
+const filter_t *process_get_filter(void) {
+    return process_filter;
+}
+
+/**
+* @brief Lit /proc/[pid]/schedstat, sommé sur les threads si besoin
+*
+* Le fichier du PID ne décrit que le thread principal : pour un processus
+* à plusieurs threads, les fichiers de /proc/[pid]/task/ sont additionnés.
+*
+* @param pid Le PID du processus
+* @param threads Nombre de threads (champ 20 de stat)
+* @param sched Totaux lus
+* @return 0 en cas de succès, -1 en cas d'erreur
+*/
+static int read_process_schedstat(int pid, int threads, proc_schedstat_t *sched) {
+    char path[96];
+    char buffer[128];
+
+    if (threads <= 1) {
+        snprintf(path, sizeof(path), "/proc/%d/schedstat", pid);
+        int len = read_proc_file(path, buffer, sizeof(buffer));
+        if (len < 0) return -1;
+        return proc_parse_schedstat(buffer, (size_t)len, sched);
+    }
+
+    snprintf(path, sizeof(path), "/proc/%d/task", pid);
+    DIR *task_directory = opendir(path);
+    if (!task_directory) return -1;
+
+    memset(sched, 0, sizeof(proc_schedstat_t));
+    int found = 0;
+    struct dirent *entry;
+    while ((entry = readdir(task_directory)) != NULL) {
+        if (!isdigit(entry->d_name[0])) continue;
+        snprintf(path, sizeof(path), "/proc/%d/task/%.16s/schedstat", pid, entry->d_name);
+        proc_schedstat_t thread;
+        int len = read_proc_file(path, buffer, sizeof(buffer));
+        if (len < 0 || proc_parse_schedstat(buffer, (size_t)len, &thread) != 0) continue;
+        sched->run_ns += thread.run_ns;
+        sched->wait_ns += thread.wait_ns;
+        sched->slices += thread.slices;
+        found++;
+    }
+    closedir(task_directory);
+    return found > 0 ? 0 : -1;
+}
+
+/**
+* @brief Remplit CPU%, attente en file d'exécution et passages par seconde depuis schedstat
+*
+* Les valeurs sont rapportées au temps écoulé depuis la lecture précédente
+* de ce PID. Un total qui diminue (PID réutilisé, thread terminé) ne donne
+* pas de mesure pour ce passage. L'attente peut dépasser 100% quand
+* plusieurs threads attendent en même temps.
+*
+* @param proc Processus (cpu_percent remplacé si une mesure est possible)
+* @param threads Nombre de threads du processus
+* @param sample Échantillon du PID (lecture précédente, mis à jour)
+*/
+static void apply_schedstat(process_info_t *proc, int threads, cpu_sample_t *sample) {
+    proc_schedstat_t sched;
+    if (!sample || read_process_schedstat(proc->pid, threads, &sched) != 0) return;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if (sample->has_sched && sched.run_ns >= sample->sched.run_ns &&
+        sched.wait_ns >= sample->sched.wait_ns && sched.slices >= sample->sched.slices) {
+        double elapsed_ns = (now.tv_sec - sample->sched_time.tv_sec) * 1e9 +
+                            (now.tv_nsec - sample->sched_time.tv_nsec);
+        if (elapsed_ns > 1e8) {
+            proc->cpu_percent = (sched.run_ns - sample->sched.run_ns) / elapsed_ns * 100.0;
+            if (proc->cpu_percent > 100.0) proc->cpu_percent = 100.0;
+            proc->wait_percent = (sched.wait_ns - sample->sched.wait_ns) / elapsed_ns * 100.0;
+            proc->slices_per_s = (sched.slices - sample->sched.slices) / (elapsed_ns / 1e9);
+        }
+    }
+
+    sample->sched = sched;
+    sample->sched_time = now;
+    sample->has_sched = 1;
+}
+
+/**
+* @brief Active le mode top K de get_process_list()
+*
+* Une passe rapide lit seulement /proc/[pid]/stat de chaque processus
+* (temps CPU et pages résidentes) et garde les K premiers dans un tas ;
+* nom, état, PPid, uptime et mémoire ne sont lus que pour ces K.
+*
+* @param k Nombre de processus gardés (0 pour la liste complète)
+* @param rank Classement (CPU sur l'intervalle ou mémoire résidente)
+*/
+void process_set_top_k(int k, process_rank_t rank) {
+    top_k = (k > 0) ? k : 0;
+    top_rank = rank;
+}
+
+int process_get_top_k(void) {
+    return top_k;
+}
+
+/**
+* @brief Évalue le filtre pendant la passe rapide du mode top K
+*
+* Seul /proc/[pid]/stat est lu à ce stade : le CPU n'est pas encore connu,
+* et thread noyau et propriétaire ne sont examinés que si le filtre porte
+* dessus.
+*
+* @param pid Le PID du processus
+* @param stat Contenu de /proc/[pid]/stat
+* @param system_uptime Uptime du système en secondes
+* @return 1 si le processus est écarté, 0 sinon
+*/
+static int hot_filter_rejects(int pid, const proc_stat_t *stat, double system_uptime) {
+    process_info_t probe;
+    memset(&probe, 0, sizeof(probe));
+    probe.pid = pid;
+    apply_stat_fields(&probe, stat, system_uptime);
+    if (process_filter->fields & FILTER_FIELD_KERNEL) probe.is_kernel = is_kernel_thread(pid);
+    if (process_filter->fields & FILTER_FIELD_UID) probe.uid = read_process_uid(pid);
+    return filter_match(process_filter, &probe, FILTER_FIELDS_ALL & ~FILTER_FIELD_CPU) == FILTER_REJECT;
+}
+
+static int compare_hot_pid(const void *a, const void *b) {
+    return ((const hot_sample_t *)a)->pid - ((const hot_sample_t *)b)->pid;
+}
+
+/**
+* @brief Temps CPU d'un PID au passage précédent
+*
+* /proc est lu par PID croissant : un curseur qui avance suffit, avec une
+* recherche dichotomique si l'ordre n'est pas respecté.
+*
+* @return 1 si le PID était présent (ticks renseigné), 0 sinon
+*/
+static int hot_previous_ticks(int pid, int *cursor, unsigned long long *ticks) {
+    if (*cursor > 0 && hot_previous[*cursor - 1].pid >= pid) {
+        hot_sample_t key = { pid, 0 };
+        hot_sample_t *found = bsearch(&key, hot_previous, hot_previous_count, sizeof(hot_sample_t), compare_hot_pid);
+        if (!found) return 0;
+        *ticks = found->ticks;
+        return 1;
+    }
+    while (*cursor < hot_previous_count && hot_previous[*cursor].pid < pid) (*cursor)++;
+    if (*cursor < hot_previous_count && hot_previous[*cursor].pid == pid) {
+        *ticks = hot_previous[(*cursor)++].ticks;
+        return 1;
+    }
+    return 0;
+}
+
+// Tas minimum sur key : la racine est le candidat le plus faible des K gardés
+static void top_heap_sift_down(top_entry_t *heap, int count, int position) {
+    for (;;) {
+        int smallest = position;
+        int left = 2 * position + 1;
+        int right = left + 1;
+        if (left < count && heap[left].key < heap[smallest].key) smallest = left;
+        if (right < count && heap[right].key < heap[smallest].key) smallest = right;
+        if (smallest == position) return;
+        top_entry_t tmp = heap[position];
+        heap[position] = heap[smallest];
+        heap[smallest] = tmp;
+        position = smallest;
+    }
+}
+
+static void top_heap_push(top_entry_t *heap, int *count, int k, top_entry_t entry) {
+    if (*count < k) {
+        int position = (*count)++;
+        heap[position] = entry;
+        while (position > 0 && heap[(position - 1) / 2].key > heap[position].key) {
+            top_entry_t tmp = heap[position];
+            heap[position] = heap[(position - 1) / 2];
+            heap[(position - 1) / 2] = tmp;
+            position = (position - 1) / 2;
+        }
+    } else if (entry.key > heap[0].key) {
+        heap[0] = entry;
+        top_heap_sift_down(heap, *count, 0);
+    }
+}
+
+/**
+* @brief Liste des K processus les plus consommateurs (mode top K)
+*
+* Passe rapide sur tous les PID (une lecture de stat chacun, aucune
+* allocation par processus), tas borné à K, puis lecture complète des K
+* retenus seulement. La liste est triée par classement décroissant.
+*
+* @param list Pointeur qui recevra la liste (arène liée au thread, ou malloc)
+* @param count Pointeur qui recevra le nombre de processus
+* @return 0 en cas de succès, -1 en cas d'erreur
+*/
+static int get_process_list_top_k(process_info_t **list, int *count) {
+    DIR *proc_directory = opendir("/proc");
+    if (!proc_directory) return -1;
+
+    int k = top_k;
+    top_entry_t *heap = malloc(sizeof(top_entry_t) * k);
+    if (!heap) {
+        closedir(proc_directory);
+        return -1;
+    }
+
+    total_system_memory_kb = get_total_system_memory();
+    double system_uptime = read_system_uptime();
+    struct timespec current_time;
+    clock_gettime(CLOCK_MONOTONIC, &current_time);
+    unsigned long long current_total_cpu = read_total_cpu_time();
+    double time_diff = 0.0;
+    if (previous_sample_time.tv_sec > 0) {
+        time_diff = (current_time.tv_sec - previous_sample_time.tv_sec) +
+                   (current_time.tv_nsec - previous_sample_time.tv_nsec) / 1e9;
+    }
+    int has_previous = time_diff > 0.1 && previous_total_cpu > 0;
+
+    int heap_count = 0;
+    int current_count = 0;
+    int cursor = 0;
+    int sorted = 1;
+    struct dirent *sub_directory;
+    while ((sub_directory = readdir(proc_directory)) != NULL) {
+        if (!isdigit(sub_directory->d_name[0])) continue;
+        int pid = atoi(sub_directory->d_name);
+        if (process_filter && filter_match(process_filter, &(process_info_t){ .pid = pid }, FILTER_FIELD_PID) == FILTER_REJECT) {
+            continue;
+        }
+
+        // Une seule lecture par processus : ticks, pages résidentes et threads de stat
+        proc_stat_t stat;
+        if (read_process_stat(pid, &stat) != 0) continue;
+        unsigned long long ticks = stat.utime + stat.stime;
+
+        if (current_count >= hot_current_capacity) {
+            int capacity = hot_current_capacity ? hot_current_capacity * 2 : 1024;
+            hot_sample_t *tmp = realloc(hot_current, sizeof(hot_sample_t) * capacity);
+            if (!tmp) {
+                free(heap);
+                closedir(proc_directory);
+                return -1;
+            }
+            hot_current = tmp;
+            hot_current_capacity = capacity;
+        }
+        if (current_count > 0 && hot_current[current_count - 1].pid > pid) sorted = 0;
+        hot_current[current_count].pid = pid;
+        hot_current[current_count].ticks = ticks;
+        current_count++;
+        if (process_filter && hot_filter_rejects(pid, &stat, system_uptime)) continue;
+
+        unsigned long long previous_ticks;
+        top_entry_t entry = { pid, 0, 0, stat.num_threads };
+        if (has_previous && hot_previous_ticks(pid, &cursor, &previous_ticks) && ticks >= previous_ticks) {
+            entry.delta = ticks - previous_ticks;
+        }
+        entry.key = (top_rank == PROCESS_RANK_MEM) ? stat.rss_pages : entry.delta;
+        top_heap_push(heap, &heap_count, k, entry);
+    }
+    closedir(proc_directory);
+
+    // Échantillons de ce passage : base du suivant
+    if (!sorted) qsort(hot_current, current_count, sizeof(hot_sample_t), compare_hot_pid);
+    hot_sample_t *swap = hot_previous;
+    int swap_capacity = hot_previous_capacity;
+    hot_previous = hot_current;
+    hot_previous_capacity = hot_current_capacity;
+    hot_previous_count = current_count;
+    hot_current = swap;
+    hot_current_capacity = swap_capacity;
+    previous_sample_time = current_time;
+    unsigned long long total_diff = current_total_cpu - previous_total_cpu;
+    previous_total_cpu = current_total_cpu;
+
+    // Enrichissement des K retenus, du plus fort au plus faible
+    *list = snapshot_alloc(sizeof(process_info_t) * (heap_count > 0 ? heap_count : 1));
+    if (!*list) {
+        free(heap);
+        return -1;
+    }
+    long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cores < 1) num_cores = 1;
+
+    int index = 0;
+    cpu_samples_begin();
+    for (int remaining = heap_count; remaining > 0; remaining--) {
+        top_entry_t entry = heap[0];
+        heap[0] = heap[remaining - 1];
+        top_heap_sift_down(heap, remaining - 1, 0);
+
+        process_info_t *proc = &(*list)[remaining - 1];
+        memset(proc, 0, sizeof(process_info_t));
+        proc_stat_t stat;
+        proc_status_t status;
+        if (read_process_details(entry.pid, proc, &stat, &status, system_uptime) == 0) {
+            if (has_previous && total_diff > 0) {
+                proc->cpu_percent = ((double)entry.delta / total_diff) * 100.0 * num_cores;
+                if (proc->cpu_percent > 100.0) proc->cpu_percent = 100.0;
+            }
+            cpu_sample_t *sample = cpu_sample_take(entry.pid, stat.starttime);
+            apply_counter_rates(proc, &stat, &status, sample);
+            if (sampling == PROCESS_SAMPLING_SCHEDSTAT) apply_schedstat(proc, entry.threads, sample);
+            // Clauses sur le CPU, connu seulement maintenant
+            if (filter_match(process_filter, proc, FILTER_FIELDS_ALL) == FILTER_REJECT) proc->state = '?';
+        }
+        index++;
+    }
+    // Compteurs des autres processus encore présents gardés pour leur retour dans le top K
+    cpu_samples_commit(hot_previous, hot_previous_count);
+
+    // Processus disparus entre les deux passes (ou écartés par le filtre) : retirés de la liste
+    int kept = 0;
+    for (int i = 0; i < index; i++) {
+        if ((*list)[i].state == '?') continue;
+        if (kept != i) (*list)[kept] = (*list)[i];
+        kept++;
+    }
+
+    free(heap);
+    *count = kept;
+    // Sockets comptées pour les seuls K retenus
+    if (socket_counts) sockets_annotate(*list, *count);
+    return 0;
 }
 
 /**
@@ -349,22 +949,26 @@ char read_process_state(int pid) {
 * Parcourt le répertoire /proc, lit les informations de chaque processus
 * et calcule les statistiques CPU et mémoire. Les échantillons CPU sont
 * conservés entre les appels pour calculer les pourcentages CPU.
+* La liste est prise dans l'arène liée au thread (voir arena.h), par
+* malloc sinon.
 *
 * @param list Pointeur vers un tableau qui contiendra la liste des processus
 * @param count Pointeur vers un entier qui contiendra le nombre de processus
 * @return 0 en cas de succès, -1 en cas d'erreur
 */
 int get_process_list(process_info_t **list, int *count) {
+    if (top_k > 0) return get_process_list_top_k(list, count);
+
     DIR *proc_directory = opendir("/proc");
     if (!proc_directory) {
         return -1;
     }
 
     struct dirent *sub_directory;
-    int capacity = 256;
+    int capacity = snapshot_capacity_hint(256);
     int index = 0;
 
-    *list = malloc(sizeof(process_info_t) * capacity);
+    *list = snapshot_alloc(sizeof(process_info_t) * capacity);
     if (!*list) {
         closedir(proc_directory);
         return -1;
@@ -372,6 +976,7 @@ int get_process_list(process_info_t **list, int *count) {
 
     // Obtenir mémoire totale système
     total_system_memory_kb = get_total_system_memory();
+    double system_uptime = read_system_uptime();
 
     // Temps actuel pour calcul CPU
     struct timespec current_time;
@@ -385,15 +990,20 @@ int get_process_list(process_info_t **list, int *count) {
     }
 
     // Parcourir /proc
+    cpu_samples_begin();
     while ((sub_directory = readdir(proc_directory)) != NULL) {
         if (isdigit(sub_directory->d_name[0])) {
             int pid = atoi(sub_directory->d_name);
+            if (process_filter && filter_match(process_filter, &(process_info_t){ .pid = pid }, FILTER_FIELD_PID) == FILTER_REJECT) {
+                continue;  // Écarté sans aucune lecture
+            }
 
             if (index >= capacity) {
+                process_info_t *tmp = snapshot_realloc(*list, sizeof(process_info_t) * capacity,
+                                                       sizeof(process_info_t) * capacity * 2);
                 capacity *= 2;
-                process_info_t *tmp = realloc(*list, sizeof(process_info_t) * capacity);
                 if (!tmp) {
-                    free(*list);
+                    snapshot_free(*list);
                     closedir(proc_directory);
                     return -1;
                 }
@@ -403,53 +1013,16 @@ int get_process_list(process_info_t **list, int *count) {
             process_info_t *proc = &(*list)[index];
             memset(proc, 0, sizeof(process_info_t));
 
-            // Données de base (TOUJOURS relues)
-            proc->pid = pid;
-            proc->state = read_process_state(pid);
-            read_process_name(pid, proc->name);
-
-            // Mémoire - TOUJOURS relue pour mise à jour dynamique
-            proc->memory_kb = read_process_memory_kb(pid);
-
-            // Uptime - TOUJOURS relu
-            proc->time = read_process_uptime(pid);
-
-            // PPid
-            char path[256];
-            FILE *f;
-            snprintf(path, sizeof(path), "/proc/%d/status", pid);
-            f = fopen(path, "r");
-            if (f) {
-                char line[256];
-                while (fgets(line, sizeof(line), f)) {
-                    if (strstr(line, "PPid:")) {
-                        sscanf(line, "PPid: %d", &proc->ppid);
-                        break;
-                    }
-                }
-                fclose(f);
-            }
-
-            // Kernel thread (peut être mis en cache)
-            int pid_cache = 0;
-            int is_kernel_cache = 0;
-            if (pid != pid_cache) {
-                snprintf(path, sizeof(path), "/proc/%d/exe", pid);
-                proc->is_kernel = (access(path, F_OK) == -1) ? 1 : 0;
-                pid_cache = pid;
-                is_kernel_cache = proc->is_kernel;
-            } else {
-                proc->is_kernel = is_kernel_cache;
-            }
-
-            // Calcul CPU % (nécessite échantillonnage)
-            unsigned long utime, stime;
-            if (read_process_cpu_ticks(pid, &utime, &stime) == 0) {
-                unsigned long long current_process_cpu = utime + stime;
-                cpu_sample_t *prev = find_cpu_sample(pid);
+            // Calcul CPU % (nécessite échantillonnage) à partir du stat déjà lu
+            proc_stat_t stat;
+            proc_status_t status;
+            if (read_process_identity(pid, proc, &stat, system_uptime) == 0) {
+                unsigned long long current_process_cpu = stat.utime + stat.stime;
+                cpu_sample_t *sample = cpu_sample_take(pid, stat.starttime);
 
-                if (prev && time_diff > 0.1 && previous_total_cpu > 0) {
-                    unsigned long long process_diff = current_process_cpu - prev->last_cpu_time;
+                if (sample && sample->has_cpu && time_diff > 0.1 && previous_total_cpu > 0 &&
+                    current_process_cpu >= sample->last_cpu_time) {
+                    unsigned long long process_diff = current_process_cpu - sample->last_cpu_time;
                     unsigned long long total_diff = current_total_cpu - previous_total_cpu;
 
                     if (total_diff > 0) {
@@ -467,7 +1040,29 @@ int get_process_list(process_info_t **list, int *count) {
                     proc->cpu_percent = 0.0;
                 }
 
-                update_cpu_sample(pid, current_process_cpu);
+                if (sample) {
+                    sample->last_cpu_time = current_process_cpu;
+                    sample->has_cpu = 1;
+                }
+
+                // Tous les champs du filtre sont connus : un processus écarté
+                // n'a coûté que la lecture de stat. En mode schedstat, le CPU%
+                // des ticks n'est qu'une estimation : ses clauses attendent la
+                // mesure en nanosecondes.
+                unsigned int fields = sampling == PROCESS_SAMPLING_SCHEDSTAT ?
+                    FILTER_FIELDS_ALL & ~FILTER_FIELD_CPU : FILTER_FIELDS_ALL;
+                if (filter_match(process_filter, proc, fields) == FILTER_REJECT) continue;
+
+                read_process_kernel(pid, proc);
+                read_process_memory(pid, proc, &status);
+                apply_counter_rates(proc, &stat, &status, sample);
+                if (sampling == PROCESS_SAMPLING_SCHEDSTAT) {
+                    apply_schedstat(proc, stat.num_threads, sample);
+                    // CPU% remplacé par la mesure en nanosecondes
+                    if (filter_match(process_filter, proc, FILTER_FIELDS_ALL) == FILTER_REJECT) continue;
+                }
+            } else if (process_filter) {
+                continue;  // Disparu : plus rien à filtrer
             } else {
                 proc->cpu_percent = 0.0;
             }
@@ -478,11 +1073,13 @@ int get_process_list(process_info_t **list, int *count) {
 
     closedir(proc_directory);
 
-    // Mettre à jour pour prochain appel
+    // Mettre à jour pour prochain appel (échantillons des seuls PID vus)
+    cpu_samples_commit(NULL, 0);
     previous_sample_time = current_time;
     previous_total_cpu = current_total_cpu;
 
     *count = index;
+    if (socket_counts) sockets_annotate(*list, *count);
     return 0;
 }
 
@@ -511,27 +1108,16 @@ int restart_process(int pid) {
 
 /* Récupère UN processus précis */
 int get_process(int pid, process_info_t *proc) {
-	char status_file_loc[512];
-	snprintf(status_file_loc, sizeof(status_file_loc),
-	         "/proc/%d/status", pid);
-
-	FILE *status_file = fopen(status_file_loc, "r");
-	if (!status_file) {
+	proc_status_t status;
+	if (read_process_status(pid, &status) != 0) {
 		return -1;
 	}
 
 	memset(proc, 0, sizeof(process_info_t));
-
-	char line[512];
-
-	while (fgets(line, sizeof(line), status_file) != NULL) {
-		sscanf(line, "State: %c", &proc->state);
-		sscanf(line, "Pid: %d", &proc->pid);
-		sscanf(line, "PPid: %d", &proc->ppid);
-		sscanf(line, "Kthread: %d", &proc->is_kernel);
-		sscanf(line, "VmRSS: %d", &proc->memory_kb);
-	}
-
-	fclose(status_file);
+	proc->pid = status.pid;
+	proc->state = status.state;
+	proc->ppid = status.ppid > 0 ? status.ppid : 0;
+	proc->is_kernel = status.kthread > 0;
+	proc->memory_kb = status.vmrss_kb > 0 ? status.vmrss_kb : 0;
 	return 0;
 }
@@ -0,0 +1,405 @@
+#include "remote_proc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "arena.h"
+
+// Script envoyé à l'hôte distant. Une seule commande, un seul passage :
+//   H|clk_tck|pagesize            (getconf, valeurs par défaut si absent)
+//   U|uptime_s                    (/proc/uptime)
+//   T|ticks_cpu_total             (/proc/stat, mêmes champs que read_total_cpu_time())
+//   P|pid|ppid|état|ticks|starttime|noyau|rss_pages|nom   (/proc/[pid]/stat + statm)
+//   N|nombre_de_cpu               (fin de sortie)
+// Les fichiers sont lus par getline : un processus qui disparaît pendant la
+// lecture est simplement ignoré (mawk abandonne sur un fichier manquant).
+// Le nom est extrait jusqu'à la dernière ')' et placé en fin de ligne pour
+// supporter les espaces, parenthèses et '|'.
+#define REMOTE_PROC_SCRIPT \
+    "cd /proc && printf 'H|%s|%s\\n' \"$(getconf CLK_TCK 2>/dev/null)\" \"$(getconf PAGESIZE 2>/dev/null)\"" \
+    " && awk 'BEGIN {\n" \
+    "  if ((getline line < \"uptime\") > 0) { split(line, f, \" \"); print \"U|\" f[1] }\n" \
+    "  close(\"uptime\");\n" \
+    "  while ((getline line < \"stat\") > 0) {\n" \
+    "    split(line, f, \" \");\n" \
+    "    if (f[1] == \"cpu\") print \"T|\" (f[2] + f[3] + f[4] + f[5] + f[6] + f[7] + f[8]);\n" \
+    "    else if (f[1] ~ /^cpu[0-9]/) ncpu++;\n" \
+    "  }\n" \
+    "  close(\"stat\");\n" \
+    "  for (i = 1; i < ARGC; i++) {\n" \
+    "    file = ARGV[i] \"/stat\";\n" \
+    "    ok = (getline line < file) > 0; close(file);\n" \
+    "    if (!ok) continue;\n" \
+    "    rest = line; sub(/^.*\\) /, \"\", rest);\n" \
+    "    open = index(line, \"(\");\n" \
+    "    name = substr(line, open + 1, length(line) - length(rest) - open - 2);\n" \
+    "    split(rest, f, \" \");\n" \
+    "    file = ARGV[i] \"/statm\";\n" \
+    "    ok = (getline mem < file) > 0; close(file);\n" \
+    "    if (!ok) continue;\n" \
+    "    split(mem, m, \" \");\n" \
+    "    print \"P|\" ARGV[i] \"|\" f[2] \"|\" f[1] \"|\" (f[12] + f[13]) \"|\" f[20] \"|\" (int(f[7] / 2097152) % 2) \"|\" m[2] \"|\" name;\n" \
+    "  }\n" \
+    "  print \"N|\" ncpu;\n" \
+    "}' [0-9]*"
+
+// Échantillon CPU précédent d'un processus distant
+typedef struct {
+    int pid;                       // 0 = case libre
+    unsigned long long starttime;  // Distingue un PID réutilisé
+    unsigned long long ticks;      // utime + stime
+} remote_sample_t;
+
+// État de collecte d'un hôte : table de hachage PID -> échantillon précédent
+typedef struct {
+    char address[128];
+    int port;
+    char username[64];
+    remote_sample_t *samples;
+    int sample_capacity;           // Puissance de 2
+    unsigned long long prev_total;
+    int has_sample;
+    pthread_mutex_t lock;          // Une seule collecte à la fois par hôte
+} remote_proc_state_t;
+
+// Résultat en cours d'analyse
+typedef struct {
+    process_info_t *list;
+    unsigned long long *ticks;     // Tableaux parallèles à list
+    unsigned long long *starttimes;
+    int count;
+    int capacity;
+    long clk_tck;
+    long page_size;
+    double uptime;
+    unsigned long long total;
+    int has_total;
+    int ncpu;
+    int complete;                  // Ligne N| reçue
+} remote_proc_parse_t;
+
+static remote_proc_state_t **states = NULL;
+static int state_count = 0;
+static int state_capacity = 0;
+static pthread_mutex_t states_lock = PTHREAD_MUTEX_INITIALIZER;  // Protège le tableau des états
+
+/**
+ * @brief Recherche l'état de collecte d'un hôte (sous states_lock)
+ */
+static remote_proc_state_t *state_find(const host_config_t *host) {
+    for (int i = 0; i < state_count; i++) {
+        if (states[i]->port == host->port &&
+            strcmp(states[i]->address, host->address) == 0 &&
+            strcmp(states[i]->username, host->username) == 0) {
+            return states[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Recherche ou crée l'état de collecte d'un hôte, puis le verrouille
+ *
+ * @return Pointeur vers l'état verrouillé, ou NULL en cas d'erreur d'allocation
+ */
+static remote_proc_state_t *state_acquire(const host_config_t *host) {
+    pthread_mutex_lock(&states_lock);
+    remote_proc_state_t *state = state_find(host);
+
+    if (!state) {
+        if (state_count >= state_capacity) {
+            int capacity = state_capacity ? state_capacity * 2 : 8;
+            remote_proc_state_t **tmp = realloc(states, sizeof(remote_proc_state_t *) * capacity);
+            if (!tmp) {
+                pthread_mutex_unlock(&states_lock);
+                return NULL;
+            }
+            states = tmp;
+            state_capacity = capacity;
+        }
+
+        state = calloc(1, sizeof(remote_proc_state_t));
+        if (!state) {
+            pthread_mutex_unlock(&states_lock);
+            return NULL;
+        }
+
+        snprintf(state->address, sizeof(state->address), "%s", host->address);
+        snprintf(state->username, sizeof(state->username), "%s", host->username);
+        state->port = host->port;
+        pthread_mutex_init(&state->lock, NULL);
+
+        states[state_count++] = state;
+    }
+    pthread_mutex_unlock(&states_lock);
+
+    pthread_mutex_lock(&state->lock);
+    return state;
+}
+
+static unsigned int pid_hash(int pid) {
+    return (unsigned int)pid * 2654435761u;
+}
+
+/**
+ * @brief Recherche l'échantillon précédent d'un PID
+ *
+ * @return Pointeur vers l'échantillon, ou NULL si le PID est nouveau
+ */
+static const remote_sample_t *sample_lookup(const remote_proc_state_t *state, int pid) {
+    if (!state->samples) return NULL;
+
+    unsigned int mask = (unsigned int)state->sample_capacity - 1;
+    for (unsigned int i = pid_hash(pid) & mask; state->samples[i].pid != 0; i = (i + 1) & mask) {
+        if (state->samples[i].pid == pid) return &state->samples[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Découpe le champ suivant d'une ligne délimitée par '|'
+ *
+ * @param cursor Position courante, avancée après le séparateur
+ * @return Début du champ (terminé par '\0'), ou NULL s'il n'y a plus de champ
+ */
+static char *next_field(char **cursor) {
+    if (!*cursor) return NULL;
+
+    char *field = *cursor;
+    char *sep = strchr(field, '|');
+    if (sep) {
+        *sep = '\0';
+        *cursor = sep + 1;
+    } else {
+        *cursor = NULL;
+    }
+    return field;
+}
+
+/**
+ * @brief Réserve une entrée supplémentaire dans le résultat en cours
+ *
+ * @return Index de l'entrée, -1 en cas d'erreur d'allocation
+ */
+static int parse_push(remote_proc_parse_t *parse) {
+    if (parse->count >= parse->capacity) {
+        int capacity = parse->capacity ? parse->capacity * 2 : snapshot_capacity_hint(256);
+        process_info_t *list = snapshot_realloc(parse->list, sizeof(process_info_t) * parse->capacity,
+                                                sizeof(process_info_t) * capacity);
+        if (!list) return -1;
+        parse->list = list;
+
+        unsigned long long *ticks = realloc(parse->ticks, sizeof(unsigned long long) * capacity);
+        if (!ticks) return -1;
+        parse->ticks = ticks;
+
+        unsigned long long *starttimes = realloc(parse->starttimes, sizeof(unsigned long long) * capacity);
+        if (!starttimes) return -1;
+        parse->starttimes = starttimes;
+
+        parse->capacity = capacity;
+    }
+    return parse->count++;
+}
+
+/**
+ * @brief Analyse une ligne de sortie du script distant
+ *
+ * @param line Ligne reçue (sans '\n')
+ * @param len Longueur de la ligne
+ * @param context Résultat en cours (remote_proc_parse_t)
+ * @return 0 pour continuer, -1 en cas d'erreur d'allocation
+ */
+static int remote_proc_line_handler(char *line, size_t len, void *context) {
+    remote_proc_parse_t *parse = context;
+    if (len < 2 || line[1] != '|') return 0;
+
+    char *cursor = line + 2;
+
+    switch (line[0]) {
+        case 'H': {
+            char *clk = next_field(&cursor);
+            char *page = next_field(&cursor);
+            if (clk && atol(clk) > 0) parse->clk_tck = atol(clk);
+            if (page && atol(page) > 0) parse->page_size = atol(page);
+            break;
+        }
+        case 'U':
+            parse->uptime = strtod(cursor, NULL);
+            break;
+        case 'T':
+            parse->total = strtoull(cursor, NULL, 10);
+            parse->has_total = 1;
+            break;
+        case 'N':
+            parse->ncpu = atoi(cursor);
+            parse->complete = 1;
+            break;
+        case 'P': {
+            char *pid = next_field(&cursor);
+            char *ppid = next_field(&cursor);
+            char *state = next_field(&cursor);
+            char *ticks = next_field(&cursor);
+            char *starttime = next_field(&cursor);
+            char *kernel = next_field(&cursor);
+            char *rss = next_field(&cursor);
+            if (!rss || !cursor || atoi(pid) <= 0) break;  // Ligne tronquée
+
+            int index = parse_push(parse);
+            if (index < 0) return -1;
+
+            process_info_t *proc = &parse->list[index];
+            memset(proc, 0, sizeof(process_info_t));
+            proc->pid = atoi(pid);
+            proc->ppid = atoi(ppid);
+            proc->state = state[0] ? state[0] : '?';
+            proc->is_kernel = atoi(kernel);
+            proc->memory_kb = (int)(strtoull(rss, NULL, 10) * (unsigned long long)parse->page_size / 1024);
+            strncpy(proc->name, cursor, sizeof(proc->name) - 1);
+
+            parse->ticks[index] = strtoull(ticks, NULL, 10);
+            parse->starttimes[index] = strtoull(starttime, NULL, 10);
+            break;
+        }
+        default:
+            break;
+    }
+    return 0;
+}
+
+/**
+ * @brief Calcule le CPU% instantané et remplace les échantillons de l'hôte
+ *
+ * Même formule que get_process_list() : part des ticks du processus dans
+ * les ticks CPU totaux depuis l'échantillon précédent, multipliée par le
+ * nombre de cœurs. Le premier échantillon d'un PID affiche 0%.
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int remote_proc_update(remote_proc_state_t *state, remote_proc_parse_t *parse) {
+    unsigned long long total_diff = parse->has_total && state->has_sample && parse->total > state->prev_total
+                                  ? parse->total - state->prev_total : 0;
+    int ncpu = parse->ncpu > 0 ? parse->ncpu : 1;
+
+    int capacity = 64;
+    while (capacity < parse->count * 2) capacity *= 2;
+    remote_sample_t *samples = calloc(capacity, sizeof(remote_sample_t));
+    if (!samples) return -1;
+    unsigned int mask = (unsigned int)capacity - 1;
+
+    for (int i = 0; i < parse->count; i++) {
+        process_info_t *proc = &parse->list[i];
+
+        const remote_sample_t *prev = sample_lookup(state, proc->pid);
+        if (prev && prev->starttime == parse->starttimes[i] && total_diff > 0 &&
+            parse->ticks[i] >= prev->ticks) {
+            proc->cpu_percent = (float)((double)(parse->ticks[i] - prev->ticks) / total_diff * 100.0 * ncpu);
+            if (proc->cpu_percent > 100.0f) proc->cpu_percent = 100.0f;
+        }
+
+        double elapsed = parse->uptime - (double)parse->starttimes[i] / parse->clk_tck;
+        proc->time = elapsed > 0 ? (float)elapsed : 0.0f;
+
+        unsigned int slot = pid_hash(proc->pid) & mask;
+        while (samples[slot].pid != 0 && samples[slot].pid != proc->pid) slot = (slot + 1) & mask;
+        samples[slot].pid = proc->pid;
+        samples[slot].starttime = parse->starttimes[i];
+        samples[slot].ticks = parse->ticks[i];
+    }
+
+    free(state->samples);
+    state->samples = samples;
+    state->sample_capacity = capacity;
+    state->prev_total = parse->total;
+    state->has_sample = 1;
+    return 0;
+}
+
+/**
+ * @brief Récupère la liste des processus d'un hôte avec le script /proc
+ *
+ * @param host Configuration de l'hôte distant
+ * @param list Pointeur qui recevra la liste allouée
+ * @param count Pointeur qui recevra le nombre de processus
+ * @return 0 en cas de succès, -1 en cas d'erreur (sortie incomplète, /proc absent...)
+ */
+int remote_proc_fetch(const host_config_t *host, process_info_t **list, int *count) {
+    remote_proc_parse_t parse;
+    memset(&parse, 0, sizeof(parse));
+    parse.clk_tck = 100;
+    parse.page_size = 4096;
+
+    line_parser_t parser;
+    line_parser_init(&parser, remote_proc_line_handler, &parse);
+
+    int exit_status = execute_remote_command_stream(host, REMOTE_PROC_SCRIPT, line_parser_sink, &parser);
+    int result = exit_status;
+    if (exit_status > 0) {
+        network_set_error("script /proc : code de retour %d", exit_status);
+    }
+    if (result == 0 && line_parser_finish(&parser) != 0) result = -1;
+    line_parser_free(&parser);
+
+    if (result == 0 && (!parse.complete || !parse.has_total)) {
+        network_set_error("script /proc : sortie incomplète");
+        result = -1;
+    }
+
+    if (result == 0) {
+        remote_proc_state_t *state = state_acquire(host);
+        if (!state || remote_proc_update(state, &parse) != 0) result = -1;
+        if (state) pthread_mutex_unlock(&state->lock);
+    }
+
+    free(parse.ticks);
+    free(parse.starttimes);
+
+    // Échecs du transport et d'allocation : cause déjà enregistrée (ou aucune)
+    if (result != 0) {
+        snapshot_free(parse.list);
+        return -1;
+    }
+
+    if (!parse.list) {
+        parse.list = snapshot_alloc(sizeof(process_info_t));
+        if (!parse.list) return -1;
+    }
+
+    *list = parse.list;
+    *count = parse.count;
+    return 0;
+}
+
+/**
+ * @brief Oublie les échantillons d'un hôte (le prochain CPU% repartira de zéro)
+ */
+void remote_proc_forget(const host_config_t *host) {
+    pthread_mutex_lock(&states_lock);
+    remote_proc_state_t *state = state_find(host);
+    pthread_mutex_unlock(&states_lock);
+    if (!state) return;
+
+    pthread_mutex_lock(&state->lock);
+    free(state->samples);
+    state->samples = NULL;
+    state->sample_capacity = 0;
+    state->has_sample = 0;
+    pthread_mutex_unlock(&state->lock);
+}
+
+/**
+ * @brief Libère les états de collecte de tous les hôtes
+ */
+void remote_proc_cleanup(void) {
+    pthread_mutex_lock(&states_lock);
+    for (int i = 0; i < state_count; i++) {
+        free(states[i]->samples);
+        pthread_mutex_destroy(&states[i]->lock);
+        free(states[i]);
+    }
+    free(states);
+    states = NULL;
+    state_count = 0;
+    state_capacity = 0;
+    pthread_mutex_unlock(&states_lock);
+}
@@ -0,0 +1,353 @@
+#define _GNU_SOURCE
+#include "shm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "arena.h"
+#include "network.h"
+
+#define SHM_INITIAL_CAPACITY 1024
+
+static volatile sig_atomic_t publish_stop = 0;
+
+static void publish_signal(int signal_number) {
+    (void)signal_number;
+    publish_stop = 1;
+}
+
+static size_t segment_size_for(uint32_t capacity) {
+    return SHM_HEADER_SIZE + sizeof(shm_process_t) * (size_t)capacity;
+}
+
+static int pid_alive(int32_t pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+static long long realtime_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Crée le segment, ou reprend celui d'un publieur arrêté
+ *
+ * @param publisher Publieur à initialiser
+ * @param name Nom du segment ("/nom")
+ * @param interval_ms Intervalle de publication annoncé aux lecteurs
+ * @return 0 en cas de succès, -1 si le segment est inaccessible ou déjà publié
+ */
+int shm_publisher_open(shm_publisher_t *publisher, const char *name, int interval_ms) {
+    memset(publisher, 0, sizeof(shm_publisher_t));
+    snprintf(publisher->name, sizeof(publisher->name), "%s", name);
+
+    publisher->fd = shm_open(name, O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (publisher->fd < 0) return -1;
+
+    struct stat st;
+    size_t size = segment_size_for(SHM_INITIAL_CAPACITY);
+    if (fstat(publisher->fd, &st) != 0 ||
+        ((size_t)st.st_size < size && ftruncate(publisher->fd, (off_t)size) != 0)) {
+        close(publisher->fd);
+        return -1;
+    }
+    if ((size_t)st.st_size > size) size = (size_t)st.st_size;
+
+    shm_header_t *header = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, publisher->fd, 0);
+    if (header == MAP_FAILED) {
+        close(publisher->fd);
+        return -1;
+    }
+
+    int reused = header->magic == SHM_MAGIC && header->version == SHM_VERSION;
+    if (reused && header->publisher_pid != getpid() && pid_alive(header->publisher_pid)) {
+        // Un autre collecteur publie déjà sous ce nom
+        munmap(header, size);
+        close(publisher->fd);
+        return -1;
+    }
+
+    // Les lecteurs encore attachés voient une publication en cours
+    uint64_t sequence = reused ? (header->sequence | 1) + 1 : 0;
+    __atomic_store_n(&header->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    header->magic = SHM_MAGIC;
+    header->version = SHM_VERSION;
+    header->header_size = SHM_HEADER_SIZE;
+    header->record_size = sizeof(shm_process_t);
+    if (!reused) header->generation = 0;
+    header->timestamp_ms = 0;
+    header->segment_size = size;
+    header->capacity = (uint32_t)((size - SHM_HEADER_SIZE) / sizeof(shm_process_t));
+    header->count = 0;
+    header->publisher_pid = getpid();
+    header->interval_ms = (uint32_t)interval_ms;
+    if (gethostname(header->host, sizeof(header->host)) != 0) snprintf(header->host, sizeof(header->host), "localhost");
+    header->host[sizeof(header->host) - 1] = '\0';
+    __atomic_store_n(&header->sequence, sequence + 2, __ATOMIC_RELEASE);
+
+    publisher->header = header;
+    publisher->size = size;
+    return 0;
+}
+
+/**
+ * @brief Agrandit le segment pour count enregistrements (pendant une publication)
+ *
+ * Les projections des lecteurs restent valides : elles ne couvrent
+ * simplement pas la nouvelle fin, qu'ils projettent à leur prochaine lecture.
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int publisher_grow(shm_publisher_t *publisher, uint32_t count) {
+    uint32_t capacity = count + count / 2;
+    size_t size = segment_size_for(capacity);
+    if (ftruncate(publisher->fd, (off_t)size) != 0) return -1;
+
+    void *header = mremap(publisher->header, publisher->size, size, MREMAP_MAYMOVE);
+    if (header == MAP_FAILED) return -1;
+    publisher->header = header;
+    publisher->size = size;
+    publisher->header->capacity = capacity;
+    publisher->header->segment_size = size;
+    return 0;
+}
+
+/**
+ * @brief Publie un instantané
+ *
+ * @return 0 en cas de succès, -1 si le segment n'a pas pu grandir
+ *         (l'instantané précédent reste alors publié)
+ */
+int shm_publish(shm_publisher_t *publisher, const process_info_t *list, int count) {
+    shm_header_t *header = publisher->header;
+    uint64_t sequence = header->sequence;
+    __atomic_store_n(&header->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    int result = 0;
+    if ((uint32_t)count > header->capacity && publisher_grow(publisher, (uint32_t)count) != 0) {
+        result = -1;
+    } else {
+        header = publisher->header;
+        shm_process_t *records = (shm_process_t *)((char *)header + SHM_HEADER_SIZE);
+        for (int i = 0; i < count; i++) {
+            shm_process_t *record = &records[i];
+            record->pid = list[i].pid;
+            record->ppid = list[i].ppid;
+            record->cpu_percent = list[i].cpu_percent;
+            record->memory_kb = list[i].memory_kb;
+            record->time = list[i].time;
+            record->state = list[i].state;
+            record->is_kernel = (char)list[i].is_kernel;
+            record->reserved[0] = record->reserved[1] = 0;
+            snprintf(record->name, sizeof(record->name), "%.*s", (int)sizeof(record->name) - 1, list[i].name);
+        }
+        header->count = (uint32_t)count;
+        header->generation++;
+        header->timestamp_ms = realtime_ms();
+    }
+
+    __atomic_store_n(&publisher->header->sequence, sequence + 2, __ATOMIC_RELEASE);
+    return result;
+}
+
+void shm_publisher_close(shm_publisher_t *publisher) {
+    if (!publisher->header) return;
+    munmap(publisher->header, publisher->size);
+    close(publisher->fd);
+    shm_unlink(publisher->name);
+    publisher->header = NULL;
+}
+
+/**
+ * @brief Collecte /proc et publie chaque instantané jusqu'à SIGINT ou SIGTERM
+ *
+ * @param name Nom du segment (NULL pour SHM_DEFAULT_NAME)
+ * @param interval_ms Intervalle entre deux publications
+ * @return Code de sortie du programme
+ */
+int shm_publish_run(const char *name, int interval_ms) {
+    if (!name || !name[0]) name = SHM_DEFAULT_NAME;
+    if (interval_ms < 100) interval_ms = 100;
+
+    shm_publisher_t publisher;
+    if (shm_publisher_open(&publisher, name, interval_ms) != 0) {
+        fprintf(stderr, "Publication impossible sur %s (segment inaccessible ou déjà publié)\n", name);
+        return 1;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = publish_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    process_info_t *list = NULL;
+    int count = 0;
+
+    // Échantillon initial pour le calcul du CPU
+    if (get_process_list(&list, &count) == 0) free(list);
+    usleep((interval_ms < 250 ? interval_ms : 250) * 1000);
+
+    int exit_code = 0;
+    while (!publish_stop) {
+        if (get_process_list(&list, &count) != 0) {
+            exit_code = 1;
+            break;
+        }
+        shm_publish(&publisher, list, count);
+        free(list);
+        usleep(interval_ms * 1000);  // Interrompu par le signal d'arrêt
+    }
+
+    shm_publisher_close(&publisher);
+    return exit_code;
+}
+
+void shm_reader_init(shm_reader_t *reader, const char *name) {
+    memset(reader, 0, sizeof(shm_reader_t));
+    snprintf(reader->name, sizeof(reader->name), "%s", name && name[0] ? name : SHM_DEFAULT_NAME);
+    reader->fd = -1;
+}
+
+static void reader_detach(shm_reader_t *reader) {
+    if (reader->header) munmap((void *)reader->header, reader->size);
+    if (reader->fd >= 0) close(reader->fd);
+    reader->header = NULL;
+    reader->fd = -1;
+    reader->size = 0;
+}
+
+/**
+ * @brief Projette le segment en entier (taille courante)
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int reader_map(shm_reader_t *reader) {
+    if (reader->header) munmap((void *)reader->header, reader->size);
+    reader->header = NULL;
+
+    struct stat st;
+    if (fstat(reader->fd, &st) != 0 || (size_t)st.st_size < SHM_HEADER_SIZE) return -1;
+    void *header = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, reader->fd, 0);
+    if (header == MAP_FAILED) return -1;
+    reader->header = header;
+    reader->size = (size_t)st.st_size;
+    return 0;
+}
+
+/**
+ * @brief Ouvre le segment et vérifie son format
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur (cause dans network_get_error())
+ */
+static int reader_attach(shm_reader_t *reader) {
+    reader->fd = shm_open(reader->name, O_RDONLY | O_CLOEXEC, 0);
+    if (reader->fd < 0) {
+        network_set_error("shm %s : aucun publieur", reader->name);
+        return -1;
+    }
+    if (reader_map(reader) != 0) {
+        network_set_error("shm %s : segment illisible", reader->name);
+        reader_detach(reader);
+        return -1;
+    }
+
+    const shm_header_t *header = reader->header;
+    if (header->magic != SHM_MAGIC || header->version != SHM_VERSION ||
+        header->header_size != SHM_HEADER_SIZE || header->record_size != sizeof(shm_process_t)) {
+        network_set_error("shm %s : format inconnu", reader->name);
+        reader_detach(reader);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Copie le dernier instantané publié (lecture cohérente par seqlock)
+ *
+ * Si le publieur s'est arrêté, le segment est rouvert : un nouveau
+ * publieur a pu en créer un autre sous le même nom.
+ *
+ * @param reader Le lecteur
+ * @param list Pointeur qui recevra la liste (allouée par snapshot_alloc)
+ * @param count Pointeur qui recevra le nombre de processus
+ * @return 0 en cas de succès, -1 en cas d'erreur (cause dans network_get_error())
+ */
+int shm_read(shm_reader_t *reader, process_info_t **list, int *count) {
+    if (reader->fd >= 0 && !pid_alive(reader->header->publisher_pid)) reader_detach(reader);
+    if (reader->fd < 0 && reader_attach(reader) != 0) return -1;
+    if (!pid_alive(reader->header->publisher_pid)) {
+        network_set_error("shm %s : publieur arrêté", reader->name);
+        reader_detach(reader);
+        return -1;
+    }
+
+    for (int attempt = 0; attempt < SHM_READ_RETRIES; attempt++) {
+        const shm_header_t *header = reader->header;
+        uint64_t before = __atomic_load_n(&header->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            sched_yield();
+            continue;
+        }
+
+        uint64_t segment_size = __atomic_load_n(&header->segment_size, __ATOMIC_RELAXED);
+        if (segment_size > reader->size) {
+            // Segment agrandi par le publieur depuis la projection
+            if (reader_map(reader) != 0) break;
+            continue;
+        }
+
+        uint32_t records = __atomic_load_n(&header->count, __ATOMIC_RELAXED);
+        if (records > (reader->size - SHM_HEADER_SIZE) / sizeof(shm_process_t)) continue;
+        if ((int)records > reader->copy_capacity) {
+            shm_process_t *copy = realloc(reader->copy, sizeof(shm_process_t) * records);
+            if (!copy) break;
+            reader->copy = copy;
+            reader->copy_capacity = (int)records;
+        }
+        memcpy(reader->copy, (const char *)header + SHM_HEADER_SIZE, sizeof(shm_process_t) * records);
+        uint64_t generation = __atomic_load_n(&header->generation, __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&header->sequence, __ATOMIC_RELAXED) != before) continue;
+
+        process_info_t *processes = snapshot_alloc(sizeof(process_info_t) * (records > 0 ? records : 1));
+        if (!processes) return -1;
+        for (uint32_t i = 0; i < records; i++) {
+            const shm_process_t *record = &reader->copy[i];
+            process_info_t *proc = &processes[i];
+            proc->pid = record->pid;
+            proc->ppid = record->ppid;
+            proc->cpu_percent = record->cpu_percent;
+            proc->memory_kb = record->memory_kb;
+            proc->time = record->time;
+            proc->state = record->state;
+            proc->is_kernel = record->is_kernel;
+            snprintf(proc->name, sizeof(proc->name), "%.*s", (int)sizeof(record->name), record->name);
+        }
+        reader->generation = generation;
+        *list = processes;
+        *count = (int)records;
+        return 0;
+    }
+
+    network_set_error("shm %s : aucune lecture cohérente", reader->name);
+    return -1;
+}
+
+void shm_reader_close(shm_reader_t *reader) {
+    reader_detach(reader);
+    free(reader->copy);
+    reader->copy = NULL;
+    reader->copy_capacity = 0;
+}
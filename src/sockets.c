@@ -0,0 +1,308 @@
+#define _GNU_SOURCE
+#include "sockets.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include "proc_parse.h"
+
+#define SOCKETS_PROTO_TCP 1
+#define SOCKETS_PROTO_UDP 2
+#define SOCKETS_TABLE_MIN 4096        // Cases de la table au départ (puissance de 2)
+
+// Case de la table inode -> socket (adressage ouvert, sondage linéaire)
+typedef struct {
+    unsigned long long inode;         // 0 : case libre
+    unsigned char proto;              // SOCKETS_PROTO_*
+    unsigned char state;              // Champ st de /proc/net
+} socket_slot_t;
+
+// Inodes des sockets d'un processus, lus dans /proc/[pid]/fd
+typedef struct {
+    int pid;
+    int scanned;                      // 0 tant que la liste n'a jamais été lue
+    long long scanned_ms;             // Date de la dernière lecture
+    int readable;                     // 0 si /proc/[pid]/fd est illisible (autre utilisateur)
+    unsigned long long *inodes;
+    int count;
+    int capacity;
+} fd_cache_t;
+
+// Table reconstruite à chaque collecte
+static socket_slot_t *socket_table = NULL;
+static size_t socket_capacity = 0;
+static size_t socket_count = 0;
+
+// Cache des descripteurs, trié par PID ; fd_next sert de tampon au passage en cours
+static fd_cache_t *fd_cache = NULL;
+static int fd_cache_count = 0;
+static int fd_cache_capacity = 0;
+static fd_cache_t *fd_next = NULL;
+static int fd_next_capacity = 0;
+
+// Tampon de lecture de /proc/net (100 000 sockets font environ 15 Mo)
+static char net_buffer[65536];
+
+static long long sockets_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static size_t socket_hash(unsigned long long inode, size_t mask) {
+    inode *= 0x9E3779B97F4A7C15ULL;
+    return (size_t)(inode ^ (inode >> 29)) & mask;
+}
+
+/**
+ * @brief Cherche la case d'un inode (la case libre où l'insérer s'il est absent)
+ */
+static socket_slot_t *socket_slot(socket_slot_t *table, size_t capacity, unsigned long long inode) {
+    size_t mask = capacity - 1;
+    size_t i = socket_hash(inode, mask);
+    while (table[i].inode != 0 && table[i].inode != inode) i = (i + 1) & mask;
+    return &table[i];
+}
+
+/**
+ * @brief Double la table et y replace les sockets déjà lues
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int socket_table_grow(void) {
+    size_t capacity = socket_capacity ? socket_capacity * 2 : SOCKETS_TABLE_MIN;
+    socket_slot_t *table = calloc(capacity, sizeof(socket_slot_t));
+    if (!table) return -1;
+
+    for (size_t i = 0; i < socket_capacity; i++) {
+        if (socket_table[i].inode != 0) *socket_slot(table, capacity, socket_table[i].inode) = socket_table[i];
+    }
+    free(socket_table);
+    socket_table = table;
+    socket_capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Ajoute une socket à la table (taux de remplissage gardé sous 1/2)
+ */
+static int socket_table_add(unsigned long long inode, unsigned char proto, unsigned char state) {
+    if ((socket_count + 1) * 2 > socket_capacity && socket_table_grow() != 0) return -1;
+
+    socket_slot_t *slot = socket_slot(socket_table, socket_capacity, inode);
+    if (slot->inode == 0) socket_count++;
+    slot->inode = inode;
+    slot->proto = proto;
+    slot->state = state;
+    return 0;
+}
+
+/**
+ * @brief Charge un fichier de /proc/net dans la table
+ *
+ * Lu par blocs, ligne par ligne, sans stdio. Les sockets sans propriétaire
+ * (inode 0, TIME_WAIT par exemple) ne sont rattachées à aucun processus et
+ * ne sont pas gardées. Un fichier absent (IPv6 désactivé) est ignoré.
+ *
+ * @param path Chemin du fichier
+ * @param proto SOCKETS_PROTO_TCP ou SOCKETS_PROTO_UDP
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int socket_table_load(const char *path, unsigned char proto) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    size_t used = 0;
+    ssize_t n;
+    int result = 0;
+    while (result == 0 && (n = read(fd, net_buffer + used, sizeof(net_buffer) - used)) > 0) {
+        used += (size_t)n;
+        char *start = net_buffer;
+        char *end = net_buffer + used;
+        char *newline;
+        while (result == 0 && (newline = memchr(start, '\n', (size_t)(end - start))) != NULL) {
+            proc_net_socket_t entry;
+            if (proc_parse_net_socket(start, (size_t)(newline - start), &entry) == 0 && entry.inode != 0) {
+                result = socket_table_add(entry.inode, proto, (unsigned char)entry.state);
+            }
+            start = newline + 1;
+        }
+        used = (size_t)(end - start);
+        memmove(net_buffer, start, used);
+        if (used == sizeof(net_buffer)) used = 0;  // Ligne démesurée : ignorée
+    }
+    close(fd);
+    return result;
+}
+
+/**
+ * @brief Relit les inodes des sockets d'un processus dans /proc/[pid]/fd
+ *
+ * @param entry Entrée du cache à remplir
+ * @return Nombre de liens lus (coût de la lecture)
+ */
+static int fd_cache_scan(fd_cache_t *entry) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/fd", entry->pid);
+    entry->count = 0;
+
+    DIR *directory = opendir(path);
+    if (!directory) {
+        entry->readable = 0;
+        return 1;
+    }
+    entry->readable = 1;
+
+    int links = 0;
+    struct dirent *fd_entry;
+    while ((fd_entry = readdir(directory)) != NULL) {
+        if (fd_entry->d_name[0] < '0' || fd_entry->d_name[0] > '9') continue;
+        char target[64];
+        ssize_t len = readlinkat(dirfd(directory), fd_entry->d_name, target, sizeof(target) - 1);
+        links++;
+        if (len <= 8 || memcmp(target, "socket:[", 8) != 0) continue;
+        target[len] = '\0';
+
+        if (entry->count >= entry->capacity) {
+            int capacity = entry->capacity ? entry->capacity * 2 : 16;
+            unsigned long long *inodes = realloc(entry->inodes, sizeof(unsigned long long) * capacity);
+            if (!inodes) break;
+            entry->inodes = inodes;
+            entry->capacity = capacity;
+        }
+        entry->inodes[entry->count++] = strtoull(target + 8, NULL, 10);
+    }
+    closedir(directory);
+    return links;
+}
+
+/**
+ * @brief Compte les sockets d'un processus d'après la table du moment
+ */
+static void fd_cache_count_sockets(const fd_cache_t *entry, process_info_t *proc) {
+    proc->tcp_sockets = proc->tcp_established = proc->tcp_listen = proc->tcp_close_wait = proc->udp_sockets = 0;
+    if (socket_count == 0) return;
+
+    for (int i = 0; i < entry->count; i++) {
+        const socket_slot_t *slot = socket_slot(socket_table, socket_capacity, entry->inodes[i]);
+        if (slot->inode == 0) continue;  // Socket Unix, ou fermée depuis la lecture des fd
+        if (slot->proto == SOCKETS_PROTO_UDP) {
+            proc->udp_sockets++;
+            continue;
+        }
+        proc->tcp_sockets++;
+        if (slot->state == SOCKETS_TCP_ESTABLISHED) proc->tcp_established++;
+        else if (slot->state == SOCKETS_TCP_LISTEN) proc->tcp_listen++;
+        else if (slot->state == SOCKETS_TCP_CLOSE_WAIT) proc->tcp_close_wait++;
+    }
+}
+
+static void mark_unknown(process_info_t *proc) {
+    proc->tcp_sockets = proc->tcp_established = proc->tcp_listen = proc->tcp_close_wait = proc->udp_sockets = -1;
+}
+
+static int compare_fd_cache_pid(const void *a, const void *b) {
+    int pid_a = ((const fd_cache_t *)a)->pid;
+    int pid_b = ((const fd_cache_t *)b)->pid;
+    return (pid_a > pid_b) - (pid_a < pid_b);
+}
+
+/**
+ * @brief Compte les sockets TCP et UDP de chaque processus de la liste
+ *
+ * Les quatre fichiers de /proc/net sont relus à chaque appel. Les listes de
+ * descripteurs trop anciennes sont relues dans la limite du budget ; un
+ * processus dont la liste n'a jamais pu être lue reste à -1 jusqu'à la
+ * collecte suivante. La première lecture d'un processus est datée en
+ * arrière selon son PID, pour que les relectures suivantes de processus
+ * apparus ensemble s'étalent sur SOCKETS_FD_REFRESH_MS. Les processus
+ * disparus sortent du cache.
+ *
+ * @param list Processus de la collecte
+ * @param count Nombre de processus
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+int sockets_annotate(process_info_t *list, int count) {
+    long long now = sockets_now_ms();
+
+    if (count > fd_next_capacity) {
+        fd_cache_t *next = realloc(fd_next, sizeof(fd_cache_t) * count);
+        if (!next) {
+            for (int i = 0; i < count; i++) mark_unknown(&list[i]);
+            return -1;
+        }
+        fd_next = next;
+        fd_next_capacity = count;
+    }
+
+    if (socket_capacity) memset(socket_table, 0, sizeof(socket_slot_t) * socket_capacity);
+    socket_count = 0;
+    if (socket_table_load("/proc/net/tcp", SOCKETS_PROTO_TCP) != 0 ||
+        socket_table_load("/proc/net/tcp6", SOCKETS_PROTO_TCP) != 0 ||
+        socket_table_load("/proc/net/udp", SOCKETS_PROTO_UDP) != 0 ||
+        socket_table_load("/proc/net/udp6", SOCKETS_PROTO_UDP) != 0) {
+        for (int i = 0; i < count; i++) mark_unknown(&list[i]);
+        return -1;
+    }
+
+    int budget = SOCKETS_FD_BUDGET;
+    int next_count = 0;
+    for (int i = 0; i < count; i++) {
+        process_info_t *proc = &list[i];
+        if (proc->is_kernel) {
+            // Un thread noyau n'a aucun descripteur
+            proc->tcp_sockets = proc->tcp_established = proc->tcp_listen = proc->tcp_close_wait = proc->udp_sockets = 0;
+            continue;
+        }
+
+        fd_cache_t key = { .pid = proc->pid };
+        fd_cache_t *previous = fd_cache_count > 0 ? bsearch(&key, fd_cache, fd_cache_count, sizeof(fd_cache_t),
+                                                            compare_fd_cache_pid) : NULL;
+        fd_cache_t *entry = &fd_next[next_count++];
+        if (previous) {
+            *entry = *previous;
+            previous->inodes = NULL;  // Transférée au nouveau cache
+        } else {
+            memset(entry, 0, sizeof(fd_cache_t));
+            entry->pid = proc->pid;
+        }
+
+        if (budget > 0 && (!entry->scanned || now - entry->scanned_ms >= SOCKETS_FD_REFRESH_MS)) {
+            budget -= fd_cache_scan(entry);
+            entry->scanned_ms = entry->scanned ? now : now - proc->pid % SOCKETS_FD_REFRESH_MS;
+            entry->scanned = 1;
+        }
+
+        if (!entry->scanned || !entry->readable) mark_unknown(proc);
+        else fd_cache_count_sockets(entry, proc);
+    }
+
+    // Processus disparus : leurs listes sont libérées, et les deux tampons échangés
+    for (int i = 0; i < fd_cache_count; i++) free(fd_cache[i].inodes);
+    qsort(fd_next, next_count, sizeof(fd_cache_t), compare_fd_cache_pid);
+    fd_cache_t *swap = fd_cache;
+    int swap_capacity = fd_cache_capacity;
+    fd_cache = fd_next;
+    fd_cache_count = next_count;
+    fd_cache_capacity = fd_next_capacity;
+    fd_next = swap;
+    fd_next_capacity = swap_capacity;
+    return 0;
+}
+
+/**
+ * @brief Libère la table des sockets et le cache des descripteurs
+ */
+void sockets_cleanup(void) {
+    for (int i = 0; i < fd_cache_count; i++) free(fd_cache[i].inodes);
+    free(fd_cache);
+    free(fd_next);
+    free(socket_table);
+    fd_cache = fd_next = NULL;
+    fd_cache_count = fd_cache_capacity = fd_next_capacity = 0;
+    socket_table = NULL;
+    socket_capacity = socket_count = 0;
+}
@@ -0,0 +1,611 @@
+#define _GNU_SOURCE
+#include "ssh_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#ifdef HAVE_LIBSSH
+#include <pthread.h>
+#include <libssh/libssh.h>
+
+#include "network.h"
+
+#define SSH_POOL_TIMEOUT_SEC 3
+#define SSH_STREAM_SLICE_MS 100  // Le verrou de la session est relâché entre deux tranches de lecture
+
+// Une entrée du pool : une session authentifiée par hôte.
+// Une session libssh ne doit être utilisée que par un thread à la fois :
+// toute opération sur la session ou ses canaux se fait sous entry->lock.
+typedef struct {
+    char address[128];
+    int port;
+    char username[64];
+    char password[64];
+    ssh_session session;  // NULL si déconnecté (reconnexion au prochain appel)
+    unsigned int epoch;   // Incrémenté à chaque fermeture : invalide les flux ouverts
+    pthread_mutex_t lock;
+} ssh_pool_entry_t;
+
+static ssh_pool_entry_t **pool = NULL;
+static int pool_count = 0;
+static int pool_capacity = 0;
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;  // Protège le tableau du pool
+
+/**
+ * @brief Recherche l'entrée du pool correspondant à un hôte
+ *
+ * Doit être appelée sous pool_lock.
+ *
+ * @param host Adresse de l'hôte
+ * @param port Port SSH
+ * @param username Nom d'utilisateur
+ * @return Pointeur vers l'entrée, ou NULL si l'hôte n'est pas dans le pool
+ */
+static ssh_pool_entry_t *pool_find(const char *host, int port, const char *username) {
+    for (int i = 0; i < pool_count; i++) {
+        if (pool[i]->port == port &&
+            strcmp(pool[i]->address, host) == 0 &&
+            strcmp(pool[i]->username, username) == 0) {
+            return pool[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Recherche ou crée l'entrée du pool d'un hôte, puis la verrouille
+ *
+ * Les entrées sont allouées individuellement pour que leur adresse reste
+ * stable quand le tableau du pool est agrandi.
+ *
+ * @return Pointeur vers l'entrée verrouillée, ou NULL en cas d'erreur d'allocation
+ */
+static ssh_pool_entry_t *pool_acquire(const char *host, int port, const char *username,
+                                      const char *password) {
+    pthread_mutex_lock(&pool_lock);
+    ssh_pool_entry_t *entry = pool_find(host, port, username);
+
+    if (!entry) {
+        if (pool_count >= pool_capacity) {
+            int capacity = pool_capacity ? pool_capacity * 2 : 8;
+            ssh_pool_entry_t **tmp = realloc(pool, sizeof(ssh_pool_entry_t *) * capacity);
+            if (!tmp) {
+                pthread_mutex_unlock(&pool_lock);
+                return NULL;
+            }
+            pool = tmp;
+            pool_capacity = capacity;
+        }
+
+        entry = calloc(1, sizeof(ssh_pool_entry_t));
+        if (!entry) {
+            pthread_mutex_unlock(&pool_lock);
+            return NULL;
+        }
+
+        snprintf(entry->address, sizeof(entry->address), "%s", host);
+        snprintf(entry->username, sizeof(entry->username), "%s", username);
+        entry->port = port;
+        entry->session = NULL;
+        pthread_mutex_init(&entry->lock, NULL);
+
+        pool[pool_count++] = entry;
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    pthread_mutex_lock(&entry->lock);
+    // Le mot de passe a pu changer dans la configuration
+    snprintf(entry->password, sizeof(entry->password), "%s", password ? password : "");
+    return entry;
+}
+
+static void pool_release(ssh_pool_entry_t *entry) {
+    pthread_mutex_unlock(&entry->lock);
+}
+
+/**
+ * @brief Ferme la session d'une entrée du pool (sous entry->lock)
+ *
+ * L'entrée reste dans le pool : la session sera rouverte au prochain appel.
+ * Les canaux de la session sont libérés avec elle, les flux encore ouverts
+ * deviennent invalides (epoch).
+ */
+static void pool_close(ssh_pool_entry_t *entry) {
+    if (entry->session) {
+        ssh_disconnect(entry->session);
+        ssh_free(entry->session);
+        entry->session = NULL;
+        entry->epoch++;
+    }
+}
+
+/**
+ * @brief Ouvre et authentifie la session d'une entrée du pool
+ *
+ * Authentification par mot de passe si un mot de passe est configuré,
+ * sinon par les clés SSH par défaut de l'utilisateur. Comme l'ancienne
+ * version (StrictHostKeyChecking=no), la clé de l'hôte n'est pas vérifiée.
+ * Le délai de connexion est borné par l'échéance du thread courant.
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int pool_open(ssh_pool_entry_t *entry) {
+    int remaining_ms = network_remaining_ms();
+    if (remaining_ms == 0) return -1;
+
+    ssh_session session = ssh_new();
+    if (!session) return -1;
+
+    long timeout = SSH_POOL_TIMEOUT_SEC;
+    if (remaining_ms > 0 && remaining_ms < timeout * 1000) {
+        timeout = (remaining_ms + 999) / 1000;
+    }
+    ssh_options_set(session, SSH_OPTIONS_HOST, entry->address);
+    ssh_options_set(session, SSH_OPTIONS_PORT, &entry->port);
+    ssh_options_set(session, SSH_OPTIONS_TIMEOUT, &timeout);
+    if (entry->username[0] != '\0') {
+        ssh_options_set(session, SSH_OPTIONS_USER, entry->username);
+    }
+
+    if (ssh_connect(session) != SSH_OK) {
+        network_set_error("ssh : %s", ssh_get_error(session));
+        ssh_free(session);
+        return -1;
+    }
+
+    int auth;
+    if (entry->password[0] != '\0') {
+        auth = ssh_userauth_password(session, NULL, entry->password);
+    } else {
+        auth = ssh_userauth_publickey_auto(session, NULL, NULL);
+    }
+
+    if (auth != SSH_AUTH_SUCCESS) {
+        network_set_error("ssh : authentification refusée");
+        ssh_disconnect(session);
+        ssh_free(session);
+        return -1;
+    }
+
+    entry->session = session;
+    return 0;
+}
+
+/**
+ * @brief Ouvre un canal sur la session et y lance une commande
+ *
+ * @return Le canal, ou NULL si la session est inutilisable
+ */
+static ssh_channel pool_exec(ssh_pool_entry_t *entry, const char *command) {
+    ssh_channel channel = ssh_channel_new(entry->session);
+    if (!channel) return NULL;
+
+    if (ssh_channel_open_session(channel) != SSH_OK) {
+        ssh_channel_free(channel);
+        return NULL;
+    }
+
+    if (ssh_channel_request_exec(channel, command) != SSH_OK) {
+        ssh_channel_close(channel);
+        ssh_channel_free(channel);
+        return NULL;
+    }
+    return channel;
+}
+
+/**
+ * @brief Exécute une commande sur un nouveau canal de la session
+ *
+ * @param entry Entrée du pool (session ouverte)
+ * @param command Commande à exécuter
+ * @param sink Puits recevant la sortie au fil de l'eau
+ * @param context Contexte du puits
+ * @param exit_status Code de retour de la commande distante (-1 si le puits a interrompu la lecture)
+ * @return 0 si la commande a été exécutée, -1 si le canal n'a pas pu être ouvert
+ *         (session inutilisable), -2 si la lecture a échoué ou si l'échéance du
+ *         thread est dépassée (une partie de la sortie a pu être transmise)
+ */
+static int pool_run(ssh_pool_entry_t *entry, const char *command,
+                    output_sink_t sink, void *context, int *exit_status) {
+    ssh_channel channel = pool_exec(entry, command);
+    if (!channel) return -1;
+
+    char buffer[16384];
+    int failed = 0;
+    int aborted = 0;
+
+    for (;;) {
+        int remaining_ms = network_remaining_ms();
+        if (remaining_ms == 0) {
+            failed = 1;
+            break;
+        }
+
+        int n = ssh_channel_read_timeout(channel, buffer, sizeof(buffer), 0, remaining_ms);
+        if (n == SSH_ERROR) {
+            failed = 1;
+            break;
+        }
+        if (n == 0) {
+            if (ssh_channel_is_eof(channel)) break;
+            continue;
+        }
+
+        if (sink(buffer, (size_t)n, context) != 0) {
+            aborted = 1;
+            break;
+        }
+    }
+
+    ssh_channel_send_eof(channel);
+    ssh_channel_close(channel);
+    *exit_status = aborted ? -1 : ssh_channel_get_exit_status(channel);
+    ssh_channel_free(channel);
+
+    return failed ? -2 : 0;
+}
+
+int ssh_pool_available(void) {
+    return 1;
+}
+
+/**
+ * @brief Ouvre la session SSH d'un hôte si elle n'existe pas encore
+ *
+ * @return 0 si la session est prête, -1 en cas d'erreur
+ */
+int ssh_pool_connect(const char *host, int port, const char *username, const char *password) {
+    ssh_pool_entry_t *entry = pool_acquire(host, port, username, password);
+    if (!entry) return -1;
+
+    int result = entry->session ? 0 : pool_open(entry);
+    pool_release(entry);
+    return result;
+}
+
+/**
+ * @brief Exécute une commande distante via la session persistante de l'hôte
+ *
+ * La session est ouverte au premier appel puis réutilisée : seule l'ouverture
+ * d'un canal est payée à chaque commande. Si la session est morte (hôte
+ * redémarré, coupure réseau), elle est refermée et une reconnexion est tentée
+ * une seule fois ; en cas d'échec, la prochaine commande retentera.
+ *
+ * @return Code de retour de la commande distante, -1 en cas d'erreur de connexion
+ */
+int ssh_pool_execute(const char *host, int port, const char *username, const char *password,
+                     const char *command, output_sink_t sink, void *context) {
+    ssh_pool_entry_t *entry = pool_acquire(host, port, username, password);
+    if (!entry) return -1;
+
+    int result = -1;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int reused = (entry->session != NULL);
+        if (!reused && pool_open(entry) != 0) break;
+
+        int exit_status = -1;
+        int run = pool_run(entry, command, sink, context, &exit_status);
+        if (run == 0) {
+            result = exit_status;
+            break;
+        }
+
+        pool_close(entry);
+        // Une session neuve qui échoue ne fera pas mieux au second essai, et une
+        // sortie déjà transmise au puits ne doit pas l'être deux fois
+        if (run == -2 || !reused) break;
+    }
+
+    pool_release(entry);
+    return result;
+}
+
+void ssh_pool_disconnect(const char *host, int port, const char *username) {
+    pthread_mutex_lock(&pool_lock);
+    ssh_pool_entry_t *entry = pool_find(host, port, username);
+    pthread_mutex_unlock(&pool_lock);
+
+    if (entry) {
+        pthread_mutex_lock(&entry->lock);
+        pool_close(entry);
+        pthread_mutex_unlock(&entry->lock);
+    }
+}
+
+/**
+ * @brief Ferme toutes les sessions et libère le pool
+ *
+ * Les threads utilisant le pool doivent être arrêtés au préalable.
+ */
+void ssh_pool_cleanup(void) {
+    pthread_mutex_lock(&pool_lock);
+    for (int i = 0; i < pool_count; i++) {
+        pool_close(pool[i]);
+        pthread_mutex_destroy(&pool[i]->lock);
+        free(pool[i]);
+    }
+    free(pool);
+    pool = NULL;
+    pool_count = 0;
+    pool_capacity = 0;
+    pthread_mutex_unlock(&pool_lock);
+}
+
+struct ssh_stream {
+    ssh_pool_entry_t *entry;
+    ssh_channel channel;
+    unsigned int epoch;  // Epoch de la session à l'ouverture du canal
+};
+
+/**
+ * @brief Lance une commande distante sur un canal gardé ouvert
+ *
+ * Le canal est ouvert sur la session persistante de l'hôte, qui est
+ * (re)connectée si nécessaire.
+ *
+ * @return Le flux ouvert, ou NULL en cas d'erreur
+ */
+ssh_stream_t *ssh_stream_open(const char *host, int port, const char *username, const char *password,
+                              const char *command) {
+    ssh_pool_entry_t *entry = pool_acquire(host, port, username, password);
+    if (!entry) return NULL;
+
+    ssh_stream_t *stream = NULL;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int reused = (entry->session != NULL);
+        if (!reused && pool_open(entry) != 0) break;
+
+        ssh_channel channel = pool_exec(entry, command);
+        if (channel) {
+            stream = malloc(sizeof(ssh_stream_t));
+            if (stream) {
+                stream->entry = entry;
+                stream->channel = channel;
+                stream->epoch = entry->epoch;
+            } else {
+                ssh_channel_close(channel);
+                ssh_channel_free(channel);
+            }
+            break;
+        }
+
+        pool_close(entry);
+        if (!reused) break;
+    }
+
+    pool_release(entry);
+    return stream;
+}
+
+int ssh_stream_read(ssh_stream_t *stream, void *buffer, int size, int timeout_ms) {
+    if (!stream) return -1;
+
+    int waited = 0;
+    for (;;) {
+        pthread_mutex_lock(&stream->entry->lock);
+        if (stream->epoch != stream->entry->epoch) {
+            // La session a été fermée entre-temps : le canal n'existe plus
+            pthread_mutex_unlock(&stream->entry->lock);
+            return -1;
+        }
+
+        int slice = timeout_ms - waited;
+        if (slice > SSH_STREAM_SLICE_MS) slice = SSH_STREAM_SLICE_MS;
+
+        int n;
+        if (slice <= 0) {
+            n = ssh_channel_read_nonblocking(stream->channel, buffer, size, 0);
+        } else {
+            n = ssh_channel_read_timeout(stream->channel, buffer, size, 0, slice);
+        }
+        int eof = ssh_channel_is_eof(stream->channel);
+        pthread_mutex_unlock(&stream->entry->lock);
+
+        if (n == SSH_ERROR) return -1;
+        if (n > 0) return n;
+        if (eof) return -1;
+
+        waited += (slice > 0) ? slice : 0;
+        if (waited >= timeout_ms) return 0;
+    }
+}
+
+int ssh_stream_write(ssh_stream_t *stream, const void *buffer, int size) {
+    if (!stream) return -1;
+
+    pthread_mutex_lock(&stream->entry->lock);
+    int written = 0;
+    if (stream->epoch != stream->entry->epoch) {
+        written = -1;
+    }
+    while (written >= 0 && written < size) {
+        int n = ssh_channel_write(stream->channel, (const char *)buffer + written, size - written);
+        if (n == SSH_ERROR) {
+            written = -1;
+            break;
+        }
+        written += n;
+    }
+    pthread_mutex_unlock(&stream->entry->lock);
+    return written;
+}
+
+void ssh_stream_close(ssh_stream_t *stream) {
+    if (!stream) return;
+
+    pthread_mutex_lock(&stream->entry->lock);
+    if (stream->epoch == stream->entry->epoch) {
+        ssh_channel_send_eof(stream->channel);
+        ssh_channel_close(stream->channel);
+        ssh_channel_free(stream->channel);
+    }
+    pthread_mutex_unlock(&stream->entry->lock);
+    free(stream);
+}
+
+#else // !HAVE_LIBSSH
+
+int ssh_pool_available(void) {
+    return 0;
+}
+
+int ssh_pool_connect(const char *host, int port, const char *username, const char *password) {
+    (void)host; (void)port; (void)username; (void)password;
+    return -1;
+}
+
+int ssh_pool_execute(const char *host, int port, const char *username, const char *password,
+                     const char *command, output_sink_t sink, void *context) {
+    (void)host; (void)port; (void)username; (void)password; (void)command;
+    (void)sink; (void)context;
+    return -1;
+}
+
+void ssh_pool_disconnect(const char *host, int port, const char *username) {
+    (void)host; (void)port; (void)username;
+}
+
+void ssh_pool_cleanup(void) {
+}
+
+struct ssh_stream {
+    pid_t pid;
+    int read_fd;   // stdout de la commande distante
+    int write_fd;  // stdin de la commande distante
+};
+
+/**
+ * @brief Lance une commande distante via un client ssh fils gardé ouvert
+ *
+ * Le client est lancé sans shell intermédiaire (execvp) ; ses entrée et
+ * sortie standard sont reliées au processus par deux tubes, créés avec
+ * O_CLOEXEC pour ne pas fuir dans les commandes lancées par d'autres threads.
+ *
+ * @return Le flux ouvert, ou NULL en cas d'erreur
+ */
+ssh_stream_t *ssh_stream_open(const char *host, int port, const char *username, const char *password,
+                              const char *command) {
+    char port_str[16];
+    char target[256];
+    snprintf(port_str, sizeof(port_str), "%d", port);
+    if (username && username[0] != '\0') {
+        snprintf(target, sizeof(target), "%s@%s", username, host);
+    } else {
+        snprintf(target, sizeof(target), "%s", host);
+    }
+
+    const char *argv[20];
+    int argc = 0;
+    if (password && password[0] != '\0') {
+        argv[argc++] = "sshpass";
+        argv[argc++] = "-p";
+        argv[argc++] = password;
+    }
+    argv[argc++] = "ssh";
+    argv[argc++] = "-T";
+    argv[argc++] = "-o";
+    argv[argc++] = "StrictHostKeyChecking=no";
+    argv[argc++] = "-o";
+    argv[argc++] = "ConnectTimeout=3";
+    argv[argc++] = "-o";
+    argv[argc++] = "ServerAliveInterval=5";
+    argv[argc++] = "-p";
+    argv[argc++] = port_str;
+    argv[argc++] = target;
+    argv[argc++] = command;
+    argv[argc] = NULL;
+
+    int to_child[2];
+    int from_child[2];
+    if (pipe2(to_child, O_CLOEXEC) == -1) return NULL;
+    if (pipe2(from_child, O_CLOEXEC) == -1) {
+        close(to_child[0]);
+        close(to_child[1]);
+        return NULL;
+    }
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        close(to_child[0]);
+        close(to_child[1]);
+        close(from_child[0]);
+        close(from_child[1]);
+        return NULL;
+    }
+
+    if (pid == 0) {
+        dup2(to_child[0], STDIN_FILENO);
+        dup2(from_child[1], STDOUT_FILENO);
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull != -1) dup2(devnull, STDERR_FILENO);
+        close(to_child[0]);
+        close(to_child[1]);
+        close(from_child[0]);
+        close(from_child[1]);
+        execvp(argv[0], (char *const *)argv);
+        _exit(127);
+    }
+
+    close(to_child[0]);
+    close(from_child[1]);
+
+    ssh_stream_t *stream = malloc(sizeof(ssh_stream_t));
+    if (!stream) {
+        close(to_child[1]);
+        close(from_child[0]);
+        kill(pid, SIGTERM);
+        waitpid(pid, NULL, 0);
+        return NULL;
+    }
+
+    stream->pid = pid;
+    stream->read_fd = from_child[0];
+    stream->write_fd = to_child[1];
+    return stream;
+}
+
+int ssh_stream_read(ssh_stream_t *stream, void *buffer, int size, int timeout_ms) {
+    if (!stream) return -1;
+
+    struct pollfd pfd = { .fd = stream->read_fd, .events = POLLIN, .revents = 0 };
+    int ready = poll(&pfd, 1, timeout_ms < 0 ? 0 : timeout_ms);
+    if (ready == 0) return 0;
+    if (ready < 0) return (errno == EINTR) ? 0 : -1;
+
+    ssize_t n = read(stream->read_fd, buffer, size);
+    if (n < 0) return (errno == EINTR || errno == EAGAIN) ? 0 : -1;
+    if (n == 0) return -1;  // Fin de flux : la commande distante est terminée
+    return (int)n;
+}
+
+int ssh_stream_write(ssh_stream_t *stream, const void *buffer, int size) {
+    if (!stream) return -1;
+    int written = 0;
+    while (written < size) {
+        ssize_t n = write(stream->write_fd, (const char *)buffer + written, size - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        written += (int)n;
+    }
+    return written;
+}
+
+void ssh_stream_close(ssh_stream_t *stream) {
+    if (!stream) return;
+    close(stream->write_fd);
+    close(stream->read_fd);
+    kill(stream->pid, SIGTERM);
+    waitpid(stream->pid, NULL, 0);
+    free(stream);
+}
+
+#endif // HAVE_LIBSSH
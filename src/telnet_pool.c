@@ -0,0 +1,540 @@
+#define _GNU_SOURCE
+#include "telnet_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "network.h"
+
+#define TELNET_POOL_TIMEOUT_MS 5000  // Délai par défaut si le thread n'a pas d'échéance
+
+// Commandes et options du protocole telnet (RFC 854, 857, 858)
+#define TELNET_SE   240
+#define TELNET_SB   250
+#define TELNET_WILL 251
+#define TELNET_WONT 252
+#define TELNET_DO   253
+#define TELNET_DONT 254
+#define TELNET_IAC  255
+#define TELNET_OPT_ECHO 1
+#define TELNET_OPT_SGA  3
+
+// Marqueurs de synchronisation. La commande envoyée les écrit en deux
+// morceaux ("__GR_""B1__") : l'écho éventuel de la ligne tapée ne peut pas
+// être confondu avec la sortie de echo.
+#define TELNET_MARK_PREFIX "__GR_"
+#define TELNET_READY_MARK TELNET_MARK_PREFIX "READY__"
+
+// État du filtre de protocole (conservé entre deux lectures)
+typedef enum {
+    TELNET_STATE_DATA,
+    TELNET_STATE_IAC,     // IAC reçu
+    TELNET_STATE_OPTION,  // IAC WILL/WONT/DO/DONT reçu, option attendue
+    TELNET_STATE_SB,      // Sous-négociation ignorée jusqu'à IAC SE
+    TELNET_STATE_SB_IAC
+} telnet_state_t;
+
+// Une entrée du pool : une session telnet authentifiée par hôte.
+// Le shell distant ne traite qu'une commande à la fois : toute opération
+// sur la session se fait sous entry->lock.
+typedef struct {
+    char address[128];
+    int port;
+    char username[64];
+    char password[64];
+    int fd;                  // -1 si déconnecté (reconnexion au prochain appel)
+    unsigned int sequence;   // Numéro de la dernière commande envoyée
+    telnet_state_t state;
+    unsigned char command;   // WILL/WONT/DO/DONT en attente de son option
+    char *text;              // Texte reçu (protocole retiré) pas encore consommé
+    size_t text_len;
+    size_t text_capacity;
+    pthread_mutex_t lock;
+} telnet_pool_entry_t;
+
+static telnet_pool_entry_t **pool = NULL;
+static int pool_count = 0;
+static int pool_capacity = 0;
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;  // Protège le tableau du pool
+
+/**
+ * @brief Recherche l'entrée du pool correspondant à un hôte (sous pool_lock)
+ */
+static telnet_pool_entry_t *pool_find(const char *host, int port, const char *username) {
+    for (int i = 0; i < pool_count; i++) {
+        if (pool[i]->port == port &&
+            strcmp(pool[i]->address, host) == 0 &&
+            strcmp(pool[i]->username, username) == 0) {
+            return pool[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Recherche ou crée l'entrée du pool d'un hôte, puis la verrouille
+ *
+ * @return Pointeur vers l'entrée verrouillée, ou NULL en cas d'erreur d'allocation
+ */
+static telnet_pool_entry_t *pool_acquire(const char *host, int port, const char *username,
+                                         const char *password) {
+    pthread_mutex_lock(&pool_lock);
+    telnet_pool_entry_t *entry = pool_find(host, port, username);
+
+    if (!entry) {
+        if (pool_count >= pool_capacity) {
+            int capacity = pool_capacity ? pool_capacity * 2 : 8;
+            telnet_pool_entry_t **tmp = realloc(pool, sizeof(telnet_pool_entry_t *) * capacity);
+            if (!tmp) {
+                pthread_mutex_unlock(&pool_lock);
+                return NULL;
+            }
+            pool = tmp;
+            pool_capacity = capacity;
+        }
+
+        entry = calloc(1, sizeof(telnet_pool_entry_t));
+        if (!entry) {
+            pthread_mutex_unlock(&pool_lock);
+            return NULL;
+        }
+
+        snprintf(entry->address, sizeof(entry->address), "%s", host);
+        snprintf(entry->username, sizeof(entry->username), "%s", username);
+        entry->port = port;
+        entry->fd = -1;
+        pthread_mutex_init(&entry->lock, NULL);
+
+        pool[pool_count++] = entry;
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    pthread_mutex_lock(&entry->lock);
+    // Le mot de passe a pu changer dans la configuration
+    snprintf(entry->password, sizeof(entry->password), "%s", password ? password : "");
+    return entry;
+}
+
+static void pool_release(telnet_pool_entry_t *entry) {
+    pthread_mutex_unlock(&entry->lock);
+}
+
+/**
+ * @brief Retire les len premiers octets du texte reçu
+ */
+static void text_consume(telnet_pool_entry_t *entry, size_t len) {
+    if (!entry->text) return;
+    memmove(entry->text, entry->text + len, entry->text_len - len);
+    entry->text_len -= len;
+    entry->text[entry->text_len] = '\0';
+}
+
+/**
+ * @brief Ferme la connexion d'une entrée (sous entry->lock)
+ */
+static void pool_close(telnet_pool_entry_t *entry) {
+    if (entry->fd >= 0) {
+        close(entry->fd);
+        entry->fd = -1;
+    }
+    entry->state = TELNET_STATE_DATA;
+    text_consume(entry, entry->text_len);
+}
+
+/**
+ * @brief Échéance absolue d'une opération : celle du thread, sinon le délai par défaut
+ */
+static long long pool_deadline(void) {
+    long long deadline = network_get_deadline();
+    return (deadline > 0) ? deadline : network_now_ms() + TELNET_POOL_TIMEOUT_MS;
+}
+
+static int pool_remaining(long long deadline) {
+    long long remaining = deadline - network_now_ms();
+    return (remaining > 0) ? (int)remaining : 0;
+}
+
+/**
+ * @brief Envoie entièrement un buffer sur la connexion
+ *
+ * @return 0 en cas de succès, -1 si la connexion est fermée ou l'échéance dépassée
+ */
+static int pool_send(telnet_pool_entry_t *entry, const void *data, size_t len, long long deadline) {
+    const char *p = data;
+    while (len > 0) {
+        ssize_t n = send(entry->fd, p, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+
+            struct pollfd pfd = { .fd = entry->fd, .events = POLLOUT, .revents = 0 };
+            int remaining = pool_remaining(deadline);
+            if (remaining == 0 || poll(&pfd, 1, remaining) <= 0) return -1;
+            continue;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Ajoute un octet de texte au buffer de l'entrée
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int text_append(telnet_pool_entry_t *entry, char c) {
+    if (entry->text_len + 1 >= entry->text_capacity) {
+        size_t capacity = entry->text_capacity ? entry->text_capacity * 2 : 4096;
+        char *tmp = realloc(entry->text, capacity);
+        if (!tmp) return -1;
+        entry->text = tmp;
+        entry->text_capacity = capacity;
+    }
+    entry->text[entry->text_len++] = c;
+    entry->text[entry->text_len] = '\0';
+    return 0;
+}
+
+/**
+ * @brief Répond à une demande de négociation d'option
+ *
+ * Le client accepte l'écho et la suppression du go-ahead côté serveur
+ * et refuse toutes les autres options (terminal, taille de fenêtre...).
+ * Les refus (WONT/DONT) du serveur ne sont pas acquittés, pour ne pas
+ * boucler.
+ */
+static void telnet_negotiate(telnet_pool_entry_t *entry, unsigned char command, unsigned char option,
+                             long long deadline) {
+    unsigned char reply[3] = { TELNET_IAC, 0, option };
+
+    if (command == TELNET_DO) {
+        reply[1] = (option == TELNET_OPT_SGA) ? TELNET_WILL : TELNET_WONT;
+    } else if (command == TELNET_WILL) {
+        reply[1] = (option == TELNET_OPT_ECHO || option == TELNET_OPT_SGA) ? TELNET_DO : TELNET_DONT;
+    } else {
+        return;
+    }
+    pool_send(entry, reply, sizeof(reply), deadline);
+}
+
+/**
+ * @brief Lit les données disponibles et retire le protocole telnet
+ *
+ * Les séquences IAC sont traitées (négociation) ou ignorées
+ * (sous-négociation), les '\r' et NUL du texte sont supprimés.
+ *
+ * @return 1 si des données ont été lues, 0 si l'échéance est dépassée, -1 si la connexion est fermée
+ */
+static int pool_receive(telnet_pool_entry_t *entry, long long deadline) {
+    struct pollfd pfd = { .fd = entry->fd, .events = POLLIN, .revents = 0 };
+    int ready = poll(&pfd, 1, pool_remaining(deadline));
+    if (ready < 0) return (errno == EINTR) ? 1 : -1;
+    if (ready == 0) return 0;
+
+    unsigned char buffer[16384];
+    ssize_t n = recv(entry->fd, buffer, sizeof(buffer), 0);
+    if (n < 0) return (errno == EINTR || errno == EAGAIN) ? 1 : -1;
+    if (n == 0) return -1;
+
+    for (ssize_t i = 0; i < n; i++) {
+        unsigned char c = buffer[i];
+
+        switch (entry->state) {
+            case TELNET_STATE_DATA:
+                if (c == TELNET_IAC) {
+                    entry->state = TELNET_STATE_IAC;
+                } else if (c != '\r' && c != '\0') {
+                    if (text_append(entry, (char)c) != 0) return -1;
+                }
+                break;
+            case TELNET_STATE_IAC:
+                if (c == TELNET_IAC) {
+                    if (text_append(entry, (char)c) != 0) return -1;
+                    entry->state = TELNET_STATE_DATA;
+                } else if (c >= TELNET_WILL) {
+                    entry->command = c;
+                    entry->state = TELNET_STATE_OPTION;
+                } else if (c == TELNET_SB) {
+                    entry->state = TELNET_STATE_SB;
+                } else {
+                    entry->state = TELNET_STATE_DATA;  // NOP, GA, AYT... ignorés
+                }
+                break;
+            case TELNET_STATE_OPTION:
+                telnet_negotiate(entry, entry->command, c, deadline);
+                entry->state = TELNET_STATE_DATA;
+                break;
+            case TELNET_STATE_SB:
+                if (c == TELNET_IAC) entry->state = TELNET_STATE_SB_IAC;
+                break;
+            case TELNET_STATE_SB_IAC:
+                entry->state = (c == TELNET_SE) ? TELNET_STATE_DATA : TELNET_STATE_SB;
+                break;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Attend l'un des motifs dans le texte reçu
+ *
+ * Le texte est consommé jusqu'à la fin du motif trouvé.
+ *
+ * @param patterns Motifs recherchés
+ * @param count Nombre de motifs
+ * @return Index du motif trouvé, -1 si l'échéance est dépassée ou la connexion fermée
+ */
+static int pool_expect(telnet_pool_entry_t *entry, const char *const *patterns, int count,
+                       long long deadline) {
+    for (;;) {
+        for (int i = 0; entry->text && i < count; i++) {
+            char *found = strstr(entry->text, patterns[i]);
+            if (found) {
+                text_consume(entry, (size_t)(found - entry->text) + strlen(patterns[i]));
+                return i;
+            }
+        }
+        if (pool_receive(entry, deadline) <= 0) return -1;
+    }
+}
+
+/**
+ * @brief Ouvre la connexion TCP (non bloquante, bornée par l'échéance)
+ *
+ * @return Descripteur connecté, -1 en cas d'erreur
+ */
+static int pool_connect_socket(const char *host, int port, long long deadline) {
+    char service[16];
+    snprintf(service, sizeof(service), "%d", port);
+
+    struct addrinfo hints, *addresses = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, service, &hints, &addresses) != 0) return -1;
+
+    int fd = -1;
+    for (struct addrinfo *ai = addresses; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) continue;
+
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+
+        int error = (errno == EINPROGRESS) ? 0 : errno;
+        if (error == 0) {
+            struct pollfd pfd = { .fd = fd, .events = POLLOUT, .revents = 0 };
+            socklen_t error_len = sizeof(error);
+            if (poll(&pfd, 1, pool_remaining(deadline)) <= 0 ||
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_len) != 0) {
+                error = ETIMEDOUT;
+            }
+        }
+        if (error != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    freeaddrinfo(addresses);
+    return fd;
+}
+
+/**
+ * @brief Ouvre et authentifie la session d'une entrée du pool
+ *
+ * Répond à l'invite de login (et de mot de passe si un mot de passe est
+ * configuré), puis prépare le shell : écho du terminal coupé, invites
+ * vidées. La session est prête quand le marqueur READY revient.
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur (connexion, login refusé, délai)
+ */
+static int pool_open(telnet_pool_entry_t *entry) {
+    long long deadline = pool_deadline();
+
+    entry->fd = pool_connect_socket(entry->address, entry->port, deadline);
+    if (entry->fd < 0) {
+        network_set_error("telnet : connexion impossible");
+        return -1;
+    }
+    entry->state = TELNET_STATE_DATA;
+    text_consume(entry, entry->text_len);
+
+    static const char *const login_prompts[] = { "ogin:", "sername:" };
+    static const char *const password_prompts[] = { "assword:", "ogin incorrect" };
+    static const char *const ready_marks[] = { TELNET_READY_MARK, "ogin incorrect" };
+
+    char line[160];
+    if (pool_expect(entry, login_prompts, 2, deadline) < 0) goto fail;
+    snprintf(line, sizeof(line), "%s\r\n", entry->username);
+    if (pool_send(entry, line, strlen(line), deadline) != 0) goto fail;
+
+    if (entry->password[0]) {
+        if (pool_expect(entry, password_prompts, 2, deadline) != 0) goto fail;
+        snprintf(line, sizeof(line), "%s\r\n", entry->password);
+        if (pool_send(entry, line, strlen(line), deadline) != 0) goto fail;
+    }
+
+    static const char setup[] =
+        "stty -echo 2>/dev/null; PS1=''; PS2=''; echo \"" TELNET_MARK_PREFIX "\"\"READY__\"\r\n";
+    if (pool_send(entry, setup, sizeof(setup) - 1, deadline) != 0) goto fail;
+    if (pool_expect(entry, ready_marks, 2, deadline) != 0) goto fail;
+
+    text_consume(entry, entry->text_len);  // Fin de la ligne du marqueur
+    return 0;
+
+fail:
+    network_set_error("telnet : login refusé ou sans réponse");
+    pool_close(entry);
+    return -1;
+}
+
+/**
+ * @brief Exécute une commande sur la session ouverte d'une entrée
+ *
+ * La commande est envoyée d'un seul bloc, précédée d'un marqueur de début
+ * et suivie d'un marqueur de fin portant son code de retour. Seules les
+ * lignes entre les deux marqueurs de ce numéro sont transmises au puits ;
+ * tout reste d'une commande précédente est ignoré.
+ *
+ * @param delivered Mis à 1 dès que le marqueur de début est reçu
+ * @return Code de retour de la commande, -1 en cas d'erreur
+ */
+static int pool_run(telnet_pool_entry_t *entry, const char *command, output_sink_t sink, void *context,
+                    int *delivered) {
+    long long deadline = pool_deadline();
+    unsigned int sequence = ++entry->sequence;
+
+    // stdin redirigé : la commande ne doit pas lire les commandes suivantes
+    char *request = NULL;
+    if (asprintf(&request,
+                 "echo \"" TELNET_MARK_PREFIX "\"\"B%u__\"; { %s\n} </dev/null 2>/dev/null; "
+                 "echo \"" TELNET_MARK_PREFIX "\"\"E%u:$?__\"\r\n",
+                 sequence, command, sequence) < 0) {
+        return -1;
+    }
+    int sent = pool_send(entry, request, strlen(request), deadline);
+    free(request);
+    if (sent != 0) return -1;
+
+    char begin_mark[32], end_mark[32];
+    snprintf(begin_mark, sizeof(begin_mark), TELNET_MARK_PREFIX "B%u__", sequence);
+    snprintf(end_mark, sizeof(end_mark), TELNET_MARK_PREFIX "E%u:", sequence);
+
+    *delivered = 0;
+    for (;;) {
+        // Traiter toutes les lignes complètes reçues
+        char *line = entry->text;
+        char *newline;
+        while (line && (newline = memchr(line, '\n', entry->text_len - (size_t)(line - entry->text)))) {
+            *newline = '\0';
+            size_t len = (size_t)(newline - line);
+
+            if (!*delivered) {
+                if (strstr(line, begin_mark)) *delivered = 1;
+            } else {
+                char *end = strstr(line, end_mark);
+                if (end) {
+                    text_consume(entry, (size_t)(newline + 1 - entry->text));
+                    return atoi(end + strlen(end_mark));
+                }
+                *newline = '\n';
+                if (sink(line, len + 1, context) != 0) return -1;
+            }
+            line = newline + 1;
+        }
+        if (line) text_consume(entry, (size_t)(line - entry->text));
+
+        if (pool_receive(entry, deadline) <= 0) return -1;
+    }
+}
+
+/**
+ * @brief Exécute une commande sur la session telnet d'un hôte
+ *
+ * La session est ouverte au premier appel puis réutilisée. Si une session
+ * réutilisée a été fermée par le serveur avant le début de la sortie, elle
+ * est rouverte et la commande renvoyée une fois.
+ *
+ * @param sink Puits recevant la sortie de la commande
+ * @param context Contexte du puits
+ * @return Code de retour de la commande distante, -1 en cas d'erreur
+ */
+int telnet_pool_execute(const char *host, int port, const char *username, const char *password,
+                        const char *command, output_sink_t sink, void *context) {
+    telnet_pool_entry_t *entry = pool_acquire(host, port, username ? username : "", password);
+    if (!entry) return -1;
+
+    int result = -1;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int reused = (entry->fd >= 0);
+        if (!reused && pool_open(entry) != 0) break;
+
+        int delivered = 0;
+        result = pool_run(entry, command, sink, context, &delivered);
+        if (result >= 0) break;
+
+        // Sortie interrompue : le shell est dans un état inconnu
+        network_set_error("telnet : session interrompue");
+        pool_close(entry);
+        if (delivered || !reused) break;
+    }
+
+    pool_release(entry);
+    return result;
+}
+
+/**
+ * @brief Ouvre la session telnet d'un hôte si elle ne l'est pas déjà
+ *
+ * @return 0 si la session est prête, -1 en cas d'erreur
+ */
+int telnet_pool_connect(const char *host, int port, const char *username, const char *password) {
+    telnet_pool_entry_t *entry = pool_acquire(host, port, username ? username : "", password);
+    if (!entry) return -1;
+
+    int result = (entry->fd >= 0) ? 0 : pool_open(entry);
+    pool_release(entry);
+    return result;
+}
+
+/**
+ * @brief Ferme la session telnet d'un hôte
+ */
+void telnet_pool_disconnect(const char *host, int port, const char *username) {
+    pthread_mutex_lock(&pool_lock);
+    telnet_pool_entry_t *entry = pool_find(host, port, username ? username : "");
+    pthread_mutex_unlock(&pool_lock);
+    if (!entry) return;
+
+    pthread_mutex_lock(&entry->lock);
+    if (entry->fd >= 0) pool_send(entry, "exit\r\n", 6, network_now_ms() + 100);
+    pool_close(entry);
+    pthread_mutex_unlock(&entry->lock);
+}
+
+/**
+ * @brief Ferme toutes les sessions et libère le pool
+ */
+void telnet_pool_cleanup(void) {
+    pthread_mutex_lock(&pool_lock);
+    for (int i = 0; i < pool_count; i++) {
+        pool_close(pool[i]);
+        free(pool[i]->text);
+        pthread_mutex_destroy(&pool[i]->lock);
+        free(pool[i]);
+    }
+    free(pool);
+    pool = NULL;
+    pool_count = 0;
+    pool_capacity = 0;
+    pthread_mutex_unlock(&pool_lock);
+}
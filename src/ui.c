@@ -1,9 +1,16 @@
 #include "ui.h"
 #include <ncurses.h>
+#include <stdio.h>
 #include <string.h>
 
 int selected_index = 0;
 int scroll_offset = 0;
+static char header_text[512] = "";
+static char status_text[256] = "";
+static int extra_columns = 0;  // Colonnes UI_COLUMNS_* (ui_set_extra_columns)
+static watch_entry_t watch_entries[WATCH_MAX_PIDS];  // Processus épinglés (ui_set_watch)
+static int watch_count = 0;
+static int watch_interval_ms = 0;
 
 
 /**
@@ -26,6 +33,18 @@ void ui_draw_help() {
     mvprintw(16,0,"  -u, --username USER        Nom d'utilisateur");
     mvprintw(18,0,"  -p, --password PASS        Mot de passe");
     mvprintw(20,0,"  -a, --all                  Local + distant");
+    mvprintw(22,0,"  --agent [--interval MS]    Agent de collecte distant");
+    mvprintw(23,0,"  --publish[=NOM] / --attach[=NOM]  Instantanés en mémoire partagée");
+    mvprintw(24,0,"  --bench[=SPEC]             Benchmark sur hôtes simulés (--bench-parsers : analyseurs)");
+    mvprintw(25,0,"  --alerts FILE              Règles d'alerte (.alerts par défaut)");
+    mvprintw(26,0,"  Vue --all : c tri CPU, m tri mémoire");
+    mvprintw(27,0,"  g : vue cgroups (localhost), Entrée : processus du cgroup, g : retour");
+    mvprintw(28,0,"  --exporter [HOST:]PORT|unix:PATH  Métriques Prometheus (GET /metrics)");
+    mvprintw(29,0,"  --top-k K [--top-by cpu|mem]  Seulement les K plus gros consommateurs");
+    mvprintw(30,0,"  --schedstat                CPU en ns, attente en file d'exécution (WAIT)");
+    mvprintw(31,0,"  w : épingler le processus sélectionné (local, suivi toutes les 50 ms, --watch-interval MS)");
+    mvprintw(32,0,"  --filter EXPR              Ex. 'user=www and cpu>1' (voir header/filter.h)");
+    mvprintw(33,0,"  --sockets                  Sockets TCP (établies, en écoute, CLOSE_WAIT) et UDP par processus");
 }
 
 
@@ -79,8 +98,168 @@ void ui_cleanup() {
 */
 void ui_draw_header() {
     attron(A_REVERSE);
-    mvprintw(0, 0, " Localhost | F1 Help | F2 Next Machine | F3 Previous Machine | F4 Search | F5 Pause | F6 Stop | F7 Kill | F8 Restart | Q Quit ");
+    if (header_text[0] != '\0') {
+        mvprintw(0, 0, "%-*.*s", COLS, COLS, header_text);
+    } else {
+        mvprintw(0, 0, " Localhost | F1 Help | F2 Next Machine | F3 Previous Machine | F4 Search | F5 Pause | F6 Stop | F7 Kill | F8 Restart | Q Quit ");
+    }
     attroff(A_REVERSE);
+
+    if (status_text[0] != '\0') {
+        mvprintw(1, 0, "%.*s", COLS, status_text);
+    }
+}
+
+/**
+* @brief Définit le texte de l'en-tête (nom de l'hôte, état...)
+*
+* Le texte est affiché par ui_draw_header() à chaque rafraîchissement,
+* à la place de l'en-tête par défaut.
+*
+* @param text Texte de l'en-tête, ou NULL pour revenir à l'en-tête par défaut
+*/
+void ui_set_header(const char *text) {
+    snprintf(header_text, sizeof(header_text), "%s", text ? text : "");
+}
+
+/**
+* @brief Définit la ligne d'état (résultat de la dernière action...)
+*
+* Affichée sous l'en-tête par ui_draw_header().
+*
+* @param text Texte de la ligne d'état, ou NULL pour l'effacer
+*/
+void ui_set_status(const char *text) {
+    snprintf(status_text, sizeof(status_text), "%s", text ? text : "");
+}
+
+/**
+* @brief Choisit les colonnes ajoutées par ui_draw_processes()
+*
+* Seule la collecte locale remplit les taux de défauts de page et de
+* changements de contexte, seulement en mode schedstat l'attente en
+* file d'exécution et les passages sur un CPU, et seulement avec --sockets
+* le nombre de sockets.
+*
+* @param columns Combinaison de UI_COLUMNS_RATES, UI_COLUMNS_SCHED et UI_COLUMNS_SOCKETS (0 : aucune)
+*/
+void ui_set_extra_columns(int columns) {
+    extra_columns = columns;
+}
+
+/**
+* @brief Transmet les processus épinglés affichés sous la liste (touche w)
+*
+* @param entries Processus suivis (copiés)
+* @param count Nombre de processus, 0 pour masquer le panneau
+* @param interval_ms Intervalle d'échantillonnage du suivi
+*/
+void ui_set_watch(const watch_entry_t *entries, int count, int interval_ms) {
+    if (count > WATCH_MAX_PIDS) count = WATCH_MAX_PIDS;
+    if (count > 0) memcpy(watch_entries, entries, sizeof(watch_entry_t) * count);
+    watch_count = count > 0 ? count : 0;
+    watch_interval_ms = interval_ms;
+}
+
+/**
+* @brief Lignes réservées au panneau de suivi (titre et un processus par ligne)
+*/
+static int ui_watch_lines(void) {
+    return watch_count > 0 ? watch_count + 1 : 0;
+}
+
+/**
+* @brief Corrige la sélection et le défilement pour une liste de count lignes
+*
+* @param count Nombre de lignes de la liste
+* @param start Pointeur qui recevra l'index de la première ligne visible
+* @param end Pointeur qui recevra l'index suivant la dernière ligne visible
+* @return 0 si la liste peut être affichée, -1 si l'écran est trop petit
+*/
+static int ui_visible_range(int count, int *start, int *end) {
+    // Le panneau de suivi se place au-dessus de la dernière ligne (RAM, défilement)
+    int screen_height = LINES - 4 - (watch_count > 0 ? ui_watch_lines() + 1 : 0);
+    if (screen_height <= 0) return -1;
+
+    // Corriger selected_index
+    if (count > 0) {
+        if (selected_index >= count) selected_index = count - 1;
+        if (selected_index < 0) selected_index = 0;
+    }
+
+    // Ajuster le scroll
+    if (selected_index < scroll_offset) {
+        scroll_offset = selected_index;
+    } else if (selected_index >= scroll_offset + screen_height) {
+        scroll_offset = selected_index - screen_height + 1;
+    }
+
+    *start = scroll_offset;
+    *end = scroll_offset + screen_height;
+    if (*end > count) *end = count;
+    return 0;
+}
+
+/**
+* @brief Affiche les indicateurs de défilement en bas de l'écran
+*/
+static void ui_draw_scroll_indicators(int count, int end) {
+    if (scroll_offset > 0) {
+        mvprintw(LINES - 1, 0, "↑ %d+", scroll_offset);
+    } else if (end < count) {
+        mvprintw(LINES - 1, 0, "%d+ ↓", count - end);
+    }
+}
+
+/**
+* @brief Affiche le panneau des processus épinglés au-dessus de la dernière ligne
+*
+* Une ligne par processus : CPU%, attente en file d'exécution (si schedstat
+* est disponible), mémoire résidente, puis un mini-graphique du CPU% des
+* derniers échantillons, le plus récent à droite. Un processus terminé
+* reste affiché quelques secondes avec son graphique figé.
+*/
+static void ui_draw_watch(void) {
+    static const char levels[] = " .:-=+*#%@";
+    if (watch_count == 0) return;
+
+    int line = LINES - 1 - ui_watch_lines();
+    if (line < 4) return;
+
+    char title[128];
+    snprintf(title, sizeof(title), "-- Suivi : %d épinglé(s), un échantillon toutes les %d ms (w : retirer) --",
+             watch_count, watch_interval_ms);
+    attron(A_BOLD);
+    mvprintw(line++, 0, "%.*s", COLS, title);
+    attroff(A_BOLD);
+
+    for (int i = 0; i < watch_count; i++, line++) {
+        const watch_entry_t *entry = &watch_entries[i];
+        char text[128];
+        int used;
+        if (entry->exited) {
+            used = snprintf(text, sizeof(text), "%-7d %-15.15s terminé                               ",
+                            entry->pid, entry->name);
+        } else if (entry->wait_percent >= 0) {
+            used = snprintf(text, sizeof(text), "%-7d %-15.15s %c CPU %5.1f%%  WAIT %5.1f%%  RSS %8d Ko  ",
+                            entry->pid, entry->name, entry->state, entry->cpu_percent,
+                            entry->wait_percent, entry->memory_kb);
+        } else {
+            used = snprintf(text, sizeof(text), "%-7d %-15.15s %c CPU %5.1f%%  WAIT     -   RSS %8d Ko  ",
+                            entry->pid, entry->name, entry->state, entry->cpu_percent, entry->memory_kb);
+        }
+        mvprintw(line, 0, "%.*s", COLS, text);
+
+        // Mini-graphique : autant d'échantillons que la largeur restante le permet
+        int width = COLS - used - 1;
+        if (width > entry->history_count) width = entry->history_count;
+        for (int k = width; k > 0; k--) {
+            float cpu = entry->history[(entry->history_next - k + WATCH_HISTORY) % WATCH_HISTORY];
+            int level = cpu <= 0 ? 0 : 1 + (int)(cpu * 8.999 / 100.0);
+            if (level > 9) level = 9;
+            addch(levels[level]);
+        }
+    }
 }
 
 /**
@@ -130,29 +309,22 @@ void ui_draw_processes(process_info_t *list, int count) {
 
     long total_memory_kb = get_total_memory_kb();
 
-    mvprintw(2, 0, "PID     NAME                CPU(percent)   MEM(percent)    TIME(s)");
-    mvprintw(3, 0, "------------------------------------------------------");
-
-    int screen_height = LINES - 4;
-    if (screen_height <= 0) return;
-
-    // Corriger selected_index
-    if (count > 0) {
-        if (selected_index >= count) selected_index = count - 1;
-        if (selected_index < 0) selected_index = 0;
-    }
-
-    // Ajuster le scroll
-    if (selected_index < scroll_offset) {
-        scroll_offset = selected_index;
-    } else if (selected_index >= scroll_offset + screen_height) {
-        scroll_offset = selected_index - screen_height + 1;
-    }
+    // Taux locaux, puis attente en file d'exécution et passages sur un CPU (mode schedstat)
+    int rates = extra_columns & UI_COLUMNS_RATES;
+    int sched = extra_columns & UI_COLUMNS_SCHED;
+    int sockets = extra_columns & UI_COLUMNS_SOCKETS;
+    mvprintw(2, 0, "PID     NAME                CPU(percent)   MEM(percent)    TIME(s)%s%s%s",
+             rates ? "  MINFLT/s MAJFLT/s   VCSW/s  IVCSW/s" : "",
+             sched ? "  WAIT(percent) SLICES/s" : "",
+             sockets ? "     TCP   ESTAB  LISTEN  CLOSEW     UDP" : "");
+    mvprintw(3, 0, "------------------------------------------------------%s%s%s",
+             rates ? "------------------------------------" : "",
+             sched ? "------------------------" : "",
+             sockets ? "----------------------------------------" : "");
 
     // Afficher les processus visibles
-    int start = scroll_offset;
-    int end = scroll_offset + screen_height;
-    if (end > count) end = count;
+    int start, end;
+    if (ui_visible_range(count, &start, &end) != 0) return;
 
     for (int i = start; i < end; i++) {
         int screen_line = 4 + (i - scroll_offset);
@@ -171,6 +343,22 @@ void ui_draw_processes(process_info_t *list, int count) {
                 list[i].cpu_percent,
                 memory_percent,   // %.2f pour 2 décimales (mémoire change peu)
                 list[i].time);
+        if (rates) {
+            printw("  %8.0f %8.0f %8.0f %8.0f", list[i].minflt_per_s, list[i].majflt_per_s,
+                   list[i].voluntary_switches_per_s, list[i].nonvoluntary_switches_per_s);
+        }
+        if (sched) {
+            printw("  %6.1f%% %9.0f", list[i].wait_percent, list[i].slices_per_s);
+        }
+        if (sockets) {
+            // -1 : descripteurs d'un autre utilisateur, ou pas encore lus
+            int counts[5] = { list[i].tcp_sockets, list[i].tcp_established, list[i].tcp_listen,
+                              list[i].tcp_close_wait, list[i].udp_sockets };
+            for (int c = 0; c < 5; c++) {
+                if (counts[c] < 0) printw("       -");
+                else printw("  %6d", counts[c]);
+            }
+        }
 
         if (i == selected_index) attroff(A_REVERSE);
     }
@@ -182,12 +370,100 @@ void ui_draw_processes(process_info_t *list, int count) {
     }
 
     // Indicateurs de scroll
-    if (scroll_offset > 0) {
-        mvprintw(LINES - 1, 0, "↑ %d+", scroll_offset);
-    } else if (end < count) {
-        mvprintw(LINES - 1, 0, "%d+ ↓", count - end);
+    ui_draw_scroll_indicators(count, end);
+    ui_draw_watch();
+
+    refresh();
+}
+
+/**
+ * @brief Affiche la vue fusionnée de tous les hôtes (option --all)
+ *
+ * Comme ui_draw_processes(), avec une colonne HOST. La mémoire est affichée
+ * en Mo : un pourcentage n'aurait pas de sens entre machines différentes.
+ *
+ * @param rows Lignes de la flotte, déjà triées
+ * @param count Nombre de lignes
+ * @param hosts Configurations des hôtes (pour leur nom)
+ */
+void ui_draw_fleet(const fleet_row_t *rows, int count, const host_config_t *hosts) {
+    erase();
+    ui_draw_header();
+
+    mvprintw(2, 0, "HOST             PID     NAME                CPU(percent)   MEM(MB)    TIME(s)");
+    mvprintw(3, 0, "--------------------------------------------------------------------------");
+
+    int start, end;
+    if (ui_visible_range(count, &start, &end) != 0) return;
+
+    for (int i = start; i < end; i++) {
+        int screen_line = 4 + (i - scroll_offset);
+
+        if (i == selected_index) attron(A_REVERSE);
+
+        mvprintw(screen_line, 0, "%-16.16s %-7d %-18s %6.1f%% %10.1f %8.1f",
+                hosts[rows[i].host].name,
+                rows[i].proc.pid,
+                rows[i].proc.name,
+                rows[i].proc.cpu_percent,
+                rows[i].proc.memory_kb / 1024.0,
+                rows[i].proc.time);
+
+        if (i == selected_index) attroff(A_REVERSE);
+    }
+
+    ui_draw_scroll_indicators(count, end);
+    ui_draw_watch();
+
+    refresh();
+}
+
+/**
+ * @brief Affiche la vue par cgroup (touche g)
+ *
+ * Un cgroup par ligne, indenté selon sa profondeur, avec ses totaux lus
+ * dans /sys/fs/cgroup : CPU et part bridée, mémoire comptée par le noyau
+ * (anonyme et cache de pages), débits disque et nombre de processus.
+ *
+ * @param list Cgroups, dans l'ordre du parcours (parent avant enfants)
+ * @param count Nombre de cgroups
+ */
+void ui_draw_cgroups(const cgroup_info_t *list, int count) {
+    erase();
+    ui_draw_header();
+
+    mvprintw(2, 0, "CGROUP                                   PROCS   CPU(%%)  THR(%%)  MEM(MB) ANON(MB) FILE(MB)  READ(KB/s) WRITE(KB/s)");
+    mvprintw(3, 0, "-------------------------------------------------------------------------------------------------------------------");
+
+    int start, end;
+    if (ui_visible_range(count, &start, &end) != 0) return;
+
+    for (int i = start; i < end; i++) {
+        int screen_line = 4 + (i - scroll_offset);
+
+        // Nom court indenté sous son parent, chemin complet pour la racine
+        const char *name = strrchr(list[i].path, '/');
+        name = (name && name[1]) ? name + 1 : list[i].path;
+        int indent = 2 * (list[i].depth > 8 ? 8 : list[i].depth);
+
+        if (i == selected_index) attron(A_REVERSE);
+
+        mvprintw(screen_line, 0, "%*s%-*.*s %5d %7.1f %7.1f %8.1f %8.1f %8.1f %11.1f %11.1f",
+                indent, "", 40 - indent, 40 - indent, name,
+                list[i].process_count,
+                list[i].cpu_percent,
+                list[i].throttled_percent,
+                list[i].memory_kb / 1024.0,
+                list[i].anon_kb / 1024.0,
+                list[i].file_kb / 1024.0,
+                list[i].io_read_kbps,
+                list[i].io_write_kbps);
+
+        if (i == selected_index) attroff(A_REVERSE);
     }
 
+    ui_draw_scroll_indicators(count, end);
+
     refresh();
 }
 
@@ -229,6 +505,13 @@ ui_action_t ui_get_action() {
         case 's': return UI_ACTION_RESUME;
         case 'h': return UI_ACTION_HELP;
         case 'f': return UI_ACTION_SEARCH;
+        case 'c': return UI_ACTION_SORT_CPU;
+        case 'm': return UI_ACTION_SORT_MEM;
+        case 'g': return UI_ACTION_CGROUPS;
+        case 'w': return UI_ACTION_WATCH;
+
+        case '\n':
+        case KEY_ENTER: return UI_ACTION_SELECT;
 
         case 'q':
         case 'Q': return UI_ACTION_QUIT;
@@ -260,6 +543,14 @@ int ui_get_selected_index() {
     return selected_index;
 }
 
+/**
+ * @brief Remet la sélection et le défilement en haut de la liste (changement de vue)
+ */
+void ui_reset_selection() {
+    selected_index = 0;
+    scroll_offset = 0;
+}
+
 /**
  * @brief Affiche un prompt de recherche et récupère l'entrée utilisateur.
  *
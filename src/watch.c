@@ -0,0 +1,370 @@
+#define _GNU_SOURCE
+#include "watch.h"
+#include "proc_parse.h"
+#include "network.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+/**
+ * @brief Horloge monotone en microsecondes, base des taux
+ */
+static long long watch_now_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/**
+ * @brief Ouvre un pidfd sur un processus
+ *
+ * @return Le descripteur, -1 si le processus n'existe pas ou si le noyau
+ *         (ou la glibc) ne connaît pas pidfd_open
+ */
+static int watch_pidfd_open(int pid) {
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/**
+ * @brief Lit un fichier de /proc en une seule lecture (terminé par '\0')
+ *
+ * @return Nombre d'octets lus, -1 en cas d'erreur
+ */
+static int watch_read_file(const char *path, char *buffer, size_t size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    ssize_t n = read(fd, buffer, size - 1);
+    close(fd);
+    if (n <= 0) return -1;
+    buffer[n] = '\0';
+    return (int)n;
+}
+
+static int watch_read_stat(int pid, proc_stat_t *stat) {
+    char path[64];
+    char buffer[1024];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    int len = watch_read_file(path, buffer, sizeof(buffer));
+    if (len < 0) return -1;
+    return proc_parse_stat(buffer, (size_t)len, stat);
+}
+
+/**
+ * @brief Temps sur un CPU et en file d'attente, sommés sur les threads
+ *
+ * @param threads Nombre de threads (champ 20 de stat) : un seul fichier à lire s'il vaut 1
+ * @return 0 en cas de succès, -1 si schedstat est indisponible
+ */
+static int watch_read_schedstat(int pid, int threads, proc_schedstat_t *sched) {
+    char path[96];
+    char buffer[128];
+
+    if (threads <= 1) {
+        snprintf(path, sizeof(path), "/proc/%d/schedstat", pid);
+        int len = watch_read_file(path, buffer, sizeof(buffer));
+        if (len < 0) return -1;
+        return proc_parse_schedstat(buffer, (size_t)len, sched);
+    }
+
+    snprintf(path, sizeof(path), "/proc/%d/task", pid);
+    DIR *task_directory = opendir(path);
+    if (!task_directory) return -1;
+
+    memset(sched, 0, sizeof(proc_schedstat_t));
+    int found = 0;
+    struct dirent *entry;
+    while ((entry = readdir(task_directory)) != NULL) {
+        if (!isdigit((unsigned char)entry->d_name[0])) continue;
+        snprintf(path, sizeof(path), "/proc/%d/task/%.16s/schedstat", pid, entry->d_name);
+        proc_schedstat_t thread;
+        int len = watch_read_file(path, buffer, sizeof(buffer));
+        if (len < 0 || proc_parse_schedstat(buffer, (size_t)len, &thread) != 0) continue;
+        sched->run_ns += thread.run_ns;
+        sched->wait_ns += thread.wait_ns;
+        found++;
+    }
+    closedir(task_directory);
+    return found > 0 ? 0 : -1;
+}
+
+/**
+ * @brief Marque un processus suivi comme terminé (sous watch->lock)
+ */
+static void watch_mark_exited(watch_t *watch, watch_entry_t *entry) {
+    if (entry->exited) return;
+    entry->exited = 1;
+    entry->exit_ms = network_now_ms();
+    entry->state = 'X';
+    entry->cpu_percent = 0;
+    entry->wait_percent = entry->wait_percent < 0 ? -1 : 0;
+    if (entry->pidfd >= 0) {
+        close(entry->pidfd);
+        entry->pidfd = -1;
+    }
+    snprintf(watch->exit_message, sizeof(watch->exit_message), " Suivi : %.200s (%d) terminé",
+             entry->name, entry->pid);
+    watch->exit_id++;
+}
+
+/**
+ * @brief Échantillonne un processus suivi (sous watch->lock)
+ *
+ * Le CPU% vient des nanosecondes de schedstat rapportées au temps écoulé
+ * depuis l'échantillon précédent : à 50 ms d'intervalle, les ticks de
+ * 10 ms de stat ne donneraient que quelques valeurs possibles. Les ticks
+ * ne servent qu'à défaut de schedstat.
+ */
+static void watch_sample(watch_t *watch, watch_entry_t *entry) {
+    proc_stat_t stat;
+    if (watch_read_stat(entry->pid, &stat) != 0 || stat.starttime != entry->starttime || stat.state == 'Z') {
+        // Processus terminé (zombie, disparu ou PID réutilisé) sans notification du pidfd
+        watch_mark_exited(watch, entry);
+        return;
+    }
+
+    long long now_us = watch_now_us();
+    unsigned long long ticks = stat.utime + stat.stime;
+    proc_schedstat_t sched;
+    int has_sched = watch_read_schedstat(entry->pid, stat.num_threads, &sched) == 0;
+
+    entry->state = stat.state;
+    entry->threads = stat.num_threads;
+    entry->memory_kb = (int)(stat.rss_pages * (unsigned long long)sysconf(_SC_PAGESIZE) / 1024);
+
+    if (entry->has_last && now_us > entry->last_sample_us) {
+        double elapsed_us = (double)(now_us - entry->last_sample_us);
+        float cpu;
+        if (has_sched && sched.run_ns >= entry->last_run_ns && sched.wait_ns >= entry->last_wait_ns) {
+            cpu = (sched.run_ns - entry->last_run_ns) / (elapsed_us * 10.0);
+            entry->wait_percent = (sched.wait_ns - entry->last_wait_ns) / (elapsed_us * 10.0);
+        } else {
+            long ticks_per_second = sysconf(_SC_CLK_TCK);
+            cpu = ticks >= entry->last_ticks
+                ? (ticks - entry->last_ticks) * 1e8 / ((double)ticks_per_second * elapsed_us) : 0;
+            entry->wait_percent = -1;
+        }
+        if (cpu > 100.0) cpu = 100.0;
+        entry->cpu_percent = cpu;
+
+        entry->history[entry->history_next] = cpu;
+        entry->history_next = (entry->history_next + 1) % WATCH_HISTORY;
+        if (entry->history_count < WATCH_HISTORY) entry->history_count++;
+    }
+
+    if (has_sched) {
+        entry->last_run_ns = sched.run_ns;
+        entry->last_wait_ns = sched.wait_ns;
+    }
+    entry->last_ticks = ticks;
+    entry->last_sample_us = now_us;
+    entry->has_last = 1;
+}
+
+/**
+ * @brief Retire les processus terminés depuis plus de WATCH_EXITED_KEEP_MS (sous watch->lock)
+ */
+static void watch_expire(watch_t *watch, long long now_ms) {
+    int kept = 0;
+    for (int i = 0; i < watch->count; i++) {
+        watch_entry_t *entry = &watch->entries[i];
+        if (entry->exited && now_ms - entry->exit_ms >= WATCH_EXITED_KEEP_MS) continue;
+        if (kept != i) watch->entries[kept] = *entry;
+        kept++;
+    }
+    watch->count = kept;
+}
+
+/**
+ * @brief Thread de suivi
+ *
+ * Attend sur les pidfd des processus vivants et sur le tube de réveil, au
+ * plus jusqu'à l'échantillon suivant : un pidfd lisible signale la fin de
+ * son processus. Les échéances sont fixes (pas de dérive avec la durée de
+ * lecture) ; un échantillon manqué n'est pas rattrapé.
+ */
+static void *watch_thread(void *arg) {
+    watch_t *watch = arg;
+    struct pollfd fds[WATCH_MAX_PIDS + 1];
+    int watched_pids[WATCH_MAX_PIDS + 1];
+    long long next_sample_us = watch_now_us();
+
+    for (;;) {
+        int nfds = 0;
+        fds[nfds].fd = watch->wake_pipe[0];
+        fds[nfds].events = POLLIN;
+        watched_pids[nfds++] = 0;
+
+        pthread_mutex_lock(&watch->lock);
+        if (!watch->running) {
+            pthread_mutex_unlock(&watch->lock);
+            break;
+        }
+        for (int i = 0; i < watch->count; i++) {
+            if (watch->entries[i].exited || watch->entries[i].pidfd < 0) continue;
+            fds[nfds].fd = watch->entries[i].pidfd;
+            fds[nfds].events = POLLIN;
+            watched_pids[nfds++] = watch->entries[i].pid;
+        }
+        long long interval_us = watch->interval_ms * 1000LL;
+        pthread_mutex_unlock(&watch->lock);
+
+        long long wait_us = next_sample_us - watch_now_us();
+        int timeout = wait_us > 0 ? (int)((wait_us + 999) / 1000) : 0;
+        if (poll(fds, nfds, timeout) < 0 && errno != EINTR) break;
+
+        if (fds[0].revents) {
+            char drain[64];
+            while (read(watch->wake_pipe[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+
+        pthread_mutex_lock(&watch->lock);
+        for (int f = 1; f < nfds; f++) {
+            if (!(fds[f].revents & POLLIN)) continue;
+            for (int i = 0; i < watch->count; i++) {
+                watch_entry_t *entry = &watch->entries[i];
+                if (entry->pid == watched_pids[f] && entry->pidfd == fds[f].fd) watch_mark_exited(watch, entry);
+            }
+        }
+
+        long long now_us = watch_now_us();
+        if (now_us >= next_sample_us) {
+            for (int i = 0; i < watch->count; i++) {
+                if (!watch->entries[i].exited) watch_sample(watch, &watch->entries[i]);
+            }
+            next_sample_us += interval_us;
+            if (next_sample_us <= now_us) next_sample_us = now_us + interval_us;
+        }
+        watch_expire(watch, network_now_ms());
+        pthread_mutex_unlock(&watch->lock);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Réveille le thread de suivi (liste des pidfd changée, arrêt)
+ */
+static void watch_wake(watch_t *watch) {
+    if (write(watch->wake_pipe[1], "", 1) != 1) {
+        // Tube plein : le thread est déjà réveillé
+    }
+}
+
+int watch_start(watch_t *watch, int interval_ms) {
+    memset(watch, 0, sizeof(watch_t));
+    if (interval_ms < WATCH_MIN_INTERVAL_MS) interval_ms = WATCH_MIN_INTERVAL_MS;
+    if (interval_ms > WATCH_MAX_INTERVAL_MS) interval_ms = WATCH_MAX_INTERVAL_MS;
+    watch->interval_ms = interval_ms;
+    watch->running = 1;
+
+    if (pipe2(watch->wake_pipe, O_CLOEXEC | O_NONBLOCK) != 0) return -1;
+    pthread_mutex_init(&watch->lock, NULL);
+    if (pthread_create(&watch->thread, NULL, watch_thread, watch) != 0) {
+        pthread_mutex_destroy(&watch->lock);
+        close(watch->wake_pipe[0]);
+        close(watch->wake_pipe[1]);
+        return -1;
+    }
+    return 0;
+}
+
+void watch_stop(watch_t *watch) {
+    pthread_mutex_lock(&watch->lock);
+    watch->running = 0;
+    pthread_mutex_unlock(&watch->lock);
+    watch_wake(watch);
+    pthread_join(watch->thread, NULL);
+
+    for (int i = 0; i < watch->count; i++) {
+        if (watch->entries[i].pidfd >= 0) close(watch->entries[i].pidfd);
+    }
+    watch->count = 0;
+    pthread_mutex_destroy(&watch->lock);
+    close(watch->wake_pipe[0]);
+    close(watch->wake_pipe[1]);
+}
+
+/**
+ * @brief Épingle ou retire un PID
+ *
+ * Le pidfd (toujours fermé à l'exec) est ouvert avant la lecture de stat :
+ * si le PID est réutilisé entre les deux, la date de démarrage lue est celle
+ * du nouveau processus, que le pidfd désigne déjà.
+ */
+int watch_toggle(watch_t *watch, int pid) {
+    if (pid <= 0) return -1;
+
+    pthread_mutex_lock(&watch->lock);
+    for (int i = 0; i < watch->count; i++) {
+        if (watch->entries[i].pid != pid) continue;
+        if (watch->entries[i].pidfd >= 0) close(watch->entries[i].pidfd);
+        watch->entries[i] = watch->entries[--watch->count];
+        pthread_mutex_unlock(&watch->lock);
+        watch_wake(watch);
+        return 0;
+    }
+    int full = watch->count >= WATCH_MAX_PIDS;
+    pthread_mutex_unlock(&watch->lock);
+    if (full) return -1;
+
+    int pidfd = watch_pidfd_open(pid);
+    if (pidfd < 0 && errno != ENOSYS) return -1;  // ESRCH : processus déjà terminé
+    proc_stat_t stat;
+    if (watch_read_stat(pid, &stat) != 0) {
+        if (pidfd >= 0) close(pidfd);
+        return -1;
+    }
+
+    pthread_mutex_lock(&watch->lock);
+    if (watch->count >= WATCH_MAX_PIDS) {
+        pthread_mutex_unlock(&watch->lock);
+        if (pidfd >= 0) close(pidfd);
+        return -1;
+    }
+    watch_entry_t *entry = &watch->entries[watch->count++];
+    memset(entry, 0, sizeof(watch_entry_t));
+    entry->pid = pid;
+    entry->pidfd = pidfd;
+    entry->starttime = stat.starttime;
+    snprintf(entry->name, sizeof(entry->name), "%s", stat.name);
+    entry->wait_percent = -1;
+    watch_sample(watch, entry);  // Base des premiers taux
+    pthread_mutex_unlock(&watch->lock);
+
+    watch_wake(watch);
+    return 1;
+}
+
+int watch_snapshot(watch_t *watch, watch_entry_t *entries, int max) {
+    pthread_mutex_lock(&watch->lock);
+    int count = watch->count < max ? watch->count : max;
+    memcpy(entries, watch->entries, sizeof(watch_entry_t) * count);
+    pthread_mutex_unlock(&watch->lock);
+    return count;
+}
+
+int watch_poll_exit(watch_t *watch, unsigned long *seen, char *buffer, size_t size) {
+    pthread_mutex_lock(&watch->lock);
+    int fresh = watch->exit_id != *seen;
+    if (fresh) {
+        snprintf(buffer, size, "%s", watch->exit_message);
+        *seen = watch->exit_id;
+    }
+    pthread_mutex_unlock(&watch->lock);
+    return fresh;
+}